@@ -0,0 +1,721 @@
+#include "tinyOS.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern void vTaskSystemTickHandler(void);
+
+/****************** 宏/变量定义 ****************************/
+
+// 内核微基准测试：替代tApp.c作为应用，依次测量各个内核原语的开销，
+// 结果以"名称 数值"的形式写入文件，并与已提交的基线比较，超出容差即返回非0
+
+#define BENCH_ITERATIONS          100000                 // 每项测试的迭代次数
+#define BENCH_WORKER_MAX          20                     // 同时存在的测试任务数量上限
+#define BENCH_STACK_SIZE          256
+#define BENCH_DRIVER_PRIO         0                      // 驱动任务优先级最高，测试任务均低于它
+#define BENCH_MBOX_SIZE           16
+#define BENCH_RESULT_MAX          32
+#define BENCH_TOLERANCE           30                     // 默认允许的回退百分比
+#define BENCH_CREATE_STACK_SIZE   2048                   // 创建任务测试使用的堆栈(字)，8KB
+
+typedef struct {
+	const char * pcName;
+	double dValue;                                       // 每次操作的纳秒数
+}BenchResult_t;
+
+static Task_t xDriverTask;
+static TaskStack_t xDriverStack[BENCH_STACK_SIZE];
+static Task_t xWorkerTask[BENCH_WORKER_MAX];
+static TaskStack_t xWorkerStack[BENCH_WORKER_MAX][BENCH_STACK_SIZE];
+
+static TaskStack_t xCreateStack[BENCH_CREATE_STACK_SIZE];
+
+static BenchResult_t xResult[BENCH_RESULT_MAX];
+static uint32_t uiResultCnt;
+
+// 测试任务完成后通知驱动任务
+static Sem_t xDoneSem;
+
+// 各项测试共用的同步对象
+static Sem_t xSem1, xSem2;
+static Mbox_t xMbox;
+static void * pvMboxBuf[BENCH_MBOX_SIZE];
+static Mutex_t xMutex;
+static MemBlock_t xMemBlock;
+static uint8_t ucMemBuf[4][64];
+static uint8_t * pcSharedBlock;
+static FlagGroup_t xFlagGroup;
+static uint32_t uiFlagWaiters;
+
+static struct timespec xStartTime;
+static double dElapsedNs;
+
+static void prvBenchDriverEntry (void * pvParam);
+
+/*------------------------------------------------------- 计时 --------------------------------------------------------*/
+
+static void prvBenchStart (void)
+{
+	clock_gettime(CLOCK_MONOTONIC, &xStartTime);
+}
+
+static void prvBenchStop (void)
+{
+	struct timespec xNow;
+	clock_gettime(CLOCK_MONOTONIC, &xNow);
+	dElapsedNs = (xNow.tv_sec - xStartTime.tv_sec) * 1e9 + (xNow.tv_nsec - xStartTime.tv_nsec);
+}
+
+// 测试任务结束：通知驱动任务后挂起自己，由驱动任务删除
+static void prvBenchFinish (void)
+{
+	vSemNotify(&xDoneSem);
+	vTaskSuspend(pxCurrentTask);
+}
+
+/*------------------------------------------------------- 测试任务 --------------------------------------------------------*/
+
+// 任务切换：高优先级任务挂起自己，低优先级任务将其唤醒，每次迭代两次切换
+static void prvSwitchHighEntry (void * pvParam)
+{
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		vTaskSuspend(pxCurrentTask);
+	}
+	prvBenchStop();
+	dElapsedNs /= 2;
+	prvBenchFinish();
+}
+
+static void prvSwitchLowEntry (void * pvParam)
+{
+	Task_t * pxHigh = (Task_t *)pvParam;
+	for(;;)
+	{
+		vTaskWakeUp(pxHigh);
+	}
+}
+
+// 信号量乒乓：一次往返包含两次wait/notify
+static void prvSemPongEntry (void * pvParam)
+{
+	uint32_t i;
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		uiSemWait(&xSem1, 0);
+		vSemNotify(&xSem2);
+	}
+	vTaskSuspend(pxCurrentTask);
+}
+
+static void prvSemPingEntry (void * pvParam)
+{
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		vSemNotify(&xSem1);
+		uiSemWait(&xSem2, 0);
+	}
+	prvBenchStop();
+	prvBenchFinish();
+}
+
+// 邮箱吞吐：生产者每次写满邮箱后挂起，消费者取完后将其唤醒
+static void prvMboxProducerEntry (void * pvParam)
+{
+	uint32_t i, j;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS / BENCH_MBOX_SIZE; i++)
+	{
+		for(j = 0; j < BENCH_MBOX_SIZE; j++)
+		{
+			uiMboxNotify(&xMbox, (void *)(uintptr_t)j, MBOXSENDNORMAL);
+		}
+		vTaskSuspend(pxCurrentTask);
+	}
+	prvBenchStop();
+	dElapsedNs /= (BENCH_ITERATIONS / BENCH_MBOX_SIZE) * BENCH_MBOX_SIZE;
+	dElapsedNs *= BENCH_ITERATIONS;
+	prvBenchFinish();
+}
+
+static void prvMboxConsumerEntry (void * pvParam)
+{
+	Task_t * pxProducer = (Task_t *)pvParam;
+	void * pvMsg;
+	uint32_t j;
+
+	for(;;)
+	{
+		for(j = 0; j < BENCH_MBOX_SIZE; j++)
+		{
+			uiMboxWait(&xMbox, &pvMsg, 0);
+		}
+		vTaskWakeUp(pxProducer);
+	}
+}
+
+// 互斥量，无竞争的加锁/解锁
+static void prvMutexLockEntry (void * pvParam)
+{
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		uiMutexWait(&xMutex, 0);
+		uiMutexNotify(&xMutex);
+	}
+	prvBenchStop();
+	prvBenchFinish();
+}
+
+// 互斥量移交，发生优先级继承：低优先级任务持有时，高优先级任务请求
+static void prvMutexPiHighEntry (void * pvParam)
+{
+	for(;;)
+	{
+		uiMutexWait(&xMutex, 0);
+		uiMutexNotify(&xMutex);
+		vTaskSuspend(pxCurrentTask);
+	}
+}
+
+static void prvMutexPiLowEntry (void * pvParam)
+{
+	Task_t * pxHigh = (Task_t *)pvParam;
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		uiMutexWait(&xMutex, 0);
+		vTaskWakeUp(pxHigh);             // 高优先级任务请求互斥量而阻塞，本任务被提升
+		uiMutexNotify(&xMutex);          // 移交给高优先级任务，恢复原优先级
+	}
+	prvBenchStop();
+	prvBenchFinish();
+}
+
+// 天花板互斥量：与mutex_handoff_pi相同的场景，低优先级任务加锁时已提升到天花板，唤醒高优先级任务不会被抢占，
+// 解锁后才切换过去，高优先级任务加锁时没有竞争
+static void prvMutexCeilingLowEntry (void * pvParam)
+{
+	Task_t * pxHigh = (Task_t *)pvParam;
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		uiMutexWait(&xMutex, 0);
+		vTaskWakeUp(pxHigh);
+		uiMutexNotify(&xMutex);          // 恢复原优先级，切换到高优先级任务
+	}
+	prvBenchStop();
+	prvBenchFinish();
+}
+
+// 互斥量移交，不发生优先级继承：等待者优先级低于拥有者，由最低优先级的任务唤醒拥有者
+static void prvMutexNoPiOwnerEntry (void * pvParam)
+{
+	Task_t * pxWaiter = (Task_t *)pvParam;
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		uiMutexWait(&xMutex, 0);
+		vTaskWakeUp(pxWaiter);
+		vTaskSuspend(pxCurrentTask);     // 等待者请求互斥量而阻塞
+		uiMutexNotify(&xMutex);          // 移交给等待者
+		vTaskSuspend(pxCurrentTask);     // 等待者释放互斥量
+	}
+	prvBenchStop();
+	prvBenchFinish();
+}
+
+static void prvMutexNoPiWaiterEntry (void * pvParam)
+{
+	for(;;)
+	{
+		uiMutexWait(&xMutex, 0);
+		uiMutexNotify(&xMutex);
+		vTaskSuspend(pxCurrentTask);
+	}
+}
+
+static void prvMutexNoPiKickEntry (void * pvParam)
+{
+	Task_t * pxOwner = (Task_t *)pvParam;
+	for(;;)
+	{
+		vTaskWakeUp(pxOwner);
+	}
+}
+
+// 存储块，无竞争的申请/释放
+static void prvMemBlockEntry (void * pvParam)
+{
+	uint8_t * pcMem;
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		uiMemBlockWait(&xMemBlock, &pcMem, 0);
+		vMemBlockNotify(&xMemBlock, pcMem);
+	}
+	prvBenchStop();
+	prvBenchFinish();
+}
+
+// 存储块移交：高优先级任务因没有存储块而阻塞，由低优先级任务释放的存储块直接唤醒
+static void prvMemBlockWaitEntry (void * pvParam)
+{
+	uint8_t * pcMem;
+	for(;;)
+	{
+		uiMemBlockWait(&xMemBlock, &pcMem, 0);
+		pcSharedBlock = pcMem;
+		vTaskSuspend(pxCurrentTask);
+	}
+}
+
+static void prvMemBlockNotifyEntry (void * pvParam)
+{
+	Task_t * pxWaiter = (Task_t *)pvParam;
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		vMemBlockNotify(&xMemBlock, pcSharedBlock);
+		vTaskWakeUp(pxWaiter);
+	}
+	prvBenchStop();
+	vMemBlockNotify(&xMemBlock, pcSharedBlock);   // 让等待任务以挂起状态结束，以便删除
+	prvBenchFinish();
+}
+
+// 事件标志组：N个任务分别等待各自的标志位，一次通知唤醒全部
+static void prvFlagWaiterEntry (void * pvParam)
+{
+	uint32_t uiBit = (uint32_t)(uintptr_t)pvParam;
+	uint32_t uiResult;
+	uint32_t i;
+
+	for(i = 0; i < BENCH_ITERATIONS / uiFlagWaiters; i++)
+	{
+		uiFlagGroupWait(&xFlagGroup, TFLAGGROUP_SET_ALL | TFLAGGROUP_CONSUME, uiBit, &uiResult, 0);
+	}
+	vTaskSuspend(pxCurrentTask);
+}
+
+static void prvFlagNotifierEntry (void * pvParam)
+{
+	uint32_t uiAllBits = (uint32_t)(uintptr_t)pvParam;
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS / uiFlagWaiters; i++)
+	{
+		vFlagGroupNotify(&xFlagGroup, TFLAGGROUP_SET_BIT, uiAllBits);
+	}
+	prvBenchStop();
+	dElapsedNs = dElapsedNs / (BENCH_ITERATIONS / uiFlagWaiters) * BENCH_ITERATIONS;
+	prvBenchFinish();
+}
+
+/*------------------------------------------------------- 驱动 --------------------------------------------------------*/
+
+static void prvBenchWorker (uint32_t uiIndex, TaskFunction_pt pxEntry, void * pvParam, uint32_t uiPrio)
+{
+	vTaskInit(&xWorkerTask[uiIndex], pxEntry, pvParam, uiPrio, xWorkerStack[uiIndex], sizeof(xWorkerStack[uiIndex]));
+}
+
+// 等待测试完成，删除所有测试任务并记录结果
+static void prvBenchCollect (const char * pcName, uint32_t uiWorkerCnt)
+{
+	uint32_t i;
+
+	uiSemWait(&xDoneSem, 0);
+	for(i = 0; i < uiWorkerCnt; i++)
+	{
+		vTaskForceDelete(&xWorkerTask[i]);
+	}
+
+	xResult[uiResultCnt].pcName = pcName;
+	xResult[uiResultCnt].dValue = dElapsedNs / BENCH_ITERATIONS;
+	uiResultCnt++;
+}
+
+// 任务创建：在驱动任务中反复创建并删除一个8KB堆栈的任务，新任务优先级较低，不会运行
+static void prvBenchTaskCreate (const char * pcName)
+{
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		vTaskInit(&xWorkerTask[0], prvSwitchLowEntry, (void *)0, 2, xCreateStack, sizeof(xCreateStack));
+		vTaskForceDelete(&xWorkerTask[0]);
+	}
+	prvBenchStop();
+
+	xResult[uiResultCnt].pcName = pcName;
+	xResult[uiResultCnt].dValue = dElapsedNs / BENCH_ITERATIONS;
+	uiResultCnt++;
+}
+
+static void prvBenchFlagGroup (const char * pcName, uint32_t uiWaiters)
+{
+	uint32_t i;
+
+	uiFlagWaiters = uiWaiters;
+	vFlagGroupInit(&xFlagGroup, 0);
+	for(i = 0; i < uiWaiters; i++)
+	{
+		prvBenchWorker(i, prvFlagWaiterEntry, (void *)(uintptr_t)(1u << i), 2);
+	}
+	prvBenchWorker(uiWaiters, prvFlagNotifierEntry, (void *)(uintptr_t)((1u << uiWaiters) - 1), 3);
+	prvBenchCollect(pcName, uiWaiters + 1);
+}
+
+// 读取基线文件，查找指定名称的结果
+static int prvBenchBaseline (FILE * pxFile, const char * pcName, double * pdValue)
+{
+	char cLine[128], cName[64];
+	double dValue;
+
+	rewind(pxFile);
+	while(fgets(cLine, sizeof(cLine), pxFile))
+	{
+		if(cLine[0] == '#')
+			continue;
+		if(sscanf(cLine, "%63s %lf", cName, &dValue) == 2 && strcmp(cName, pcName) == 0)
+		{
+			*pdValue = dValue;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// 输出结果，与基线比较，返回回退的项数
+static uint32_t prvBenchReport (void)
+{
+	const char * pcOutput = getenv("TINYOS_BENCH_OUTPUT");
+	const char * pcBaseline = getenv("TINYOS_BENCH_BASELINE");
+	const char * pcTolerance = getenv("TINYOS_BENCH_TOLERANCE");
+	double dTolerance = pcTolerance ? atof(pcTolerance) : BENCH_TOLERANCE;
+	FILE * pxBaseline = (FILE *)0;
+	FILE * pxOutput;
+	uint32_t uiRegressions = 0;
+	uint32_t i;
+
+	pxOutput = fopen(pcOutput ? pcOutput : "bench_results.txt", "w");
+	if(pxOutput)
+	{
+		fprintf(pxOutput, "# tinyOS kernel microbenchmarks, ns/op\n");
+		for(i = 0; i < uiResultCnt; i++)
+			fprintf(pxOutput, "%s %.1f\n", xResult[i].pcName, xResult[i].dValue);
+		fclose(pxOutput);
+	}
+
+	if(pcBaseline)
+	{
+		pxBaseline = fopen(pcBaseline, "r");
+		if(!pxBaseline)
+			fprintf(stderr, "bench: cannot open baseline %s\n", pcBaseline);
+	}
+
+	printf("%-24s %12s %12s %8s\n", "benchmark", "ns/op", "baseline", "delta");
+	for(i = 0; i < uiResultCnt; i++)
+	{
+		double dBase;
+
+		if(pxBaseline && prvBenchBaseline(pxBaseline, xResult[i].pcName, &dBase) && dBase > 0)
+		{
+			double dDelta = (xResult[i].dValue - dBase) * 100.0 / dBase;
+			int iRegressed = dDelta > dTolerance;
+
+			printf("%-24s %12.1f %12.1f %+7.1f%%%s\n", xResult[i].pcName, xResult[i].dValue, dBase, dDelta,
+				iRegressed ? "  REGRESSION" : "");
+			uiRegressions += iRegressed;
+		}
+		else
+		{
+			printf("%-24s %12.1f %12s %8s\n", xResult[i].pcName, xResult[i].dValue, "-", "-");
+		}
+	}
+
+	if(pxBaseline)
+	{
+		fclose(pxBaseline);
+		printf("%u regression(s) beyond %.0f%% tolerance\n", uiRegressions, dTolerance);
+	}
+	fflush(stdout);
+	return uiRegressions;
+}
+
+// 64位时间基准的读取，不进入临界区；同时检查读数单调
+static void prvBenchClockNow (const char * pcName)
+{
+	uint64_t ullLast = 0, ullNow;
+	uint32_t i;
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		ullNow = ullClockNow();
+		if(ullNow < ullLast)
+		{
+			fprintf(stderr, "bench: %s went backwards by %llu ns\n", pcName, (unsigned long long)(ullLast - ullNow));
+			exit(1);
+		}
+		ullLast = ullNow;
+	}
+	prvBenchStop();
+
+	xResult[uiResultCnt].pcName = pcName;
+	xResult[uiResultCnt].dValue = dElapsedNs / BENCH_ITERATIONS;
+	uiResultCnt++;
+}
+
+// 延时队列：若干个不会运行的任务结构作为延时中的任务，每个节拍到期的重新以随机的节拍数延时
+#define BENCH_SLEEPER_MAX         1000
+#define BENCH_SLEEP_RANGE         1024                   // 随机延时为1..BENCH_SLEEP_RANGE个节拍
+#define BENCH_SLEEP_RING          (BENCH_SLEEP_RANGE * 2)
+
+static Task_t xSleeperTask[BENCH_SLEEPER_MAX + 1];
+static uint16_t usSleeperNext[BENCH_SLEEPER_MAX + 1];
+static uint16_t usSleeperRing[BENCH_SLEEP_RING];         // 按到期节拍挂接的任务序号，0xFFFF为空
+static uint32_t uiBenchSeed = 1;
+
+static uint32_t prvBenchRandomTicks (void)
+{
+	uiBenchSeed = uiBenchSeed * 1103515245u + 12345u;
+	return 1 + (uiBenchSeed >> 16) % BENCH_SLEEP_RANGE;
+}
+
+static void prvBenchSleep (uint32_t uiIndex, uint32_t uiNow)
+{
+	uint32_t uiTicks = prvBenchRandomTicks();
+	uint32_t uiSlot = (uiNow + uiTicks) % BENCH_SLEEP_RING;
+
+	vTimeTaskWait(&xSleeperTask[uiIndex], uiTicks);
+	usSleeperNext[uiIndex] = usSleeperRing[uiSlot];
+	usSleeperRing[uiSlot] = (uint16_t)uiIndex;
+}
+
+// 已有uiSleepers个任务在延时时，测量插入与删除一个延时的开销(delay_insert_N)，
+// 以及每个节拍的处理开销，包括到期任务的唤醒与重新延时(delay_tick_N)
+static void prvBenchDelay (const char * pcInsert, const char * pcTick, uint32_t uiSleepers)
+{
+	Task_t * pxProbe = &xSleeperTask[BENCH_SLEEPER_MAX];
+	uint32_t uiStatus, i, uiIndex;
+
+	memset(xSleeperTask, 0, sizeof(xSleeperTask));
+	memset(usSleeperRing, 0xFF, sizeof(usSleeperRing));
+	for(i = 0; i <= BENCH_SLEEPER_MAX; i++)
+	{
+#if TINYOS_ENABLE_DELAY_WHEEL
+		vWheelNodeInit(&xSleeperTask[i].xDelayNode);
+#else
+		vNodeInit(&xSleeperTask[i].xDelayNode);
+#endif
+		vNodeInit(&xSleeperTask[i].xLinkNode);
+		xSleeperTask[i].uiPrio = TINYOS_PRO_COUNT - 2;
+	}
+
+	// 节拍由本函数驱动，整个过程中屏蔽真实的节拍中断
+	uiStatus = uiTaskEnterCritical();
+	for(i = 0; i < uiSleepers; i++)
+		prvBenchSleep(i, 0);
+
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		vTimeTaskWait(pxProbe, prvBenchRandomTicks());
+		vTimeTaskRemove(pxProbe);
+	}
+	prvBenchStop();
+	xResult[uiResultCnt].pcName = pcInsert;
+	xResult[uiResultCnt].dValue = dElapsedNs / BENCH_ITERATIONS;
+	uiResultCnt++;
+
+	prvBenchStart();
+	for(i = 1; i <= BENCH_ITERATIONS; i++)
+	{
+		vTaskSystemTickHandler();
+
+		uiIndex = usSleeperRing[i % BENCH_SLEEP_RING];
+		usSleeperRing[i % BENCH_SLEEP_RING] = 0xFFFF;
+		while(uiIndex != 0xFFFF)
+		{
+			uint32_t uiNext = usSleeperNext[uiIndex];
+
+			if(xSleeperTask[uiIndex].uiState & TINYOS_TASK_STATE_DELAYED)
+			{
+				fprintf(stderr, "bench: %s sleeper %u did not expire on time\n", pcTick, uiIndex);
+				exit(1);
+			}
+			vTaskSchedUnRdy(&xSleeperTask[uiIndex]);
+			prvBenchSleep(uiIndex, i);
+			uiIndex = uiNext;
+		}
+	}
+	prvBenchStop();
+	xResult[uiResultCnt].pcName = pcTick;
+	xResult[uiResultCnt].dValue = dElapsedNs / BENCH_ITERATIONS;
+	uiResultCnt++;
+
+	for(i = 0; i < uiSleepers; i++)
+		vTimeTaskRemove(&xSleeperTask[i]);
+	vTaskExitCritical(uiStatus);
+}
+
+// 定时器节拍处理：若干个周期为数秒的硬定时器，大多数节拍上没有定时器到期
+#define BENCH_TIMER_MAX           1000
+
+static Timer_t xBenchTimer[BENCH_TIMER_MAX];
+static uint32_t uiBenchTimerFired;
+
+static void prvBenchTimerFunc (void * pvArg)
+{
+	uiBenchTimerFired++;
+}
+
+static void prvBenchTimer (const char * pcName, uint32_t uiTimers)
+{
+	uint32_t uiStatus, i, uiTicks;
+
+	for(i = 0; i < uiTimers; i++)
+	{
+		uiTicks = 1000 + prvBenchRandomTicks() * 4;
+		vTimerInit(&xBenchTimer[i], uiTicks, uiTicks, prvBenchTimerFunc, (void *)0, TIMER_CONFIG_TYPE_HARD);
+		vTimerStart(&xBenchTimer[i]);
+	}
+
+	// 节拍由本函数驱动，整个过程中屏蔽真实的节拍中断
+	uiStatus = uiTaskEnterCritical();
+	prvBenchStart();
+	for(i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		vTimerModuleTickNotify();
+	}
+	prvBenchStop();
+	vTaskExitCritical(uiStatus);
+
+	for(i = 0; i < uiTimers; i++)
+		vTimerDestroy(&xBenchTimer[i]);
+
+	xResult[uiResultCnt].pcName = pcName;
+	xResult[uiResultCnt].dValue = dElapsedNs / BENCH_ITERATIONS;
+	uiResultCnt++;
+}
+
+static void prvBenchDriverEntry (void * pvParam)
+{
+	uint32_t uiStatus;
+
+	vSemInit(&xDoneSem, 0, 0);
+
+	prvBenchWorker(0, prvSwitchHighEntry, (void *)0, 2);
+	prvBenchWorker(1, prvSwitchLowEntry, &xWorkerTask[0], 3);
+	prvBenchCollect("task_switch", 2);
+
+	vSemInit(&xSem1, 0, 0);
+	vSemInit(&xSem2, 0, 0);
+	prvBenchWorker(0, prvSemPongEntry, (void *)0, 2);
+	prvBenchWorker(1, prvSemPingEntry, (void *)0, 3);
+	prvBenchCollect("sem_pingpong", 2);
+
+	// 按优先级排列的等待队列
+	vSemInit(&xSem1, 0, 0);
+	vSemInit(&xSem2, 0, 0);
+	vEventSetOrder(&xSem1.xEvent, eEventOrderPrio);
+	vEventSetOrder(&xSem2.xEvent, eEventOrderPrio);
+	prvBenchWorker(0, prvSemPongEntry, (void *)0, 2);
+	prvBenchWorker(1, prvSemPingEntry, (void *)0, 3);
+	prvBenchCollect("sem_pingpong_prio", 2);
+
+	vMboxInit(&xMbox, pvMboxBuf, BENCH_MBOX_SIZE);
+	prvBenchWorker(0, prvMboxProducerEntry, (void *)0, 2);
+	prvBenchWorker(1, prvMboxConsumerEntry, &xWorkerTask[0], 3);
+	prvBenchCollect("mbox_msg", 2);
+
+	vMutexInit(&xMutex);
+	prvBenchWorker(0, prvMutexLockEntry, (void *)0, 2);
+	prvBenchCollect("mutex_lock_unlock", 1);
+
+	vMutexInit(&xMutex);
+	prvBenchWorker(0, prvMutexPiHighEntry, (void *)0, 2);
+	vTaskSuspend(&xWorkerTask[0]);
+	prvBenchWorker(1, prvMutexPiLowEntry, &xWorkerTask[0], 4);
+	prvBenchCollect("mutex_handoff_pi", 2);
+
+	vMutexInitCeiling(&xMutex, 2);
+	prvBenchWorker(0, prvMutexPiHighEntry, (void *)0, 2);
+	vTaskSuspend(&xWorkerTask[0]);
+	prvBenchWorker(1, prvMutexCeilingLowEntry, &xWorkerTask[0], 4);
+	prvBenchCollect("mutex_handoff_ceiling", 2);
+
+	vMutexInit(&xMutex);
+	prvBenchWorker(1, prvMutexNoPiWaiterEntry, (void *)0, 4);
+	vTaskSuspend(&xWorkerTask[1]);
+	prvBenchWorker(0, prvMutexNoPiOwnerEntry, &xWorkerTask[1], 2);
+	prvBenchWorker(2, prvMutexNoPiKickEntry, &xWorkerTask[0], 6);
+	prvBenchCollect("mutex_handoff_nopi", 3);
+
+	vMemBlockInit(&xMemBlock, (uint8_t *)ucMemBuf, sizeof(ucMemBuf[0]), 4);
+	prvBenchWorker(0, prvMemBlockEntry, (void *)0, 2);
+	prvBenchCollect("memblock_alloc_free", 1);
+
+	vMemBlockInit(&xMemBlock, (uint8_t *)ucMemBuf, sizeof(ucMemBuf[0]), 1);
+	uiMemBlockNoWaitGet(&xMemBlock, (void **)&pcSharedBlock);
+	prvBenchWorker(0, prvMemBlockWaitEntry, (void *)0, 2);
+	prvBenchWorker(1, prvMemBlockNotifyEntry, &xWorkerTask[0], 3);
+	prvBenchCollect("memblock_handoff", 2);
+
+	prvBenchFlagGroup("flaggroup_notify_1", 1);
+	prvBenchFlagGroup("flaggroup_notify_4", 4);
+	prvBenchFlagGroup("flaggroup_notify_16", 16);
+
+	prvBenchTaskCreate("task_create_8k");
+
+	prvBenchClockNow("clock_now");
+
+	prvBenchDelay("delay_insert_10", "delay_tick_10", 10);
+	prvBenchDelay("delay_insert_100", "delay_tick_100", 100);
+	prvBenchDelay("delay_insert_1000", "delay_tick_1000", 1000);
+
+	prvBenchTimer("timer_tick_10", 10);
+	prvBenchTimer("timer_tick_100", 100);
+	prvBenchTimer("timer_tick_1000", 1000);
+
+	// 输出期间不允许切换，避免在标准库中被抢占
+	uiStatus = uiTaskEnterCritical();
+	exit(prvBenchReport() ? 1 : 0);
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vAppInit
+** Descriptions         :   基准测试的应用入口，创建驱动任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vAppInit(void)
+{
+	vTaskInit(&xDriverTask, prvBenchDriverEntry, (void *)0, BENCH_DRIVER_PRIO, xDriverStack, sizeof(xDriverStack));
+}
@@ -0,0 +1,185 @@
+#include "tinyOS.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !TINYOS_ENABLE_SMP
+#error "tSmpScale.c must be built with TINYOS_ENABLE_SMP=1"
+#endif
+
+/****************** 宏/变量定义 ****************************/
+
+// SMP扩展性测试：替代tApp.c作为应用，以真实节拍运行，核数由TINYOS_SMP_CORES指定。
+// TINYOS_SMP_TEST选择负载：
+//   compute  - 若干个同优先级的计算任务，互不通信，吞吐量应随核数线性增长
+//   pingpong - 成对的任务用信号量来回唤醒，每次操作都要进入内核，反映内核锁的竞争
+// 报告任务在TINYOS_SMP_SECONDS秒后输出每秒的操作次数、各核上完成的操作数与迁移次数，然后退出
+
+#define SMP_TEST_SECONDS          3                      // 默认测试时长（秒）
+#define SMP_WORKER_CNT            8                      // 计算任务与乒乓任务的数量
+#define SMP_STACK_SIZE            256
+#define SMP_REPORTER_PRIO         2                      // 高于所有测试任务
+#define SMP_WORKER_PRIO           4
+#define SMP_COMPUTE_LOOPS         20000                  // 一次计算操作的循环次数
+
+typedef struct {
+	const char * pcName;
+	void (*pxInit)(void);
+}SmpTest_t;
+
+static Task_t xSmpReporterTask;
+static TaskStack_t xSmpReporterStack[SMP_STACK_SIZE];
+static Task_t xSmpTask[SMP_WORKER_CNT];
+static TaskStack_t xSmpStack[SMP_WORKER_CNT][SMP_STACK_SIZE];
+
+static Sem_t xSmpSem[SMP_WORKER_CNT];
+
+// 每个核上完成的操作数，只由该核上运行的任务修改
+static volatile unsigned long ulSmpCoreOps[TINYOS_CORE_COUNT];
+
+static const SmpTest_t * pxSmpTest;
+static volatile uint32_t uiSmpSink;
+
+/*------------------------------------------------------- 测试任务 --------------------------------------------------------*/
+
+// 一次计算操作，结果写入volatile变量防止被优化掉
+static void prvSmpCompute (void)
+{
+	uint32_t uiValue = 1, i;
+
+	for(i = 0; i < SMP_COMPUTE_LOOPS; i++)
+		uiValue = uiValue * 1103515245 + 12345;
+	uiSmpSink = uiValue;
+}
+
+static void prvSmpComputeEntry (void * pvParam)
+{
+	(void)pvParam;
+
+	for(;;)
+	{
+		prvSmpCompute();
+		ulSmpCoreOps[uiPortCoreId()]++;
+	}
+}
+
+// 相邻的两个任务为一对，各自唤醒对方后等待对方的唤醒
+static void prvSmpPingEntry (void * pvParam)
+{
+	uint32_t uiId = (uint32_t)(uintptr_t)pvParam;
+
+	for(;;)
+	{
+		vSemNotify(&xSmpSem[uiId ^ 1]);
+		uiSemWait(&xSmpSem[uiId], 0);
+		ulSmpCoreOps[uiPortCoreId()]++;
+	}
+}
+
+static void prvSmpComputeInit (void)
+{
+	uint32_t i;
+
+	for(i = 0; i < SMP_WORKER_CNT; i++)
+		vTaskInit(&xSmpTask[i], prvSmpComputeEntry, (void *)0, SMP_WORKER_PRIO, xSmpStack[i], sizeof(xSmpStack[i]));
+}
+
+static void prvSmpPingPongInit (void)
+{
+	uint32_t i;
+
+	for(i = 0; i < SMP_WORKER_CNT; i++)
+		vSemInit(&xSmpSem[i], 0, 0);
+	for(i = 0; i < SMP_WORKER_CNT; i++)
+		vTaskInit(&xSmpTask[i], prvSmpPingEntry, (void *)(uintptr_t)i, SMP_WORKER_PRIO, xSmpStack[i], sizeof(xSmpStack[i]));
+}
+
+static const SmpTest_t xSmpTestTable[] = {
+	{"compute",  prvSmpComputeInit},
+	{"pingpong", prvSmpPingPongInit},
+};
+
+// 最高优先级任务，测试结束后输出结果并退出
+static void prvSmpReporterEntry (void * pvParam)
+{
+	const char * pcEnv = getenv("TINYOS_SMP_SECONDS");
+	uint32_t uiSeconds = pcEnv ? (uint32_t)atoi(pcEnv) : SMP_TEST_SECONDS;
+	unsigned long ulStart[TINYOS_CORE_COUNT], ulTotal = 0;
+	uint32_t uiMigrate = 0, uiStatus, i;
+	struct timespec xStart, xEnd;
+	double dSeconds;
+	TaskInfo_t xInfo;
+
+	(void)pvParam;
+
+	if(uiSeconds == 0)
+		uiSeconds = 1;
+
+	// 跳过启动阶段，各核都开始调度后再计数
+	vTaskDelay(TICKS_PER_SEC);
+	for(i = 0; i < uiPortCoreCount(); i++)
+		ulStart[i] = ulSmpCoreOps[i];
+	clock_gettime(CLOCK_MONOTONIC, &xStart);
+
+	vTaskDelay(uiSeconds * TICKS_PER_SEC);
+
+	// 主机CPU不足时节拍信号会合并丢失，按墙上时间计算速率
+	uiStatus = uiTaskEnterCritical();
+	clock_gettime(CLOCK_MONOTONIC, &xEnd);
+	dSeconds = (xEnd.tv_sec - xStart.tv_sec) + (xEnd.tv_nsec - xStart.tv_nsec) / 1e9;
+	for(i = 0; i < uiPortCoreCount(); i++)
+	{
+		ulStart[i] = ulSmpCoreOps[i] - ulStart[i];
+		ulTotal += ulStart[i];
+	}
+	for(i = 0; i < SMP_WORKER_CNT; i++)
+	{
+		vTaskGetInfo(&xSmpTask[i], &xInfo);
+		uiMigrate += xInfo.uiMigrateCnt;
+	}
+
+	printf("smp %-8s cores %u: %12.1f ops/s, %u migrations, per core:", pxSmpTest->pcName, uiPortCoreCount(),
+		ulTotal / dSeconds, uiMigrate);
+	for(i = 0; i < uiPortCoreCount(); i++)
+		printf(" %lu", ulStart[i]);
+	printf("\n");
+	fflush(stdout);
+	vTaskExitCritical(uiStatus);
+
+	exit(0);
+}
+
+/**********************************************************************************************************
+** Function name        :   vAppInit
+** Descriptions         :   SMP扩展性测试的应用入口，按TINYOS_SMP_TEST创建测试任务与报告任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vAppInit(void)
+{
+	const char * pcEnv = getenv("TINYOS_SMP_TEST");
+	uint32_t i;
+
+	pxSmpTest = &xSmpTestTable[0];
+	for(i = 0; pcEnv && i < sizeof(xSmpTestTable) / sizeof(xSmpTestTable[0]); i++)
+	{
+		if(strcmp(pcEnv, xSmpTestTable[i].pcName) == 0)
+			break;
+	}
+
+	if(pcEnv && i == sizeof(xSmpTestTable) / sizeof(xSmpTestTable[0]))
+	{
+		fprintf(stderr, "unknown TINYOS_SMP_TEST '%s', expected one of:", pcEnv);
+		for(i = 0; i < sizeof(xSmpTestTable) / sizeof(xSmpTestTable[0]); i++)
+			fprintf(stderr, " %s", xSmpTestTable[i].pcName);
+		fprintf(stderr, "\n");
+		exit(2);
+	}
+	if(pcEnv)
+		pxSmpTest = &xSmpTestTable[i];
+
+	vTaskInit(&xSmpReporterTask, prvSmpReporterEntry, (void *)0, SMP_REPORTER_PRIO, xSmpReporterStack, sizeof(xSmpReporterStack));
+	pxSmpTest->pxInit();
+}
@@ -0,0 +1,374 @@
+#include "tinyOS.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/****************** 宏/变量定义 ****************************/
+
+// Thread-Metric RTOS基准测试的移植：替代tApp.c作为应用，在Linux主机移植上以真实节拍运行。
+// 每个测试由若干个计数任务与一个最高优先级的报告任务组成，报告任务每隔TM_TEST_DURATION秒
+// 输出该时间段内的计数总和，数值越大越好。测试用环境变量TINYOS_TM_TEST选择：
+//   cooperative / preemptive / interrupt / interrupt_preemption / message / synchronization / memory
+// TINYOS_TM_DURATION可缩短报告周期，TINYOS_TM_PERIODS指定报告次数后退出（默认不退出）
+
+#define TM_TEST_DURATION          30                     // 报告周期（秒）
+#define TM_THREAD_MAX             5                      // 每个测试最多的计数任务数量
+#define TM_STACK_SIZE             256
+#define TM_REPORTER_PRIO          2                      // Thread-Metric的优先级1~31与tinyOS的0~31方向一致
+#define TM_QUEUE_SIZE             10                     // 消息队列深度
+#define TM_MESSAGE_WORDS          4                      // 每条消息16字节
+#define TM_MEMORY_BLOCK_SIZE      128
+#define TM_MEMORY_BLOCK_CNT       16
+
+typedef struct {
+	const char * pcName;                                 // 环境变量中使用的名称
+	const char * pcTitle;                                // 报告中输出的名称
+	void (*pxInit)(void);                                // 创建该测试的任务与对象
+	uint32_t uiCounterCnt;                               // 参与统计的计数器数量
+}TmTest_t;
+
+static Task_t xTmReporterTask;
+static TaskStack_t xTmReporterStack[TM_STACK_SIZE];
+static Task_t xTmTask[TM_THREAD_MAX];
+static TaskStack_t xTmStack[TM_THREAD_MAX][TM_STACK_SIZE];
+
+static volatile unsigned long ulTmCounter[TM_THREAD_MAX + 1];
+
+static Sem_t xTmSem;
+static Mbox_t xTmQueue;
+static void * pvTmQueueBuf[TM_QUEUE_SIZE];
+static unsigned long ulTmQueueSlot[TM_QUEUE_SIZE][TM_MESSAGE_WORDS];
+static uint32_t uiTmQueueIn;
+static MemBlock_t xTmPool;
+static uint8_t ucTmPoolBuf[TM_MEMORY_BLOCK_CNT][TM_MEMORY_BLOCK_SIZE];
+
+static const TmTest_t * pxTmTest;
+
+/*------------------------------------------------------- 移植层 --------------------------------------------------------*/
+
+// 创建任务，创建后处于挂起状态，由prvTmThreadResume启动
+static void prvTmThreadCreate (uint32_t uiId, uint32_t uiPrio, TaskFunction_pt pxEntry)
+{
+	vTaskInit(&xTmTask[uiId], pxEntry, (void *)0, uiPrio, xTmStack[uiId], sizeof(xTmStack[uiId]));
+	vTaskSuspend(&xTmTask[uiId]);
+}
+
+static void prvTmThreadResume (uint32_t uiId)
+{
+	vTaskWakeUp(&xTmTask[uiId]);
+}
+
+static void prvTmThreadSuspend (uint32_t uiId)
+{
+	vTaskSuspend(&xTmTask[uiId]);
+}
+
+static void prvTmThreadRelinquish (void)
+{
+	vTaskYield();
+}
+
+// 队列保存消息的副本：邮箱只传递指针，因此发送时把消息拷贝到循环使用的消息槽中
+static void prvTmQueueSend (unsigned long * pulMessage)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	unsigned long * pulSlot = ulTmQueueSlot[uiTmQueueIn];
+
+	uiTmQueueIn = (uiTmQueueIn + 1) % TM_QUEUE_SIZE;
+	memcpy(pulSlot, pulMessage, sizeof(ulTmQueueSlot[0]));
+	uiMboxNotify(&xTmQueue, pulSlot, MBOXSENDNORMAL);
+	vTaskExitCritical(uiStatus);
+}
+
+static void prvTmQueueReceive (unsigned long * pulMessage)
+{
+	void * pvSlot;
+
+	uiMboxWait(&xTmQueue, &pvSlot, 0);
+	memcpy(pulMessage, pvSlot, sizeof(ulTmQueueSlot[0]));
+}
+
+/*------------------------------------------------------- 协作式调度 --------------------------------------------------------*/
+
+// 5个同优先级任务，每次计数后主动让出CPU
+static void prvTmCooperativeEntry (void * pvParam)
+{
+	uint32_t uiId = pxCurrentTask - xTmTask;
+	for(;;)
+	{
+		ulTmCounter[uiId]++;
+		prvTmThreadRelinquish();
+	}
+}
+
+static void prvTmCooperativeInit (void)
+{
+	uint32_t i;
+	for(i = 0; i < 5; i++)
+	{
+		prvTmThreadCreate(i, 3, prvTmCooperativeEntry);
+		prvTmThreadResume(i);
+	}
+}
+
+/*------------------------------------------------------- 抢占式调度 --------------------------------------------------------*/
+
+// 任务0优先级最低，依次唤醒更高优先级的下一个任务，每个任务计数后挂起自己
+static void prvTmPreemptiveEntry (void * pvParam)
+{
+	uint32_t uiId = pxCurrentTask - xTmTask;
+	for(;;)
+	{
+		if(uiId < 4)
+			prvTmThreadResume(uiId + 1);
+		ulTmCounter[uiId]++;
+		if(uiId > 0)
+			prvTmThreadSuspend(uiId);
+	}
+}
+
+static void prvTmPreemptiveInit (void)
+{
+	uint32_t i;
+	for(i = 0; i < 5; i++)
+	{
+		prvTmThreadCreate(i, 10 - i, prvTmPreemptiveEntry);
+	}
+	prvTmThreadResume(0);
+}
+
+/*------------------------------------------------------- 中断处理 --------------------------------------------------------*/
+
+static void prvTmInterruptHandler (void)
+{
+	ulTmCounter[1]++;
+	vSemNotifyFromISR(&xTmSem);
+	vTaskYieldFromISR();
+}
+
+// 任务触发中断，中断中释放信号量，任务随后取得信号量
+static void prvTmInterruptEntry (void * pvParam)
+{
+	for(;;)
+	{
+		vPortSoftInterrupt(prvTmInterruptHandler);
+		uiSemWait(&xTmSem, 0);
+		ulTmCounter[0]++;
+	}
+}
+
+static void prvTmInterruptInit (void)
+{
+	vSemInit(&xTmSem, 0, 0);
+	prvTmThreadCreate(0, 10, prvTmInterruptEntry);
+	prvTmThreadResume(0);
+}
+
+/*------------------------------------------------------- 中断抢占 --------------------------------------------------------*/
+
+static void prvTmInterruptPreemptionHandler (void)
+{
+	ulTmCounter[2]++;
+	prvTmThreadResume(1);
+}
+
+// 低优先级任务触发中断，中断中唤醒高优先级任务，中断返回后发生抢占
+static void prvTmInterruptPreemptionLowEntry (void * pvParam)
+{
+	for(;;)
+	{
+		vPortSoftInterrupt(prvTmInterruptPreemptionHandler);
+		ulTmCounter[0]++;
+	}
+}
+
+static void prvTmInterruptPreemptionHighEntry (void * pvParam)
+{
+	for(;;)
+	{
+		ulTmCounter[1]++;
+		prvTmThreadSuspend(1);
+	}
+}
+
+static void prvTmInterruptPreemptionInit (void)
+{
+	prvTmThreadCreate(0, 10, prvTmInterruptPreemptionLowEntry);
+	prvTmThreadCreate(1, 9, prvTmInterruptPreemptionHighEntry);
+	prvTmThreadResume(0);
+}
+
+/*------------------------------------------------------- 消息传递 --------------------------------------------------------*/
+
+// 任务向队列发送16字节的消息，再接收回来并校验
+static void prvTmMessageEntry (void * pvParam)
+{
+	unsigned long ulSend[TM_MESSAGE_WORDS] = {0x11112222, 0x33334444, 0x55556666, 0x77778888};
+	unsigned long ulReceive[TM_MESSAGE_WORDS];
+
+	for(;;)
+	{
+		prvTmQueueSend(ulSend);
+		prvTmQueueReceive(ulReceive);
+		if(ulReceive[3] != ulSend[3])
+			break;
+		ulSend[3]++;
+		ulTmCounter[0]++;
+	}
+
+	printf("**** Thread-Metric message test: message mismatch\n");
+	prvTmThreadSuspend(0);
+}
+
+static void prvTmMessageInit (void)
+{
+	vMboxInit(&xTmQueue, pvTmQueueBuf, TM_QUEUE_SIZE);
+	prvTmThreadCreate(0, 10, prvTmMessageEntry);
+	prvTmThreadResume(0);
+}
+
+/*------------------------------------------------------- 同步 --------------------------------------------------------*/
+
+static void prvTmSynchronizationEntry (void * pvParam)
+{
+	for(;;)
+	{
+		if(uiSemWait(&xTmSem, 0) != eErrorNoError)
+			break;
+		vSemNotify(&xTmSem);
+		ulTmCounter[0]++;
+	}
+
+	printf("**** Thread-Metric synchronization test: semaphore error\n");
+	prvTmThreadSuspend(0);
+}
+
+static void prvTmSynchronizationInit (void)
+{
+	vSemInit(&xTmSem, 1, 1);
+	prvTmThreadCreate(0, 10, prvTmSynchronizationEntry);
+	prvTmThreadResume(0);
+}
+
+/*------------------------------------------------------- 存储分配 --------------------------------------------------------*/
+
+static void prvTmMemoryEntry (void * pvParam)
+{
+	uint8_t * pcMem;
+
+	for(;;)
+	{
+		if(uiMemBlockWait(&xTmPool, &pcMem, 0) != eErrorNoError)
+			break;
+		vMemBlockNotify(&xTmPool, pcMem);
+		ulTmCounter[0]++;
+	}
+
+	printf("**** Thread-Metric memory allocation test: allocation error\n");
+	prvTmThreadSuspend(0);
+}
+
+static void prvTmMemoryInit (void)
+{
+	vMemBlockInit(&xTmPool, (uint8_t *)ucTmPoolBuf, TM_MEMORY_BLOCK_SIZE, TM_MEMORY_BLOCK_CNT);
+	prvTmThreadCreate(0, 10, prvTmMemoryEntry);
+	prvTmThreadResume(0);
+}
+
+/*------------------------------------------------------- 报告 --------------------------------------------------------*/
+
+static const TmTest_t xTmTestTable[] = {
+	{"cooperative",          "Cooperative Scheduling Test",       prvTmCooperativeInit,         5},
+	{"preemptive",           "Preemptive Scheduling Test",        prvTmPreemptiveInit,          5},
+	{"interrupt",            "Interrupt Processing Test",         prvTmInterruptInit,           2},
+	{"interrupt_preemption", "Interrupt Preemption Processing Test", prvTmInterruptPreemptionInit, 3},
+	{"message",              "Message Processing Test",           prvTmMessageInit,             1},
+	{"synchronization",      "Synchronization Processing Test",   prvTmSynchronizationInit,     1},
+	{"memory",               "Memory Allocation Test",            prvTmMemoryInit,              1},
+};
+
+// 最高优先级任务，每个周期输出计数总和，并检查各计数器是否均衡
+static void prvTmReporterEntry (void * pvParam)
+{
+	const char * pcEnv = getenv("TINYOS_TM_DURATION");
+	uint32_t uiDuration = pcEnv ? (uint32_t)atoi(pcEnv) : TM_TEST_DURATION;
+	uint32_t uiPeriods = 0, uiPeriod;
+	unsigned long ulLast[TM_THREAD_MAX + 1] = {0};
+	unsigned long ulRelativeTime = 0;
+	uint32_t i;
+
+	pcEnv = getenv("TINYOS_TM_PERIODS");
+	if(pcEnv)
+		uiPeriods = (uint32_t)atoi(pcEnv);
+
+	for(uiPeriod = 1; !uiPeriods || uiPeriod <= uiPeriods; uiPeriod++)
+	{
+		unsigned long ulDelta[TM_THREAD_MAX + 1];
+		unsigned long ulTotal = 0, ulAverage;
+		uint32_t uiStatus;
+
+		vTaskDelay(uiDuration * TICKS_PER_SEC);
+		ulRelativeTime += uiDuration;
+
+		for(i = 0; i < pxTmTest->uiCounterCnt; i++)
+		{
+			unsigned long ulNow = ulTmCounter[i];
+			ulDelta[i] = ulNow - ulLast[i];
+			ulLast[i] = ulNow;
+			ulTotal += ulDelta[i];
+		}
+
+		uiStatus = uiTaskEnterCritical();
+		printf("**** Thread-Metric %s **** Relative Time: %lu\n", pxTmTest->pcTitle, ulRelativeTime);
+
+		// 各计数器与平均值相差超过1时，说明调度不公平或者有任务停止运行
+		ulAverage = ulTotal / pxTmTest->uiCounterCnt;
+		for(i = 0; i < pxTmTest->uiCounterCnt; i++)
+		{
+			if(ulDelta[i] + 1 < ulAverage || ulDelta[i] > ulAverage + 1)
+			{
+				printf("ERROR: Invalid counter value(s). Thread-Metric counters are not balanced!\n");
+				break;
+			}
+		}
+		printf("Time Period Total:  %lu\n\n", ulTotal);
+		fflush(stdout);
+		vTaskExitCritical(uiStatus);
+	}
+
+	exit(0);
+}
+
+/**********************************************************************************************************
+** Function name        :   vAppInit
+** Descriptions         :   Thread-Metric的应用入口，按TINYOS_TM_TEST创建测试任务与报告任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vAppInit(void)
+{
+	const char * pcEnv = getenv("TINYOS_TM_TEST");
+	uint32_t i;
+
+	pxTmTest = &xTmTestTable[0];
+	for(i = 0; pcEnv && i < sizeof(xTmTestTable) / sizeof(xTmTestTable[0]); i++)
+	{
+		if(strcmp(pcEnv, xTmTestTable[i].pcName) == 0)
+			break;
+	}
+
+	if(pcEnv && i == sizeof(xTmTestTable) / sizeof(xTmTestTable[0]))
+	{
+		fprintf(stderr, "unknown TINYOS_TM_TEST '%s', expected one of:", pcEnv);
+		for(i = 0; i < sizeof(xTmTestTable) / sizeof(xTmTestTable[0]); i++)
+			fprintf(stderr, " %s", xTmTestTable[i].pcName);
+		fprintf(stderr, "\n");
+		exit(2);
+	}
+	if(pcEnv)
+		pxTmTest = &xTmTestTable[i];
+
+	vTaskInit(&xTmReporterTask, prvTmReporterEntry, (void *)0, TM_REPORTER_PRIO, xTmReporterStack, sizeof(xTmReporterStack));
+	pxTmTest->pxInit();
+}
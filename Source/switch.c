@@ -1,102 +1,228 @@
-#include "tinyOS.h"
-
-/****************** 宏/变量定义 ****************************/
-#define NVIC_INT_CTRL     0xE000ED04    // 中断控制及状态寄存器
-#define NVIC_PENDSVSET    0x10000000    // 挂起PendSV中断的值
-#define NVIC_SYSPRI2      0xE000ED22    // PendSV优先级寄存器
-#define NVIC_PENDSV_PRI   0x000000FF    // 优先级值最低
-
-#define MEM32(addr)       *(volatile unsigned long*)(addr)
-#define MEM8(addr)        *(volatile unsigned char*)(addr)
-
-/**********************************************************************************************************
-** Function name        :   uiTaskEnterCritical
-** Descriptions         :   进入临界区
-** parameters           :   无
-** Returned value       :   进入临界区之前的中断状态值
-***********************************************************************************************************/
-uint32_t uiTaskEnterCritical (void)
-{
-	uint32_t uiPrimask = __get_PRIMASK();
-	__disable_irq();
-	return uiPrimask;
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskExitCritical
-** Descriptions         :   退出临界区
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskExitCritical (uint32_t uiStatus)
-{
-	__set_PRIMASK(uiStatus);
-}
-
-/**********************************************************************************************************
-** Function name        :   PendSV_Handler
-** Descriptions         :   PendSV异常处理函数
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-__asm void PendSV_Handler()
-{
-	IMPORT pxCurrentTask
-	IMPORT pxNextTask
-	
-	MRS 	R0, PSP                    // 初始PSP为0   R0<-PSP
-	CBZ 	R0, PendSV_Handler_nosave  /* 如果R0为0，说明是上电之后的第一个任务，
-	                                      则不需要保存现场，直接切换到相应任务栈 */
-	STMDB 	R0!, {R4-R11}              // 保存现场(注：XPSR/PC/LR等寄存器在PendSV异常触发时由硬件保存)
-	LDR 	R1, =pxCurrentTask
-	LDR 	R1, [R1]                 
-	STR 	R0, [R1]                   // 更新当前任务栈的栈顶地址
-
-PendSV_Handler_nosave
-	
-	LDR 	R0, =pxCurrentTask
-	LDR		R1, =pxNextTask
-	LDR 	R2, [R1]                   // 下一任务堆栈指针的地址
-	STR 	R2, [R0]                   
-	
-	LDR 	R0, [R2]                   // 当前任务堆栈栈顶地址
-	LDMIA	R0!, {R4-R11}              // 恢复现场，其他寄存器由硬件恢复
-	
-	MSR 	PSP, R0	                   // 将栈顶地址写入用户栈寄存器PSP  PSP<-R0  
-	ORR 	LR, LR, #0x04		       // 标记退出处理函数时，切换到PSP堆栈
-	BX		LR                         // LR->PC
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskStartScheduler
-** Descriptions         :   在启动tinyOS时，调用该函数，将切换至第一个任务运行
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskStartScheduler(void)
-{
-	__set_PSP(0);                      // 初始化用户栈栈顶为0地址
-	
-	MEM8(NVIC_SYSPRI2)   = NVIC_PENDSV_PRI;
-	MEM32(NVIC_INT_CTRL) = NVIC_PENDSVSET;	
-	
-	// 可以看到，这个函数是没有返回
-    // 这是因为，一旦触发PendSV后，将会在PendSV后立即进行任务切换，切换至第1个任务运行
-    // 此后，tinyOS将负责管理所有任务的运行，永远不会返回到该函数运行
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskSwitch
-** Descriptions         :   调用后进行一次任务切换，调用前需要先设置好pxCurrentTask和pxNextTask
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSwitch(void)
-{
-	MEM32(NVIC_INT_CTRL) = NVIC_PENDSVSET;
-}
-
-
-
-
-
+// 本文件实现临界区本身，不使用临界区测量的替换版本
+#define TINYOS_CRITICAL_PROFILE_IMPL
+#include "tinyOS.h"
+
+#ifndef TINYOS_PORT_LINUX
+
+/****************** 宏/变量定义 ****************************/
+#define NVIC_INT_CTRL     0xE000ED04    // 中断控制及状态寄存器
+#define NVIC_PENDSVSET    0x10000000    // 挂起PendSV中断的值
+#define NVIC_SYSPRI2      0xE000ED22    // PendSV优先级寄存器
+#define NVIC_PENDSV_PRI   0x000000FF    // 优先级值最低
+
+#define MEM32(addr)       *(volatile unsigned long*)(addr)
+#define MEM8(addr)        *(volatile unsigned char*)(addr)
+
+#if TINYOS_ENABLE_STACK_PROFILE
+// 启动文件导出的主堆栈栈顶，主堆栈的大小为TINYOS_ISR_STACK_SIZE
+extern uint32_t __initial_sp;
+#define PORT_ISR_STACK_BASE   ((uint32_t *)&__initial_sp - TINYOS_ISR_STACK_SIZE / sizeof(uint32_t))
+#endif
+
+/**********************************************************************************************************
+** Function name        :   uiTaskEnterCritical
+** Descriptions         :   进入临界区
+** parameters           :   无
+** Returned value       :   进入临界区之前的中断状态值
+***********************************************************************************************************/
+uint32_t uiTaskEnterCritical (void)
+{
+	uint32_t uiPrimask = __get_PRIMASK();
+	__disable_irq();
+	return uiPrimask;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskExitCritical
+** Descriptions         :   退出临界区
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskExitCritical (uint32_t uiStatus)
+{
+	__set_PRIMASK(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   pxTaskStackInit
+** Descriptions         :   在任务堆栈中构造初始运行现场
+** parameters           :   puiStackBase     任务堆栈的起始地址（低地址）
+** parameters           :   uiStackSize      任务堆栈大小（字节）
+** parameters           :   pxTaskCode       任务的入口函数
+** parameters           :   pvParam          传递给任务的运行参数
+** Returned value       :   构造完现场后的栈顶地址
+***********************************************************************************************************/
+TaskStack_t * pxTaskStackInit(TaskStack_t * puiStackBase, uint32_t uiStackSize, TaskFunction_pt pxTaskCode, void * pvParam)
+{
+	TaskStack_t * puiStackTop = puiStackBase + uiStackSize / sizeof(TaskStack_t);
+	
+    *(--puiStackTop) = (unsigned long)(1<<24);                // XPSR, 设置了Thumb模式，恢复到Thumb状态而非ARM状态运行
+    *(--puiStackTop) = (unsigned long)pxTaskCode;                  // 程序的入口地址
+    *(--puiStackTop) = (unsigned long)0x14;                   // R14(LR), 任务不会通过return xxx结束自己，所以未用
+    *(--puiStackTop) = (unsigned long)0x12;                   // R12, 未用
+    *(--puiStackTop) = (unsigned long)0x3;                    // R3, 未用
+    *(--puiStackTop) = (unsigned long)0x2;                    // R2, 未用
+    *(--puiStackTop) = (unsigned long)0x1;                    // R1, 未用
+    *(--puiStackTop) = (unsigned long)pvParam;                  // R0 = param, 传给任务的入口函数
+    *(--puiStackTop) = (unsigned long)0x11;                   // R11, 未用
+    *(--puiStackTop) = (unsigned long)0x10;                   // R10, 未用
+    *(--puiStackTop) = (unsigned long)0x9;                    // R9, 未用
+    *(--puiStackTop) = (unsigned long)0x8;                    // R8, 未用
+    *(--puiStackTop) = (unsigned long)0x7;                    // R7, 未用
+    *(--puiStackTop) = (unsigned long)0x6;                    // R6, 未用
+    *(--puiStackTop) = (unsigned long)0x5;                    // R5, 未用
+    *(--puiStackTop) = (unsigned long)0x4;                    // R4, 未用
+	
+	return puiStackTop;
+}
+
+/**********************************************************************************************************
+** Function name        :   PendSV_Handler
+** Descriptions         :   PendSV异常处理函数
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+__asm void PendSV_Handler()
+{
+	IMPORT pxCurrentTask
+	IMPORT pxNextTask
+	
+	MRS 	R0, PSP                    // 初始PSP为0   R0<-PSP
+	CBZ 	R0, PendSV_Handler_nosave  /* 如果R0为0，说明是上电之后的第一个任务，
+	                                      则不需要保存现场，直接切换到相应任务栈 */
+	STMDB 	R0!, {R4-R11}              // 保存现场(注：XPSR/PC/LR等寄存器在PendSV异常触发时由硬件保存)
+	LDR 	R1, =pxCurrentTask
+	LDR 	R1, [R1]                 
+	STR 	R0, [R1]                   // 更新当前任务栈的栈顶地址
+
+PendSV_Handler_nosave
+	
+	LDR 	R0, =pxCurrentTask
+	LDR		R1, =pxNextTask
+	LDR 	R2, [R1]                   // 下一任务堆栈指针的地址
+	STR 	R2, [R0]                   
+	
+	LDR 	R0, [R2]                   // 当前任务堆栈栈顶地址
+	LDMIA	R0!, {R4-R11}              // 恢复现场，其他寄存器由硬件恢复
+	
+	MSR 	PSP, R0	                   // 将栈顶地址写入用户栈寄存器PSP  PSP<-R0  
+	ORR 	LR, LR, #0x04		       // 标记退出处理函数时，切换到PSP堆栈
+	BX		LR                         // LR->PC
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskStartScheduler
+** Descriptions         :   在启动tinyOS时，调用该函数，将切换至第一个任务运行
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskStartScheduler(void)
+{
+	__set_PSP(0);                      // 初始化用户栈栈顶为0地址
+	
+	MEM8(NVIC_SYSPRI2)   = NVIC_PENDSV_PRI;
+	MEM32(NVIC_INT_CTRL) = NVIC_PENDSVSET;	
+	
+	// 可以看到，这个函数是没有返回
+    // 这是因为，一旦触发PendSV后，将会在PendSV后立即进行任务切换，切换至第1个任务运行
+    // 此后，tinyOS将负责管理所有任务的运行，永远不会返回到该函数运行
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskSwitch
+** Descriptions         :   调用后进行一次任务切换，调用前需要先设置好pxCurrentTask和pxNextTask
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSwitch(void)
+{
+	MEM32(NVIC_INT_CTRL) = NVIC_PENDSVSET;
+}
+
+/**********************************************************************************************************
+** Function name        :   vPortTimestampInit
+** Descriptions         :   使能DWT周期计数器作为时间戳
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortTimestampInit(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortTimestamp
+** Descriptions         :   读取DWT周期计数器
+** parameters           :   无
+** Returned value       :   CPU周期数
+***********************************************************************************************************/
+uint32_t uiPortTimestamp(void)
+{
+	return DWT->CYCCNT;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortTimestampFreq
+** Descriptions         :   时间戳的计数频率，即CPU主频
+** parameters           :   无
+** Returned value       :   频率(Hz)
+***********************************************************************************************************/
+uint32_t uiPortTimestampFreq(void)
+{
+	return SystemCoreClock;
+}
+
+#if TINYOS_ENABLE_STACK_PROFILE
+/**********************************************************************************************************
+** Function name        :   vPortStackProfileInit
+** Descriptions         :   在main()中调用，填充主堆栈当前栈顶以下未使用的部分，启动调度后主堆栈只由中断使用
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortStackProfileInit (void)
+{
+	uint32_t * puiWord = PORT_ISR_STACK_BASE;
+	uint32_t * puiLimit = (uint32_t *)__get_MSP() - 16;         // 留出本函数自己的栈帧
+
+	while(puiWord < puiLimit)
+		*puiWord++ = TINYOS_STACK_PROFILE_PAINT;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortTaskStackUsed
+** Descriptions         :   任务堆栈用到的最大字节数，由空闲任务测得
+** parameters           :   pxTask 任务
+** Returned value       :   字节数，任务还没有运行过时返回0
+***********************************************************************************************************/
+uint32_t uiPortTaskStackUsed (Task_t * pxTask)
+{
+	TaskInfo_t xInfo;
+	uint32_t uiUsed;
+
+	vTaskGetInfo(pxTask, &xInfo);
+	uiUsed = xInfo.uiStackSize - xInfo.uiStackFree;
+	
+	// 只用到了pxTaskStackInit构造的16个字的初始现场，说明任务还没有运行过
+	return uiUsed > 16 * sizeof(TaskStack_t) ? uiUsed : 0;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortIsrStackUsed
+** Descriptions         :   主堆栈用到的最大字节数，包括main()在启动调度前用到的部分
+** parameters           :   无
+** Returned value       :   字节数
+***********************************************************************************************************/
+uint32_t uiPortIsrStackUsed (void)
+{
+	uint32_t * puiStack = PORT_ISR_STACK_BASE;
+	uint32_t uiFree = 0;
+
+	while((uiFree < TINYOS_ISR_STACK_SIZE / sizeof(uint32_t)) && (puiStack[uiFree] == TINYOS_STACK_PROFILE_PAINT))
+		uiFree++;
+	return TINYOS_ISR_STACK_SIZE - uiFree * sizeof(uint32_t);
+}
+#endif
+
+#endif /* TINYOS_PORT_LINUX */
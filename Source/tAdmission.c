@@ -0,0 +1,376 @@
+#include "tinyOS.h"
+
+#if TINYOS_ENABLE_ADMISSION
+
+/****************** 宏/变量定义 ****************************/
+
+#define ADMISSION_TICK_US                       (TINYOS_ONE_TICK_TO_MS * 1000)
+#define ADMISSION_PPM                           1000000ULL
+
+// 响应时间以32位微秒保存，超出时取不可调度标记以下的最大值
+#define prvAdmissionClamp(ullUs)                ((ullUs) < TINYOS_ADMISSION_UNSCHEDULABLE ? (uint32_t)(ullUs) : TINYOS_ADMISSION_UNSCHEDULABLE - 1)
+
+// 分析用的任务参数，时间的单位均为微秒。由节拍数换算来的时间用64位保存，较长的周期换算后不会溢出
+typedef struct {
+	Task_t * pxTask;
+	uint32_t uiPrio;
+	uint32_t uiWcet;                   // 声明值与测得值中较大的一个
+	uint64_t ullPeriod;
+	uint64_t ullDeadline;
+	uint64_t ullCapWcet;               // CPU预算，为0表示没有设置
+	uint64_t ullCapPeriod;
+	uint32_t uiCapPrio;                // 预算用完后降到的优先级
+	uint32_t uiResponse;               // 分析得到的最坏响应时间
+}AdmissionParam_t;
+
+// 声明过周期与WCET的任务
+static List_t g_xAdmissionList;
+
+// 分析时的任务集快照，只在禁止调度期间使用
+static AdmissionParam_t g_xAdmissionParam[TINYOS_ADMISSION_MAX_TASKS];
+
+// 调度器最近一次选出的任务，以及它开始运行的时间戳。执行时间只累计两次切换之间的差值，
+// 使用读取开销最小的周期计数器，不使用ullClockNow()
+static Task_t * g_pxAdmissionRunning;
+static uint32_t g_uiAdmissionSwitchTime;
+
+/**********************************************************************************************************
+** Function name        :   prvAdmissionJobDone
+** Descriptions         :   被切换出去的任务是否结束了本次作业：因延时、等待事件或挂起而放弃CPU时结束，
+**                          被抢占、预算用完或等待互斥量时作业继续
+** parameters           :   pxTask 被切换出去的任务
+** Returned value       :   1表示作业结束，0表示没有
+***********************************************************************************************************/
+static uint32_t prvAdmissionJobDone (Task_t * pxTask)
+{
+	uint32_t uiBlocked = TINYOS_TASK_STATE_DELAYED | TINYOS_TASK_STATE_SUSPEND | TINYOS_TASK_STATE_DESTROYED | TINYOS_TASK_WAIT_MASK;
+
+	if(!(pxTask->uiState & uiBlocked))
+		return 0;
+	return !(pxTask->pxWaitEvent && pxTask->pxWaitEvent->eType == eEventTYpeMutex);
+}
+
+/**********************************************************************************************************
+** Function name        :   prvAdmissionParam
+** Descriptions         :   取出任务的分析参数
+** parameters           :   pxParam 存放参数的位置
+** parameters           :   pxTask 声明过的任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvAdmissionParam (AdmissionParam_t * pxParam, Task_t * pxTask)
+{
+	pxParam->pxTask = pxTask;
+	pxParam->uiPrio = pxTask->uiAdmissionPrio;
+	pxParam->uiWcet = pxTask->uiExecMax > pxTask->uiAdmissionWcet ? pxTask->uiExecMax : pxTask->uiAdmissionWcet;
+	pxParam->ullPeriod = (uint64_t)pxTask->uiAdmissionPeriod * ADMISSION_TICK_US;
+	pxParam->ullDeadline = (uint64_t)pxTask->uiAdmissionDeadline * ADMISSION_TICK_US;
+	pxParam->ullCapWcet = 0;
+#if TINYOS_ENABLE_BUDGET
+	if(pxTask->uiBudget)
+	{
+		pxParam->ullCapWcet = (uint64_t)pxTask->uiBudget * ADMISSION_TICK_US;
+		pxParam->ullCapPeriod = (uint64_t)pxTask->uiBudgetPeriod * ADMISSION_TICK_US;
+		pxParam->uiCapPrio = pxTask->uiBudgetPrio;
+	}
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   prvAdmissionInterference
+** Descriptions         :   较高或相同优先级的任务在一段时间内最多占用的CPU时间。预算用完后暂停或降到低于被干扰任务的
+**                          优先级时，干扰同时不超过按预算计算的值
+** parameters           :   pxHp 干扰的任务
+** parameters           :   uiPrio 被干扰任务的优先级
+** parameters           :   ullWindow 时间长度(微秒)
+** Returned value       :   微秒数
+***********************************************************************************************************/
+static uint64_t prvAdmissionInterference (AdmissionParam_t * pxHp, uint32_t uiPrio, uint64_t ullWindow)
+{
+	uint64_t ullBusy = (ullWindow + pxHp->ullPeriod - 1) / pxHp->ullPeriod * pxHp->uiWcet;
+
+	if(pxHp->ullCapWcet && pxHp->ullCapPeriod && pxHp->uiCapPrio > uiPrio)
+	{
+		uint64_t ullCap = (ullWindow + pxHp->ullCapPeriod - 1) / pxHp->ullCapPeriod * pxHp->ullCapWcet;
+		if(ullCap < ullBusy)
+			ullBusy = ullCap;
+	}
+	return ullBusy;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvAdmissionResponse
+** Descriptions         :   固定优先级任务的响应时间分析：R = C + Σ⌈R/Tj⌉Cj，迭代到不动点或超过截止期
+** parameters           :   uiCnt 任务集中的任务数量
+** parameters           :   i 被分析的任务
+** Returned value       :   最坏响应时间(微秒)，超过截止期时返回TINYOS_ADMISSION_UNSCHEDULABLE
+***********************************************************************************************************/
+static uint32_t prvAdmissionResponse (uint32_t uiCnt, uint32_t i)
+{
+	AdmissionParam_t * pxParam = &g_xAdmissionParam[i];
+	uint64_t ullResponse = pxParam->uiWcet ? pxParam->uiWcet : 1;
+	uint64_t ullNext;
+	uint32_t j;
+
+	for(;;)
+	{
+		ullNext = pxParam->uiWcet;
+		for(j = 0; j < uiCnt; j++)
+		{
+			// 同优先级的任务轮转运行，按相互干扰计算
+			if(j != i && g_xAdmissionParam[j].uiPrio <= pxParam->uiPrio)
+				ullNext += prvAdmissionInterference(&g_xAdmissionParam[j], pxParam->uiPrio, ullResponse);
+		}
+		if(ullNext > pxParam->ullDeadline)
+			return TINYOS_ADMISSION_UNSCHEDULABLE;
+		if(ullNext <= ullResponse)
+			return prvAdmissionClamp(ullNext);
+		ullResponse = ullNext;
+	}
+}
+
+#if TINYOS_ENABLE_EDF
+/**********************************************************************************************************
+** Function name        :   prvAdmissionEdfResponse
+** Descriptions         :   EDF任务的密度测试：ΣCi/min(Di,Ti)加上更高优先级任务的利用率不超过1时，所有EDF任务都能满足截止期
+** parameters           :   uiCnt 任务集中的任务数量
+** parameters           :   i 被分析的任务
+** Returned value       :   通过时返回截止期，否则返回TINYOS_ADMISSION_UNSCHEDULABLE
+***********************************************************************************************************/
+static uint32_t prvAdmissionEdfResponse (uint32_t uiCnt, uint32_t i)
+{
+	uint64_t ullDensity = 0;
+	uint32_t j;
+
+	for(j = 0; j < uiCnt; j++)
+	{
+		AdmissionParam_t * pxParam = &g_xAdmissionParam[j];
+		uint64_t ullWindow = pxParam->ullPeriod;
+
+		if(pxParam->uiPrio > TINYOS_EDF_PRIO)
+			continue;
+		if(pxParam->uiPrio == TINYOS_EDF_PRIO && pxParam->ullDeadline < ullWindow)
+			ullWindow = pxParam->ullDeadline;
+		ullDensity += (pxParam->uiWcet * ADMISSION_PPM + ullWindow - 1) / ullWindow;
+	}
+	return ullDensity > ADMISSION_PPM ? TINYOS_ADMISSION_UNSCHEDULABLE : prvAdmissionClamp(g_xAdmissionParam[i].ullDeadline);
+}
+#endif
+
+/**********************************************************************************************************
+** Function name        :   prvAdmissionAnalyze
+** Descriptions         :   分析g_xAdmissionParam中的任务集，结果写入各项的uiResponse
+** parameters           :   uiCnt 任务数量
+** Returned value       :   可能错过截止期的任务数量
+***********************************************************************************************************/
+static uint32_t prvAdmissionAnalyze (uint32_t uiCnt)
+{
+	uint32_t uiMiss = 0, i;
+
+	for(i = 0; i < uiCnt; i++)
+	{
+#if TINYOS_ENABLE_EDF
+		if(g_xAdmissionParam[i].uiPrio == TINYOS_EDF_PRIO)
+			g_xAdmissionParam[i].uiResponse = prvAdmissionEdfResponse(uiCnt, i);
+		else
+#endif
+		g_xAdmissionParam[i].uiResponse = prvAdmissionResponse(uiCnt, i);
+
+		if(g_xAdmissionParam[i].uiResponse == TINYOS_ADMISSION_UNSCHEDULABLE)
+			uiMiss++;
+	}
+	return uiMiss;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvAdmissionCollect
+** Descriptions         :   取出所有声明过的任务的参数，调用者需已禁止调度
+** parameters           :   无
+** Returned value       :   任务数量
+***********************************************************************************************************/
+static uint32_t prvAdmissionCollect (void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	uint32_t uiCnt = 0;
+	Node_t * pxNode;
+
+	for(pxNode = pxListFirst(&g_xAdmissionList); pxNode; pxNode = pxListNext(&g_xAdmissionList, pxNode))
+	{
+		prvAdmissionParam(&g_xAdmissionParam[uiCnt++], pxNodeParent(pxNode, Task_t, xAdmissionNode));
+	}
+
+	vTaskExitCritical(uiStatus);
+	return uiCnt;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvAdmissionStore
+** Descriptions         :   将分析得到的最坏响应时间写回各任务
+** parameters           :   uiCnt 任务数量
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvAdmissionStore (uint32_t uiCnt)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	uint32_t i;
+
+	for(i = 0; i < uiCnt; i++)
+	{
+		g_xAdmissionParam[i].pxTask->uiResponseTime = g_xAdmissionParam[i].uiResponse;
+	}
+
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vAdmissionInit
+** Descriptions         :   初始化声明过的任务链表
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vAdmissionInit (void)
+{
+	vListInit(&g_xAdmissionList);
+	g_pxAdmissionRunning = (Task_t *)0;
+	vPortTimestampInit();
+}
+
+/**********************************************************************************************************
+** Function name        :   vAdmissionSwitch
+** Descriptions         :   调度器选出新的任务时调用，累计切换出去的任务本次作业的执行时间。
+**                          两个任务都没有声明过时不读取时间戳
+** parameters           :   pxNext 即将运行的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vAdmissionSwitch (Task_t * pxNext)
+{
+	Task_t * pxPrev = g_pxAdmissionRunning;
+	uint32_t uiNow;
+
+	if(pxNext == pxPrev)
+		return;
+	g_pxAdmissionRunning = pxNext;
+	if(!(pxPrev && pxPrev->uiAdmissionPeriod) && !pxNext->uiAdmissionPeriod)
+		return;
+
+	uiNow = uiPortTimestamp();
+	if(pxPrev && pxPrev->uiAdmissionPeriod)
+	{
+		pxPrev->ullExecJob += uiNow - g_uiAdmissionSwitchTime;
+		if(prvAdmissionJobDone(pxPrev))
+		{
+			uint64_t ullUs = pxPrev->ullExecJob * 1000000ULL / uiPortTimestampFreq();
+
+			if(ullUs > pxPrev->uiExecMax)
+				pxPrev->uiExecMax = ullUs > 0xFFFFFFFFULL ? 0xFFFFFFFF : (uint32_t)ullUs;
+			pxPrev->ullExecJob = 0;
+		}
+	}
+	g_uiAdmissionSwitchTime = uiNow;
+}
+
+/**********************************************************************************************************
+** Function name        :   vAdmissionTaskDelete
+** Descriptions         :   任务被删除时将其移出分析的任务集
+** parameters           :   pxTask 被删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vAdmissionTaskDelete (Task_t * pxTask)
+{
+	if(pxTask->uiAdmissionPeriod)
+	{
+		vListRemove(&g_xAdmissionList, &pxTask->xAdmissionNode);
+		pxTask->uiAdmissionPeriod = 0;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   uiTaskInitTimed
+** Descriptions         :   声明周期、WCET与截止期并创建任务。加入该任务后任务集不可调度时，TINYOS_ADMISSION_REJECT
+**                          为1则不创建任务，为0则照常创建，只通过返回值警告。优先级为TINYOS_EDF_PRIO的任务同时
+**                          以该截止期与周期加入EDF调度类
+** parameters           :   pxTask ~ uiStackSize 与vTaskInit相同
+** parameters           :   uiPeriod 周期(节拍数)，不能为0
+** parameters           :   uiWcet 最坏执行时间(微秒)
+** parameters           :   uiDeadline 相对截止期(节拍数)，为0表示等于周期
+** Returned value       :   eErrorNoError，不可调度时返回eErrorUnschedulable，声明过的任务数量已达上限时返回eErrorResourceFull，
+**                          周期为0时返回eErrorResourceUnavaliable
+***********************************************************************************************************/
+uint32_t uiTaskInitTimed (Task_t * pxTask, TaskFunction_pt pxTaskCode, void * pvParam, uint32_t uiPrio,
+                          TaskStack_t * pxStack, uint32_t uiStackSize,
+                          uint32_t uiPeriod, uint32_t uiWcet, uint32_t uiDeadline)
+{
+	AdmissionParam_t * pxParam;
+	uint32_t uiCnt, uiMiss, uiStatus;
+	uint32_t uiError = eErrorNoError;
+
+	// 周期是分析中的除数，不能为0
+	if(!uiPeriod)
+		return eErrorResourceUnavaliable;
+	if(!uiDeadline)
+		uiDeadline = uiPeriod;
+
+	// 分析期间禁止调度，任务集与快照不会被其它任务改变
+	vTaskSchedDisable();
+
+	uiCnt = prvAdmissionCollect();
+	if(uiCnt == TINYOS_ADMISSION_MAX_TASKS)
+	{
+		vTaskSchedEnable();
+		return eErrorResourceFull;
+	}
+
+	pxParam = &g_xAdmissionParam[uiCnt++];
+	pxParam->pxTask = pxTask;
+	pxParam->uiPrio = uiPrio;
+	pxParam->uiWcet = uiWcet;
+	pxParam->ullPeriod = (uint64_t)uiPeriod * ADMISSION_TICK_US;
+	pxParam->ullDeadline = (uint64_t)uiDeadline * ADMISSION_TICK_US;
+	pxParam->ullCapWcet = 0;
+
+	uiMiss = prvAdmissionAnalyze(uiCnt);
+	if(uiMiss && TINYOS_ADMISSION_REJECT)
+	{
+		vTaskSchedEnable();
+		return eErrorUnschedulable;
+	}
+
+	vTaskInit(pxTask, pxTaskCode, pvParam, uiPrio, pxStack, uiStackSize);
+
+	uiStatus = uiTaskEnterCritical();
+	pxTask->uiAdmissionPeriod = uiPeriod;
+	pxTask->uiAdmissionDeadline = uiDeadline;
+	pxTask->uiAdmissionWcet = uiWcet;
+	pxTask->uiAdmissionPrio = uiPrio;
+	vListAddLast(&g_xAdmissionList, &pxTask->xAdmissionNode);
+	vTaskExitCritical(uiStatus);
+	prvAdmissionStore(uiCnt);
+
+#if TINYOS_ENABLE_EDF
+	if(uiPrio == TINYOS_EDF_PRIO)
+		uiError = uiTaskSetDeadline(pxTask, uiDeadline, uiPeriod);
+#endif
+
+	vTaskSchedEnable();
+	return uiMiss ? eErrorUnschedulable : uiError;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiAdmissionCheck
+** Descriptions         :   以测得的执行时间重新分析当前的任务集，更新各任务的最坏响应时间
+** parameters           :   无
+** Returned value       :   可能错过截止期的任务数量
+***********************************************************************************************************/
+uint32_t uiAdmissionCheck (void)
+{
+	uint32_t uiCnt, uiMiss;
+
+	vTaskSchedDisable();
+	uiCnt = prvAdmissionCollect();
+	uiMiss = prvAdmissionAnalyze(uiCnt);
+	prvAdmissionStore(uiCnt);
+	vTaskSchedEnable();
+
+	return uiMiss;
+}
+
+#endif /* TINYOS_ENABLE_ADMISSION */
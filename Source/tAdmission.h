@@ -0,0 +1,69 @@
+#ifndef _TADMISSION_H
+#define _TADMISSION_H
+
+#include <stdint.h>
+#include "tConfig.h"
+#include "tTask.h"
+
+// 可调度性准入控制：用uiTaskInitTimed创建的任务声明周期、最坏执行时间(WCET)与截止期，创建前对所有声明过的任务
+// 做一次分析：固定优先级的任务做响应时间分析，同优先级的任务按相互干扰计算；EDF优先级的任务做密度测试，
+// 更高优先级任务的利用率计入其中。设置了CPU预算的任务对较低优先级任务的干扰按预算计算。
+// 内核在任务切换时测量声明过的任务每次作业的执行时间，一次作业从开始运行到因延时、等待事件或挂起而放弃CPU为止，
+// 等待互斥量属于作业内部的阻塞。分析时WCET取声明值与测得的最大值中较大的一个。
+// 没有声明的任务(包括定时器任务)不参与分析，互斥量造成的阻塞时间也不计入
+
+#if TINYOS_ENABLE_ADMISSION
+
+#define TINYOS_ADMISSION_UNSCHEDULABLE         0xFFFFFFFF              // 响应时间超过截止期
+
+/**********************************************************************************************************
+** Function name        :   vAdmissionInit
+** Descriptions         :   初始化声明过的任务链表
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vAdmissionInit (void);
+
+/**********************************************************************************************************
+** Function name        :   vAdmissionSwitch
+** Descriptions         :   调度器选出新的任务时调用，累计切换出去的任务本次作业的执行时间
+** parameters           :   pxNext 即将运行的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vAdmissionSwitch (Task_t * pxNext);
+
+/**********************************************************************************************************
+** Function name        :   vAdmissionTaskDelete
+** Descriptions         :   任务被删除时将其移出分析的任务集
+** parameters           :   pxTask 被删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vAdmissionTaskDelete (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   uiTaskInitTimed
+** Descriptions         :   声明周期、WCET与截止期并创建任务。加入该任务后任务集不可调度时，TINYOS_ADMISSION_REJECT
+**                          为1则不创建任务，为0则照常创建，只通过返回值警告。优先级为TINYOS_EDF_PRIO的任务同时
+**                          以该截止期与周期加入EDF调度类
+** parameters           :   pxTask ~ uiStackSize 与vTaskInit相同
+** parameters           :   uiPeriod 周期(节拍数)，不能为0
+** parameters           :   uiWcet 最坏执行时间(微秒)
+** parameters           :   uiDeadline 相对截止期(节拍数)，为0表示等于周期
+** Returned value       :   eErrorNoError，不可调度时返回eErrorUnschedulable，声明过的任务数量已达上限时返回eErrorResourceFull，
+**                          周期为0时返回eErrorResourceUnavaliable
+***********************************************************************************************************/
+uint32_t uiTaskInitTimed (Task_t * pxTask, TaskFunction_pt pxTaskCode, void * pvParam, uint32_t uiPrio,
+                          TaskStack_t * pxStack, uint32_t uiStackSize,
+                          uint32_t uiPeriod, uint32_t uiWcet, uint32_t uiDeadline);
+
+/**********************************************************************************************************
+** Function name        :   uiAdmissionCheck
+** Descriptions         :   以测得的执行时间重新分析当前的任务集，更新各任务的最坏响应时间
+** parameters           :   无
+** Returned value       :   可能错过截止期的任务数量
+***********************************************************************************************************/
+uint32_t uiAdmissionCheck (void);
+
+#endif /* TINYOS_ENABLE_ADMISSION */
+
+#endif /* _TADMISSION_H */
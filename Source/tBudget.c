@@ -0,0 +1,235 @@
+#include "tinyOS.h"
+
+#if TINYOS_ENABLE_BUDGET
+
+/****************** 宏/变量定义 ****************************/
+
+// 有等待中的预算补充的任务，每个节拍检查其中最早的一项是否到期
+static List_t g_xBudgetList;
+
+extern uint32_t uiTickCount;
+
+/**********************************************************************************************************
+** Function name        :   prvBudgetExhaust
+** Descriptions         :   预算用完，将任务降级或暂停。正在运行的任务在本次节拍处理结束时被切换出去
+** parameters           :   pxTask 任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvBudgetExhaust (Task_t * pxTask)
+{
+	pxTask->uiBudgetOverrunCnt++;
+	
+	if(pxTask->uiBudgetPrio == TINYOS_BUDGET_THROTTLE)
+	{
+		// 暂停期间任务不在就绪表中，其它状态的变化照常记录，预算补充时再根据状态决定是否就绪
+		if(pxTask->uiState == TINYOS_TASK_STATE_RDY)
+			vTaskSchedUnRdy(pxTask);
+		pxTask->uiState |= TINYOS_TASK_STATE_THROTTLED;
+	}
+	else if(pxTask->uiBudgetPrio > pxTask->uiBasePrio)
+	{
+		// 只降低基础优先级，持有互斥量时继承的优先级仍然有效
+		pxTask->uiBudgetNormalPrio = pxTask->uiBasePrio;
+		pxTask->uiBasePrio = pxTask->uiBudgetPrio;
+		vMutexPrioUpdate(pxTask);
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvBudgetRestore
+** Descriptions         :   预算得到补充，恢复被降级或暂停的任务
+** parameters           :   pxTask 任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvBudgetRestore (Task_t * pxTask)
+{
+	if(pxTask->uiState & TINYOS_TASK_STATE_THROTTLED)
+	{
+		pxTask->uiState &= ~TINYOS_TASK_STATE_THROTTLED;
+		if(pxTask->uiState == TINYOS_TASK_STATE_RDY)
+			vTaskSchedRdy(pxTask);
+	}
+	else if(pxTask->uiBasePrio == pxTask->uiBudgetPrio && pxTask->uiBasePrio != pxTask->uiBudgetNormalPrio)
+	{
+		pxTask->uiBasePrio = pxTask->uiBudgetNormalPrio;
+		vMutexPrioUpdate(pxTask);
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvBudgetReplenish
+** Descriptions         :   补充已经到期的预算，用完的预算得到补充时恢复任务
+** parameters           :   pxTask 任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvBudgetReplenish (Task_t * pxTask)
+{
+	uint32_t uiLeft = pxTask->uiBudgetLeft;
+	
+	while(pxTask->cBudgetReplCnt && (int32_t)(uiTickCount - pxTask->uiBudgetReplTime[pxTask->cBudgetReplHead]) >= 0)
+	{
+		pxTask->uiBudgetLeft += pxTask->uiBudgetReplAmount[pxTask->cBudgetReplHead];
+		pxTask->cBudgetReplHead = (pxTask->cBudgetReplHead + 1) % TINYOS_BUDGET_REPL_MAX;
+		pxTask->cBudgetReplCnt--;
+	}
+	
+	if(!pxTask->cBudgetReplCnt)
+		vListRemove(&g_xBudgetList, &pxTask->xBudgetNode);
+	
+	if(!uiLeft && pxTask->uiBudgetLeft)
+		prvBudgetRestore(pxTask);
+}
+
+/**********************************************************************************************************
+** Function name        :   vBudgetInit
+** Descriptions         :   初始化等待补充预算的任务链表
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vBudgetInit (void)
+{
+	vListInit(&g_xBudgetList);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiBudgetCharge
+** Descriptions         :   在节拍中断中调用，为正在运行的任务扣除一个节拍的预算，用完时降级或暂停。
+**                          与上一次扣除相邻的节拍属于同一次激活，计入同一项补充；补充项已满时并入最后一项，
+**                          并把补充时刻推迟到本次激活之后一个周期，只会使补充更晚
+** parameters           :   pxTask 正在运行并且设置了预算的任务
+** Returned value       :   1表示预算在本节拍用完，0表示没有
+***********************************************************************************************************/
+uint32_t uiBudgetCharge (Task_t * pxTask)
+{
+	uint32_t uiLast;
+	
+	// 降级运行的时间不消耗预算
+	if(!pxTask->uiBudgetLeft)
+		return 0;
+	
+	uiLast = (pxTask->cBudgetReplHead + pxTask->cBudgetReplCnt + TINYOS_BUDGET_REPL_MAX - 1) % TINYOS_BUDGET_REPL_MAX;
+	if(pxTask->cBudgetReplCnt && pxTask->uiBudgetLastTick + 1 == uiTickCount)
+	{
+		pxTask->uiBudgetReplAmount[uiLast]++;
+	}
+	else if(pxTask->cBudgetReplCnt < TINYOS_BUDGET_REPL_MAX)
+	{
+		uiLast = (uiLast + 1) % TINYOS_BUDGET_REPL_MAX;
+		pxTask->uiBudgetReplTime[uiLast] = uiTickCount + pxTask->uiBudgetPeriod;
+		pxTask->uiBudgetReplAmount[uiLast] = 1;
+		if(!pxTask->cBudgetReplCnt++)
+			vListAddLast(&g_xBudgetList, &pxTask->xBudgetNode);
+	}
+	else
+	{
+		pxTask->uiBudgetReplTime[uiLast] = uiTickCount + pxTask->uiBudgetPeriod;
+		pxTask->uiBudgetReplAmount[uiLast]++;
+	}
+	pxTask->uiBudgetLastTick = uiTickCount;
+	
+	if(--pxTask->uiBudgetLeft)
+		return 0;
+	
+	prvBudgetExhaust(pxTask);
+	return 1;
+}
+
+/**********************************************************************************************************
+** Function name        :   vBudgetTick
+** Descriptions         :   在节拍中断中调用，补充到期的预算，恢复预算用完的任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vBudgetTick (void)
+{
+	Node_t * pxNode = pxListFirst(&g_xBudgetList);
+	
+	while(pxNode)
+	{
+		Task_t * pxTask = pxNodeParent(pxNode, Task_t, xBudgetNode);
+		
+		// 补充完的任务会从链表中移除，先取得下一个结点
+		pxNode = pxListNext(&g_xBudgetList, pxNode);
+		prvBudgetReplenish(pxTask);
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   uiBudgetNextTicks
+** Descriptions         :   距离最早一个预算用完的任务得到补充还有多少个节拍，只有这类任务的补充会改变调度
+** parameters           :   无
+** Returned value       :   节拍数，没有预算用完的任务时返回TINYOS_TICKS_NONE
+***********************************************************************************************************/
+uint32_t uiBudgetNextTicks (void)
+{
+	uint32_t uiTicks = TINYOS_TICKS_NONE;
+	Node_t * pxNode;
+	
+	for(pxNode = pxListFirst(&g_xBudgetList); pxNode; pxNode = pxListNext(&g_xBudgetList, pxNode))
+	{
+		Task_t * pxTask = pxNodeParent(pxNode, Task_t, xBudgetNode);
+		int32_t iWait = (int32_t)(pxTask->uiBudgetReplTime[pxTask->cBudgetReplHead] - uiTickCount);
+		
+		if(pxTask->uiBudgetLeft)
+			continue;
+		if(iWait < 0)
+			iWait = 0;
+		if((uint32_t)iWait < uiTicks)
+			uiTicks = (uint32_t)iWait;
+	}
+	return uiTicks;
+}
+
+/**********************************************************************************************************
+** Function name        :   vBudgetTaskDelete
+** Descriptions         :   任务被删除时取消其等待中的预算补充
+** parameters           :   pxTask 被删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vBudgetTaskDelete (Task_t * pxTask)
+{
+	if(pxTask->cBudgetReplCnt)
+	{
+		vListRemove(&g_xBudgetList, &pxTask->xBudgetNode);
+		pxTask->cBudgetReplCnt = 0;
+	}
+	pxTask->uiBudget = 0;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiTaskSetBudget
+** Descriptions         :   设置任务的CPU预算。任务从调用时开始拥有完整的预算，原来被降级或暂停的任务立即恢复
+** parameters           :   pxTask 任务
+** parameters           :   uiBudget 每个周期内可以运行的节拍数，为0表示取消预算
+** parameters           :   uiPeriod 补充周期(节拍数)，不小于uiBudget
+** parameters           :   uiExhaustPrio 预算用完后降到的优先级，应低于任务的优先级；
+**                          为TINYOS_BUDGET_THROTTLE表示暂停运行直到预算补充
+** Returned value       :   eErrorNoError，或设置了预算而周期为0、小于预算时返回eErrorResourceUnavaliable
+***********************************************************************************************************/
+uint32_t uiTaskSetBudget (Task_t * pxTask, uint32_t uiBudget, uint32_t uiPeriod, uint32_t uiExhaustPrio)
+{
+	uint32_t uiStatus;
+	
+	// 补充周期是准入分析中的除数，周期内的预算也不能超过周期
+	if(uiBudget && (uiPeriod < uiBudget))
+		return eErrorResourceUnavaliable;
+	
+	uiStatus = uiTaskEnterCritical();
+	
+	if(pxTask->uiBudget && !pxTask->uiBudgetLeft)
+		prvBudgetRestore(pxTask);
+	vBudgetTaskDelete(pxTask);
+	
+	pxTask->uiBudget = uiBudget;
+	pxTask->uiBudgetPeriod = uiPeriod;
+	pxTask->uiBudgetPrio = uiExhaustPrio;
+	pxTask->uiBudgetNormalPrio = pxTask->uiBasePrio;
+	pxTask->uiBudgetLeft = uiBudget;
+	pxTask->cBudgetReplHead = 0;
+	
+	vTaskSched();
+	vTaskExitCritical(uiStatus);
+	return eErrorNoError;
+}
+
+#endif /* TINYOS_ENABLE_BUDGET */
@@ -0,0 +1,71 @@
+#ifndef _TBUDGET_H
+#define _TBUDGET_H
+
+#include <stdint.h>
+#include "tConfig.h"
+#include "tTask.h"
+
+// CPU预算(零星服务器)：设置了预算的任务每运行一个节拍扣除一个节拍的预算，用完后降到指定的优先级，
+// 或者暂停运行，直到预算得到补充。任务连续运行的一段作为一次激活，这一段消耗的预算在激活时刻之后一个周期
+// 补充回来，因此在任意一个周期长度的时间窗口内，任务在原优先级上的运行时间都不超过预算。
+// 降级或暂停运行期间不消耗预算
+
+#if TINYOS_ENABLE_BUDGET
+
+#define TINYOS_BUDGET_THROTTLE                 0xFFFFFFFF              // 预算用完后暂停运行，而不是降低优先级
+
+/**********************************************************************************************************
+** Function name        :   vBudgetInit
+** Descriptions         :   初始化等待补充预算的任务链表
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vBudgetInit (void);
+
+/**********************************************************************************************************
+** Function name        :   uiBudgetCharge
+** Descriptions         :   在节拍中断中调用，为正在运行的任务扣除一个节拍的预算，用完时降级或暂停
+** parameters           :   pxTask 正在运行并且设置了预算的任务
+** Returned value       :   1表示预算在本节拍用完，0表示没有
+***********************************************************************************************************/
+uint32_t uiBudgetCharge (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vBudgetTick
+** Descriptions         :   在节拍中断中调用，补充到期的预算，恢复预算用完的任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vBudgetTick (void);
+
+/**********************************************************************************************************
+** Function name        :   uiBudgetNextTicks
+** Descriptions         :   距离最早一个预算用完的任务得到补充还有多少个节拍
+** parameters           :   无
+** Returned value       :   节拍数，没有预算用完的任务时返回TINYOS_TICKS_NONE
+***********************************************************************************************************/
+uint32_t uiBudgetNextTicks (void);
+
+/**********************************************************************************************************
+** Function name        :   vBudgetTaskDelete
+** Descriptions         :   任务被删除时取消其等待中的预算补充
+** parameters           :   pxTask 被删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vBudgetTaskDelete (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   uiTaskSetBudget
+** Descriptions         :   设置任务的CPU预算。任务从调用时开始拥有完整的预算
+** parameters           :   pxTask 任务
+** parameters           :   uiBudget 每个周期内可以运行的节拍数，为0表示取消预算
+** parameters           :   uiPeriod 补充周期(节拍数)，不小于uiBudget
+** parameters           :   uiExhaustPrio 预算用完后降到的优先级，应低于任务的优先级；
+**                          为TINYOS_BUDGET_THROTTLE表示暂停运行直到预算补充
+** Returned value       :   eErrorNoError，或设置了预算而周期为0、小于预算时返回eErrorResourceUnavaliable
+***********************************************************************************************************/
+uint32_t uiTaskSetBudget (Task_t * pxTask, uint32_t uiBudget, uint32_t uiPeriod, uint32_t uiExhaustPrio);
+
+#endif /* TINYOS_ENABLE_BUDGET */
+
+#endif /* _TBUDGET_H */
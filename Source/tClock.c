@@ -0,0 +1,106 @@
+#include "tinyOS.h"
+
+/****************** 宏/变量定义 ****************************/
+
+// 主机上其它核的线程也会读取，需要内存屏障；Cortex-M3为单核且按顺序执行，volatile访问的顺序即可保证
+#ifdef TINYOS_PORT_LINUX
+#define CLOCK_BARRIER()                __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define CLOCK_BARRIER()
+#endif
+
+// 写入序号为奇数时第0份正在修改，读第1份；为偶数时读第0份
+static volatile uint32_t uiClockSeq;
+static volatile uint64_t ullClockTickCopy[2];
+
+/**********************************************************************************************************
+** Function name        :   vClockInit
+** Descriptions         :   清零64位节拍计数
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vClockInit (void)
+{
+	uiClockSeq = 0;
+	ullClockTickCopy[0] = 0;
+	ullClockTickCopy[1] = 0;
+}
+
+/**********************************************************************************************************
+** Function name        :   vClockTickAdvance
+** Descriptions         :   推进64位节拍计数。只由节拍中断与节拍补偿调用，调用时不能被另一个写入者打断
+** parameters           :   uiTicks 推进的节拍数
+** Returned value       :   无
+***********************************************************************************************************/
+void vClockTickAdvance (uint32_t uiTicks)
+{
+	uint64_t ullTicks = ullClockTickCopy[0] + uiTicks;
+
+	uiClockSeq++;
+	CLOCK_BARRIER();
+	ullClockTickCopy[0] = ullTicks;
+	CLOCK_BARRIER();
+	uiClockSeq++;
+	CLOCK_BARRIER();
+	ullClockTickCopy[1] = ullTicks;
+}
+
+/**********************************************************************************************************
+** Function name        :   ullClockTicks
+** Descriptions         :   读取系统启动以来的64位节拍数，不进入临界区，任务与中断中均可调用
+** parameters           :   无
+** Returned value       :   节拍数
+***********************************************************************************************************/
+uint64_t ullClockTicks (void)
+{
+	uint32_t uiSeq;
+	uint64_t ullTicks;
+
+	do
+	{
+		uiSeq = uiClockSeq;
+		CLOCK_BARRIER();
+		ullTicks = ullClockTickCopy[uiSeq & 1];
+		CLOCK_BARRIER();
+	}while(uiSeq != uiClockSeq);
+
+	return ullTicks;
+}
+
+/**********************************************************************************************************
+** Function name        :   ullClockNow
+** Descriptions         :   读取系统启动以来的单调时间，不进入临界区，任务与中断中均可调用
+** parameters           :   无
+** Returned value       :   纳秒数
+***********************************************************************************************************/
+uint64_t ullClockNow (void)
+{
+	uint32_t uiSeq, uiPhase, uiPending;
+	uint64_t ullTicks;
+
+	// 节拍计数与节拍内的时间在同一次读取中取得，期间节拍中断推进了计数时重读
+	do
+	{
+		uiSeq = uiClockSeq;
+		CLOCK_BARRIER();
+		ullTicks = ullClockTickCopy[uiSeq & 1];
+		uiPhase = uiPortClockPhase(&uiPending);
+		CLOCK_BARRIER();
+	}while(uiSeq != uiClockSeq);
+
+	return (ullTicks + uiPending) * TINYOS_CLOCK_TICK_NS + uiPhase;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiClockNsToTicks
+** Descriptions         :   把以纳秒表示的超时换算为等待函数使用的节拍数，向上取整，超出32位时取最大值。
+**                          ullNs为0时返回0，在等待函数中表示一直等待
+** parameters           :   ullNs 纳秒数
+** Returned value       :   节拍数
+***********************************************************************************************************/
+uint32_t uiClockNsToTicks (uint64_t ullNs)
+{
+	uint64_t ullTicks = (ullNs + TINYOS_CLOCK_TICK_NS - 1) / TINYOS_CLOCK_TICK_NS;
+
+	return ullTicks > 0xFFFFFFFFULL ? 0xFFFFFFFF : (uint32_t)ullTicks;
+}
@@ -0,0 +1,65 @@
+#ifndef _TCLOCK_H
+#define _TCLOCK_H
+
+#include <stdint.h>
+#include "tConfig.h"
+
+// 64位单调时间基准：节拍中断维护64位的节拍计数，读取时加上移植层给出的当前节拍内已经过的时间
+// (Cortex-M3上由SysTick的递减计数得出，主机上由POSIX定时器的剩余时间得出)，得到纳秒分辨率的时间戳。
+// 节拍计数存放两份，写入时交替更新(latch)，读取不进入临界区，被节拍中断打断时重读即可；
+// 比节拍中断优先级高的中断打断写入时读到的是没有在修改的一份。
+// uiTickCount为32位，且在CPU使用率统计开始时清零，需要长时间间隔或低于节拍的分辨率时使用本模块
+
+#define TINYOS_CLOCK_TICK_NS           (TINYOS_ONE_TICK_TO_MS * 1000000ULL)  // 一个节拍的纳秒数
+
+/**********************************************************************************************************
+** Function name        :   vClockInit
+** Descriptions         :   清零64位节拍计数
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vClockInit (void);
+
+/**********************************************************************************************************
+** Function name        :   vClockTickAdvance
+** Descriptions         :   推进64位节拍计数。只由节拍中断与节拍补偿调用，调用时不能被另一个写入者打断
+** parameters           :   uiTicks 推进的节拍数
+** Returned value       :   无
+***********************************************************************************************************/
+void vClockTickAdvance (uint32_t uiTicks);
+
+/**********************************************************************************************************
+** Function name        :   ullClockTicks
+** Descriptions         :   读取系统启动以来的64位节拍数，不进入临界区，任务与中断中均可调用
+** parameters           :   无
+** Returned value       :   节拍数
+***********************************************************************************************************/
+uint64_t ullClockTicks (void);
+
+/**********************************************************************************************************
+** Function name        :   ullClockNow
+** Descriptions         :   读取系统启动以来的单调时间，不进入临界区，任务与中断中均可调用
+** parameters           :   无
+** Returned value       :   纳秒数
+***********************************************************************************************************/
+uint64_t ullClockNow (void);
+
+/**********************************************************************************************************
+** Function name        :   uiClockNsToTicks
+** Descriptions         :   把以纳秒表示的超时换算为等待函数使用的节拍数，向上取整，超出32位时取最大值。
+**                          ullNs为0时返回0，在等待函数中表示一直等待
+** parameters           :   ullNs 纳秒数
+** Returned value       :   节拍数
+***********************************************************************************************************/
+uint32_t uiClockNsToTicks (uint64_t ullNs);
+
+/**********************************************************************************************************
+** Function name        :   uiPortClockPhase
+** Descriptions         :   由移植层实现，当前节拍内已经过的纳秒数。节拍边界已经越过而节拍中断还没有处理时，
+**                          *puiPending置1，返回值从新的节拍开始计算
+** parameters           :   puiPending 存放是否有未处理的节拍
+** Returned value       :   纳秒数，小于TINYOS_CLOCK_TICK_NS
+***********************************************************************************************************/
+uint32_t uiPortClockPhase (uint32_t * puiPending);
+
+#endif /* _TCLOCK_H */
@@ -1,11 +1,129 @@
-#ifndef _TCONFIG_H
-#define _TCONFIG_H
-
-#define	TINYOS_PRO_COUNT				       32						// TinyOS任务的优先级序号
-#define TINYOS_ONE_TICK_TO_MS                  1
-#define TINYOS_SLICE_MAX				       5						// 每个任务最大运行的时间片计数
-#define TINYOS_STACK_SIZE                      1024
-#define TINYOS_IDLETASK_STACK_SIZE             1024
-#define pdMS_TO_TICKS(xTimeInMs) ( ( uint32_t ) ( ( uint32_t ) ( xTimeInMs ) / (TINYOS_ONE_TICK_TO_MS ))  )
-#define TINYOS_TIMERTASK_PRIO           1                       // 定时器任务的优先级
-#endif
+#ifndef _TCONFIG_H
+#define _TCONFIG_H
+
+#define	TINYOS_PRO_COUNT				       32						// TinyOS任务的优先级数量，最多1024
+#define TINYOS_ONE_TICK_TO_MS                  1
+#define TINYOS_SLICE_MAX				       5						// 任务创建时默认的时间片长度，可用vTaskSetSlice单独设置
+
+// 由堆栈剖析生成的堆栈大小(见tStackProfile.h)，其中定义的大小优先于下面的默认值
+#ifdef TINYOS_STACK_SIZE_FILE
+#include TINYOS_STACK_SIZE_FILE
+#endif
+#ifndef TINYOS_STACK_SIZE
+#define TINYOS_STACK_SIZE                      1024                     // 定时器任务的堆栈大小(字)
+#endif
+#ifndef TINYOS_IDLETASK_STACK_SIZE
+#define TINYOS_IDLETASK_STACK_SIZE             1024
+#endif
+#ifndef TINYOS_ISR_STACK_SIZE
+#define TINYOS_ISR_STACK_SIZE                  0x400                    // 中断使用的主堆栈大小(字节)，与启动文件中的Stack_Size一致
+#endif
+
+// 堆栈延迟填充：创建任务时只写入间隔分布的哨兵字，其余部分由空闲任务逐段填充，缩短任务创建的时间
+// 为0时创建任务时填充整个堆栈
+#ifndef TINYOS_STACK_LAZY_FILL
+#define TINYOS_STACK_LAZY_FILL                 1
+#endif
+#define TINYOS_STACK_SENTINEL_WORDS            64                       // 哨兵的间隔(字)，也是空闲任务每次填充的长度
+#define TINYOS_STACK_PAINT                     0xA5A5A5A5u              // 哨兵与未用堆栈的填充图案，比0更不容易与任务写入的数据相同
+
+// 堆栈监视：空闲任务在后台逐段检查各任务的堆栈，缓存最少剩余量，vTaskGetInfo直接读取缓存的结果
+#define TINYOS_STACK_MONITOR_WORDS             32                       // 空闲任务每次最多检查的堆栈字数，决定了关中断的时长
+#define pdMS_TO_TICKS(xTimeInMs) ( ( uint32_t ) ( ( uint32_t ) ( xTimeInMs ) / (TINYOS_ONE_TICK_TO_MS ))  )
+#define TINYOS_TIMERTASK_PRIO           1                       // 定时器任务的优先级
+
+// 对称多处理(SMP)：每个核有自己的当前任务与就绪表，内核数据由自旋锁保护，任务由负载均衡在核之间迁移
+#ifndef TINYOS_ENABLE_SMP
+#define TINYOS_ENABLE_SMP                      0
+#endif
+#ifndef TINYOS_CORE_COUNT
+#define TINYOS_CORE_COUNT                      2                        // SMP时最多使用的核数，实际运行的核数由移植层决定
+#endif
+#define TINYOS_SMP_BALANCE_TICKS               10                       // 负载均衡的间隔(节拍数)
+
+// 最早截止期优先(EDF)调度：占用一个优先级，该优先级内设置了截止期的任务按绝对截止期排序，其它优先级不受影响
+// 默认关闭，需要时显式打开。EDF就绪堆只有一份，SMP时不可用
+#ifndef TINYOS_ENABLE_EDF
+#define TINYOS_ENABLE_EDF                      0
+#endif
+#if TINYOS_ENABLE_SMP
+#undef TINYOS_ENABLE_EDF
+#define TINYOS_ENABLE_EDF                      0
+#endif
+#define TINYOS_EDF_PRIO                        16                       // EDF任务所在的优先级
+#define TINYOS_EDF_MAX_TASKS                   16                       // 同时处于EDF优先级的任务数量上限
+
+// 延时与超时等待使用分层时间轮：插入、删除为O(1)，每个节拍只处理一个槽，上层的槽在下层转完一圈时才下移
+// 为0时使用按到期时间排序、存放差值的延时队列，插入需要遍历队列，但少用每层一组链表头的RAM。
+// 软硬定时器总是各用一个时间轮
+#ifndef TINYOS_ENABLE_DELAY_WHEEL
+#define TINYOS_ENABLE_DELAY_WHEEL              1
+#endif
+#define TINYOS_WHEEL_BITS                      4                        // 每层2^n个槽(1~5)，层数为32/n向上取整
+
+// 优先级继承沿互斥量阻塞链传递的最大深度，防止链过长时在临界区内停留过久
+#define TINYOS_MUTEX_CHAIN_MAX                 8
+
+// CPU预算(零星服务器)：限制任务在每个周期内以原优先级运行的节拍数。默认关闭，打开后就绪表操作与每个节拍都有额外开销
+// 预算补充链表只有一份，并且暂停其它核上正在运行的任务需要核间协调，SMP时不可用
+#ifndef TINYOS_ENABLE_BUDGET
+#define TINYOS_ENABLE_BUDGET                   0
+#endif
+#if TINYOS_ENABLE_SMP
+#undef TINYOS_ENABLE_BUDGET
+#define TINYOS_ENABLE_BUDGET                   0
+#endif
+#define TINYOS_BUDGET_REPL_MAX                 4                        // 每个任务最多同时等待的预算补充项数
+
+// 可调度性准入控制：用uiTaskInitTimed声明周期、WCET与截止期的任务在创建前做响应时间分析。
+// 默认关闭，打开后每次调度都要累计执行时间，并启用移植层的时间戳计数器
+// 分析的是单核上的任务集，SMP时不可用
+#ifndef TINYOS_ENABLE_ADMISSION
+#define TINYOS_ENABLE_ADMISSION                0
+#endif
+#if TINYOS_ENABLE_SMP
+#undef TINYOS_ENABLE_ADMISSION
+#define TINYOS_ENABLE_ADMISSION                0
+#endif
+#define TINYOS_ADMISSION_MAX_TASKS             16                       // 声明过的任务数量上限
+#define TINYOS_ADMISSION_REJECT                1                        // 1: 不可调度时拒绝创建；0: 照常创建，只通过返回值警告
+
+// 低功耗空闲(tickless)：空闲任务停止周期节拍，按最早到期的任务、定时器或预算补充设置一次性唤醒后休眠，
+// 醒来后一次补偿经过的节拍。节拍由核0统一处理，SMP时不可用
+#if TINYOS_ENABLE_SMP
+#undef TINYOS_ENABLE_TICKLESS
+#define TINYOS_ENABLE_TICKLESS                 0
+#elif !defined(TINYOS_ENABLE_TICKLESS)
+#define TINYOS_ENABLE_TICKLESS                 0
+#endif
+#define TINYOS_TICKLESS_MIN_TICKS              2                        // 预计空闲不少于该节拍数时才停止节拍
+
+// 空闲状态调节器：按预测的空闲时长在移植层提供的多个睡眠状态中选择，需要打开TINYOS_ENABLE_TICKLESS
+#if !TINYOS_ENABLE_TICKLESS
+#undef TINYOS_ENABLE_IDLE_GOVERNOR
+#define TINYOS_ENABLE_IDLE_GOVERNOR            0
+#elif !defined(TINYOS_ENABLE_IDLE_GOVERNOR)
+#define TINYOS_ENABLE_IDLE_GOVERNOR            0
+#endif
+#define TINYOS_POWER_HISTORY                   8                        // 用于预测的最近空闲时长的个数
+#define TINYOS_POWER_STATES_MAX                4                        // 统计的睡眠状态数量上限
+
+// 调度事件跟踪，关闭时所有跟踪点被编译为空
+#ifndef TINYOS_ENABLE_TRACE
+#define TINYOS_ENABLE_TRACE                    0
+#endif
+#define TINYOS_TRACE_BUFFER_SIZE               512                      // 跟踪环形缓冲区的事件数量，必须为2的幂
+
+// 临界区时长测量，关闭时uiTaskEnterCritical/vTaskExitCritical不受影响
+#ifndef TINYOS_ENABLE_CRITICAL_PROFILE
+#define TINYOS_ENABLE_CRITICAL_PROFILE         0
+#endif
+#define TINYOS_CRITICAL_PROFILE_SITES          64                       // 最多统计的临界区调用点数量
+
+// 堆栈剖析：记录任务与中断的堆栈峰值，生成推荐堆栈大小的头文件
+#ifndef TINYOS_ENABLE_STACK_PROFILE
+#define TINYOS_ENABLE_STACK_PROFILE            0
+#endif
+#define TINYOS_STACK_PROFILE_TASKS             32                       // 最多登记的任务数量
+#define TINYOS_STACK_PROFILE_MARGIN            25                       // 推荐值在峰值之上留出的余量(%)
+#endif
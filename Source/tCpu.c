@@ -1,156 +1,415 @@
-#include "tinyOS.h"
-
-extern void vTaskSystemTickHandler(void);
-extern uint32_t uiTickCount; 
-
-// 空闲任务计数与最大计数
-uint32_t uiIdleCount;
-uint32_t uiIdleMaxCount;
-Task_t xIdleTask;
-TaskStack_t xTaskIdleEnv[TINYOS_IDLETASK_STACK_SIZE];
-
-static float fCpuUsage;                      // cpu使用率统计
-static uint32_t uiEnableCpuUsageStat;         // 是否使能cpu统计
-static void prvTaskIdleEntry (void * param);
-static void prvCpuUsageSyncWithSysTick (void);
-/**********************************************************************************************************
-** Function name        :   SysTick_Handler
-** Descriptions         :   SystemTick的中断处理函数。
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void SysTick_Handler(void)
-{
-	vTaskSystemTickHandler();
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vSetSysTickPeriod
-** Descriptions         :   设置定时器中断触发的间隔
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vSetSysTickPeriod(uint32_t ms)
-{
-	SysTick->LOAD = ms * SystemCoreClock / 1000 - 1;
-	NVIC_SetPriority(SysTick_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
-	SysTick->VAL   = 0;
-	/* 使用内部时钟源，使能中断，使能定时器 */
-	SysTick->CTRL  = SysTick_CTRL_CLKSOURCE_Msk |
-					 SysTick_CTRL_TICKINT_Msk   |
-					 SysTick_CTRL_ENABLE_Msk;
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vInitCpuUsageStat
-** Descriptions         :   初始化cpu统计
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vInitCpuUsageStat(void)
-{
-	uiIdleCount = 0;
-	uiIdleMaxCount = 0;
-	fCpuUsage = 0;
-	uiEnableCpuUsageStat = 0;
-}
-
-/**********************************************************************************************************
-** Function name        :   vIdleTaskInit
-** Descriptions         :   初始化空闲任务
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vIdleTaskInit(void)
-{
-	vTaskInit(&xIdleTask, prvTaskIdleEntry, (void *)0xffffffff, TINYOS_PRO_COUNT - 1, xTaskIdleEnv, sizeof(xTaskIdleEnv));
-}
-
-/**********************************************************************************************************
-** Function name        :   fGetCpuUsage
-** Descriptions         :   获取CPU利用率
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-float fGetCpuUsage(void)
-{
-	return fCpuUsage;
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vCheckCpuUsage
-** Descriptions         :   检查cpu使用率
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vCheckCpuUsage(void)
-{
-	if(!uiEnableCpuUsageStat)
-	{
-		uiEnableCpuUsageStat = 1;
-		uiTickCount = 0;
-		return;
-	}
-	
-	if(uiTickCount == TICKS_PER_SEC)
-	{
-		// 统计最初1s内的最大计数值
-		uiIdleMaxCount = uiIdleCount;
-		uiIdleCount = 0;
-		
-		// 计数完毕，开启调度器，允许切换到其它任务
-		vTaskSchedEnable();
-	}
-	else if(uiTickCount % TICKS_PER_SEC == 0)
-	{
-		// 之后每隔1s统计一次，同时计算cpu利用率
-		fCpuUsage = 100 - (uiIdleCount * 100.0 / uiIdleMaxCount);
-		uiIdleCount = 0;
-	}
-}
-
-/**********************************************************************************************************
-** Function name        :   prvCpuUsageSyncWithSysTick
-** Descriptions         :   为检查cpu使用率与系统时钟节拍同步
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-static void prvCpuUsageSyncWithSysTick (void)
-{
-    // 等待与时钟节拍同步
-    while (uiEnableCpuUsageStat == 0)
-    {
-        ;;
-    }
-}
-
-static void prvTaskIdleEntry(void *pvParam)
-{
-	// 禁止调度，防止后面在创建任务时切换到其它任务中去
-    vTaskSchedDisable();
-	
-	// 初始化App相关配置
-    vAppInit();
-
-    // 初始化定时器任务
-    vTimerInitTask();
-	
-	// 启动系统时钟节拍
-	vSetSysTickPeriod(TINYOS_ONE_TICK_TO_MS);
-	
-	// 等待与时钟同步
-    prvCpuUsageSyncWithSysTick();
-	for(;;)
-	{
-		uint32_t uiStatus = uiTaskEnterCritical();
-		uiIdleCount++;
-		vTaskExitCritical(uiStatus);
-	}
-}
-
-
-
-
+#include "tinyOS.h"
+
+extern void vTaskSystemTickHandler(void);
+extern uint32_t uiTickCount; 
+
+// 空闲任务计数与最大计数
+uint32_t uiIdleCount;
+uint32_t uiIdleMaxCount;
+Task_t xIdleTask;
+TaskStack_t xTaskIdleEnv[TINYOS_IDLETASK_STACK_SIZE];
+
+#if TINYOS_ENABLE_SMP
+// 其它核的空闲任务，只在本核没有就绪任务时运行，不参与CPU使用率统计
+static Task_t xCoreIdleTask[TINYOS_CORE_COUNT - 1];
+static TaskStack_t xCoreIdleEnv[TINYOS_CORE_COUNT - 1][TINYOS_IDLETASK_STACK_SIZE];
+static void prvCoreIdleEntry (void * pvParam);
+#endif
+
+static float fCpuUsage;                      // cpu使用率统计
+static volatile uint32_t uiEnableCpuUsageStat;  // 是否使能cpu统计，由时钟节拍中断置位
+static void prvTaskIdleEntry (void * param);
+static void prvCpuUsageSyncWithSysTick (void);
+#if TINYOS_ENABLE_TICKLESS && !TINYOS_ENABLE_IDLE_GOVERNOR
+static uint32_t prvCpuTicklessIdle (void);
+#endif
+#if TINYOS_ENABLE_TICKLESS
+#ifndef TINYOS_PORT_LINUX
+static uint32_t uiCpuCyclesPerTick;          // 一个节拍的SysTick计数值
+static uint32_t uiCpuSleptCycles;            // 最近一次停止节拍休眠的SysTick计数
+#endif
+#endif
+/**********************************************************************************************************
+** Function name        :   SysTick_Handler
+** Descriptions         :   SystemTick的中断处理函数。
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void SysTick_Handler(void)
+{
+	// 最先推进64位时间基准，中断中读取的时间戳不会因为挂起标志已清除而回退
+	vClockTickAdvance(1);
+	TRACE_ISR_ENTER(TINYOS_TRACE_IRQ_TICK);
+	vTaskSystemTickHandler();
+	TRACE_ISR_EXIT(TINYOS_TRACE_IRQ_TICK);
+}
+
+
+// 主机移植下由tPortLinux.c中的POSIX定时器实现
+#ifndef TINYOS_PORT_LINUX
+/**********************************************************************************************************
+** Function name        :   vSetSysTickPeriod
+** Descriptions         :   设置定时器中断触发的间隔
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vSetSysTickPeriod(uint32_t ms)
+{
+#if TINYOS_ENABLE_TICKLESS
+	uiCpuCyclesPerTick = ms * SystemCoreClock / 1000;
+#endif
+	SysTick->LOAD = ms * SystemCoreClock / 1000 - 1;
+	NVIC_SetPriority(SysTick_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+	SysTick->VAL   = 0;
+	/* 使用内部时钟源，使能中断，使能定时器 */
+	SysTick->CTRL  = SysTick_CTRL_CLKSOURCE_Msk |
+					 SysTick_CTRL_TICKINT_Msk   |
+					 SysTick_CTRL_ENABLE_Msk;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortClockPhase
+** Descriptions         :   由SysTick的递减计数得出当前节拍内已经过的纳秒数。计数已经重装载而中断还挂起时，
+**                          重读一次计数，保证返回值从新的节拍开始计算
+** parameters           :   puiPending 存放是否有未处理的节拍
+** Returned value       :   纳秒数
+***********************************************************************************************************/
+uint32_t uiPortClockPhase(uint32_t * puiPending)
+{
+	uint32_t uiMhz = SystemCoreClock / 1000000;
+	uint32_t uiCycles, uiVal = SysTick->VAL;
+
+	*puiPending = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) ? 1 : 0;
+	if(*puiPending)
+		uiVal = SysTick->VAL;
+
+	// 低功耗空闲重新对齐节拍时，LOAD已恢复为一个节拍，VAL仍是到下一个节拍边界的计数
+	uiCycles = SysTick->LOAD + 1 - uiVal;
+	return uiCycles / uiMhz * 1000 + uiCycles % uiMhz * 1000 / uiMhz;
+}
+
+#if TINYOS_ENABLE_TICKLESS
+/**********************************************************************************************************
+** Function name        :   uiPortTicklessSleep
+** Descriptions         :   停止周期节拍，把SysTick设置为uiTicks个节拍后到期的一次性定时，用WFI休眠。
+**                          调用时PRIMASK已置位，中断可以唤醒WFI，但要等退出临界区后才执行
+** parameters           :   uiTicks 到下一个有工作到期的节拍为止的节拍数
+** Returned value       :   需要由内核一次补偿的节拍数，不包括挂起的最后一个节拍
+***********************************************************************************************************/
+uint32_t uiPortTicklessSleep(uint32_t uiTicks)
+{
+	uint32_t uiMaxTicks = SysTick_LOAD_RELOAD_Msk / uiCpuCyclesPerTick;
+	uint32_t uiFirst, uiReload, uiCtrl, uiUsed, uiElapsed;
+
+	// 24位的重装载值限制了一次休眠的长度
+	if(uiTicks > uiMaxTicks)
+		uiTicks = uiMaxTicks;
+
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+	// 停止前节拍已经到期，中断挂起着，不再休眠
+	if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		return 0;
+	}
+
+	// 当前节拍剩余的计数，加上之后的uiTicks - 1个节拍
+	uiFirst = SysTick->VAL ? SysTick->VAL : uiCpuCyclesPerTick;
+	uiReload = uiFirst + (uiTicks - 1) * uiCpuCyclesPerTick;
+	SysTick->LOAD = uiReload - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+	__DSB();
+	__WFI();
+	__ISB();
+
+	// 读CTRL会清除COUNTFLAG，只读一次
+	uiCtrl = SysTick->CTRL;
+	SysTick->CTRL = uiCtrl & ~SysTick_CTRL_ENABLE_Msk;
+	if(uiCtrl & SysTick_CTRL_COUNTFLAG_Msk)
+	{
+		// 一次性定时到期，中断保持挂起，由它处理最后一个节拍，从现在开始下一个完整的节拍
+		uiElapsed = uiTicks - 1;
+		uiCpuSleptCycles = uiReload;
+		SysTick->LOAD = uiCpuCyclesPerTick - 1;
+	}
+	else
+	{
+		// 被其它中断提前唤醒，统计已经越过的节拍边界，下一次中断对齐到原来的节拍边界
+		uiUsed = uiReload - SysTick->VAL;
+		uiElapsed = uiUsed >= uiFirst ? 1 + (uiUsed - uiFirst) / uiCpuCyclesPerTick : 0;
+		uiCpuSleptCycles = uiUsed;
+		SysTick->LOAD = uiFirst + uiElapsed * uiCpuCyclesPerTick - uiUsed - 1;
+	}
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+	// 重装载后恢复周期节拍
+	SysTick->LOAD = uiCpuCyclesPerTick - 1;
+	return uiElapsed;
+}
+#endif
+
+#if TINYOS_ENABLE_IDLE_GOVERNOR
+// Cortex-M3的睡眠状态。SLEEPDEEP会停止SysTick，需要另外的低功耗定时器唤醒，这里不使用
+// 功耗按STM32F103在72MHz下的数据手册估计，每次唤醒的能耗主要是中断处理，换用其它芯片时按实际数据修改
+static const IdleState_t xCpuIdleStates[] = {
+	{"wfi",          1,    0, 46000, 600, 0},
+	{"wfi-tickless", 5, 2000, 46000, 900, 1},
+};
+
+/**********************************************************************************************************
+** Function name        :   pxPortIdleStates
+** Descriptions         :   返回睡眠状态表
+** parameters           :   puiCount 存放状态数量
+** Returned value       :   状态表
+***********************************************************************************************************/
+const IdleState_t * pxPortIdleStates (uint32_t * puiCount)
+{
+	*puiCount = sizeof(xCpuIdleStates) / sizeof(xCpuIdleStates[0]);
+	return xCpuIdleStates;
+}
+
+/**********************************************************************************************************
+** Function name        :   vPortIdleEnter
+** Descriptions         :   进入睡眠状态。停留时间由SysTick的计数得出，DWT周期计数器在睡眠时不一定计数
+** parameters           :   uiState 状态序号
+** parameters           :   uiTicks 到下一个有工作到期的节拍为止的节拍数
+** parameters           :   pxResult 存放结果
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortIdleEnter (uint32_t uiState, uint32_t uiTicks, IdleResult_t * pxResult)
+{
+	uint32_t uiStart, uiEnd;
+
+	if(xCpuIdleStates[uiState].cStopTick)
+	{
+		uiCpuSleptCycles = 0;
+		pxResult->uiElapsedTicks = uiPortTicklessSleep(uiTicks);
+	}
+	else
+	{
+		// PRIMASK置位时中断仍能唤醒WFI
+		uiStart = SysTick->VAL;
+		__DSB();
+		__WFI();
+		__ISB();
+		uiEnd = SysTick->VAL;
+
+		// SysTick向下计数，中间经过一次重装载时节拍中断挂起
+		uiCpuSleptCycles = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) ? uiStart + uiCpuCyclesPerTick - uiEnd : uiStart - uiEnd;
+		pxResult->uiElapsedTicks = 0;
+	}
+	pxResult->uiResidencyUs = uiCpuSleptCycles / (SystemCoreClock / 1000000);
+	pxResult->cTimerWake = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) ? 1 : 0;
+}
+#endif
+#endif
+
+
+/**********************************************************************************************************
+** Function name        :   vInitCpuUsageStat
+** Descriptions         :   初始化cpu统计
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vInitCpuUsageStat(void)
+{
+	uiIdleCount = 0;
+	uiIdleMaxCount = 0;
+	fCpuUsage = 0;
+	uiEnableCpuUsageStat = 0;
+}
+
+/**********************************************************************************************************
+** Function name        :   vIdleTaskInit
+** Descriptions         :   初始化空闲任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vIdleTaskInit(void)
+{
+	vTaskInit(&xIdleTask, prvTaskIdleEntry, (void *)0xffffffff, TINYOS_PRO_COUNT - 1, xTaskIdleEnv, sizeof(xTaskIdleEnv));
+	STACK_PROFILE_ADD(&xIdleTask, "TINYOS_IDLETASK_STACK_SIZE");
+#if TINYOS_ENABLE_IDLE_GOVERNOR
+	vPowerInit();
+#endif
+#if TINYOS_ENABLE_SMP
+	{
+		// 每个核都必须有一个空闲任务，保证就绪表不为空
+		uint32_t i;
+		vTaskSetAffinity(&xIdleTask, 0);
+		for(i = 1; i < uiPortCoreCount(); i++)
+		{
+			vTaskInit(&xCoreIdleTask[i - 1], prvCoreIdleEntry, (void *)0xffffffff, TINYOS_PRO_COUNT - 1,
+				xCoreIdleEnv[i - 1], sizeof(xCoreIdleEnv[i - 1]));
+			vTaskSetAffinity(&xCoreIdleTask[i - 1], i);
+			STACK_PROFILE_ADD(&xCoreIdleTask[i - 1], "TINYOS_IDLETASK_STACK_SIZE");
+		}
+	}
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   fGetCpuUsage
+** Descriptions         :   获取CPU利用率
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+float fGetCpuUsage(void)
+{
+	return fCpuUsage;
+}
+
+
+/**********************************************************************************************************
+** Function name        :   vCheckCpuUsage
+** Descriptions         :   检查cpu使用率
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vCheckCpuUsage(void)
+{
+	if(!uiEnableCpuUsageStat)
+	{
+		uiEnableCpuUsageStat = 1;
+		uiTickCount = 0;
+		return;
+	}
+	
+	if(uiTickCount == TICKS_PER_SEC)
+	{
+		// 统计最初1s内的最大计数值
+		uiIdleMaxCount = uiIdleCount;
+		uiIdleCount = 0;
+		
+		// 计数完毕，开启调度器，允许切换到其它任务
+		vTaskSchedEnable();
+	}
+	else if(uiTickCount % TICKS_PER_SEC == 0)
+	{
+		// 之后每隔1s统计一次，同时计算cpu利用率。休眠时按时间折算的计数可能略多于最大值
+		fCpuUsage = uiIdleCount < uiIdleMaxCount ? 100 - (uiIdleCount * 100.0 / uiIdleMaxCount) : 0;
+		uiIdleCount = 0;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvCpuUsageSyncWithSysTick
+** Descriptions         :   为检查cpu使用率与系统时钟节拍同步
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvCpuUsageSyncWithSysTick (void)
+{
+    // 等待与时钟节拍同步
+    while (uiEnableCpuUsageStat == 0)
+    {
+		// 等待期间先为启动时创建的任务清零堆栈
+		vTaskStackMonitorStep();
+#if TINYOS_SIM_VIRTUAL_TIME
+		vPortSimIdle();
+#endif
+    }
+}
+
+static void prvTaskIdleEntry(void *pvParam)
+{
+	// 禁止调度，防止后面在创建任务时切换到其它任务中去
+    vTaskSchedDisable();
+	
+	// 初始化App相关配置
+    vAppInit();
+
+    // 初始化定时器任务
+    vTimerInitTask();
+	
+	// 启动系统时钟节拍
+	vSetSysTickPeriod(TINYOS_ONE_TICK_TO_MS);
+	
+	// 等待与时钟同步
+    prvCpuUsageSyncWithSysTick();
+	for(;;)
+	{
+		uint32_t uiStatus = uiTaskEnterCritical();
+		uiIdleCount++;
+		vTaskExitCritical(uiStatus);
+		
+		vTaskStackMonitorStep();
+		
+#if TINYOS_ENABLE_IDLE_GOVERNOR
+		// 最初1s用于统计空闲计数的最大值，之后由调节器选择睡眠状态
+		if(uiIdleMaxCount)
+		{
+			vPowerIdle();
+			continue;
+		}
+#elif TINYOS_ENABLE_TICKLESS
+		// 最初1s用于统计空闲计数的最大值，之后才停止节拍休眠
+		if(uiIdleMaxCount && prvCpuTicklessIdle())
+			continue;
+#endif
+#if TINYOS_SIM_VIRTUAL_TIME
+		// 虚拟时间仿真：没有其它任务可运行，直接推进到下一个到期的节拍
+		vPortSimIdle();
+#endif
+	}
+}
+
+#if TINYOS_ENABLE_TICKLESS && !TINYOS_ENABLE_IDLE_GOVERNOR
+/**********************************************************************************************************
+** Function name        :   prvCpuTicklessIdle
+** Descriptions         :   空闲期足够长时停止节拍休眠，醒来后一次补偿经过的节拍，最后一个节拍由挂起的节拍中断处理。
+**                          实际休眠的时间按统计出的每秒空闲计数折算后计入空闲计数，CPU使用率仍然有效
+** parameters           :   无
+** Returned value       :   1表示休眠过，0表示空闲期太短，没有休眠
+***********************************************************************************************************/
+static uint32_t prvCpuTicklessIdle (void)
+{
+	uint32_t uiTicks, uiLimit, uiElapsed;
+	uint64_t ullStart;
+	uint32_t uiStatus = uiTaskEnterCritical();
+
+	uiTicks = uiTaskNextWakeTicks();
+	uiLimit = uiTimerModuleNextExpireTicks();
+	if(uiLimit < uiTicks)
+		uiTicks = uiLimit;
+
+	// 整秒处仍执行节拍处理，以保证CPU使用率统计正常进行
+	uiLimit = TICKS_PER_SEC - uiTickCount % TICKS_PER_SEC;
+	if(uiLimit < uiTicks)
+		uiTicks = uiLimit;
+
+	if(uiTicks < TINYOS_TICKLESS_MIN_TICKS)
+	{
+		vTaskExitCritical(uiStatus);
+		return 0;
+	}
+
+	ullStart = ullClockNow();
+	uiElapsed = uiPortTicklessSleep(uiTicks);
+	if(uiElapsed)
+		vTaskSystemTickSkip(uiElapsed);
+
+	// 按时钟计算实际休眠的时间：定时唤醒时包括挂起的最后一个节拍，被其它中断提前唤醒时只到唤醒的时刻为止，
+	// 不把没有休眠的部分节拍计为空闲
+	uiIdleCount += (uint32_t)((ullClockNow() - ullStart) * uiIdleMaxCount / (TICKS_PER_SEC * TINYOS_CLOCK_TICK_NS));
+
+	// 退出时处理挂起的节拍中断
+	vTaskExitCritical(uiStatus);
+	return 1;
+}
+#endif
+
+#if TINYOS_ENABLE_SMP
+static void prvCoreIdleEntry (void * pvParam)
+{
+	for(;;)
+	{
+		// 等待核间中断或节拍中断
+		vPortCoreIdle();
+	}
+}
+#endif
@@ -0,0 +1,194 @@
+#define TINYOS_CRITICAL_PROFILE_IMPL
+#include "tinyOS.h"
+
+#if TINYOS_ENABLE_CRITICAL_PROFILE
+
+#ifdef TINYOS_PORT_LINUX
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+/****************** 宏/变量定义 ****************************/
+
+static CriticalSite_t xCriticalSites[TINYOS_CRITICAL_PROFILE_SITES];
+static uint32_t uiCriticalSiteCnt;
+static uint32_t uiCriticalDropped;              // 调用点表已满而未能统计的次数
+
+// 当前最外层临界区的起始信息。屏蔽中断期间不会有其它临界区开始，所以只需要一份
+// 计时用移植层的周期计数器而不是ullClockNow()：只取两次读数的差，32位在临界区的长度内不会回绕，
+// 读取只需一条指令，不会把时钟读取本身的开销算进被测的临界区
+static const char * pcCriticalFunc;
+static uint32_t uiCriticalLine;
+static uint32_t uiCriticalStart;
+
+#ifdef TINYOS_PORT_LINUX
+static void prvCriticalProfileAtExit (void);
+#endif
+
+/**********************************************************************************************************
+** Function name        :   prvCriticalSiteFind
+** Descriptions         :   查找调用点，不存在时新增
+** parameters           :   pcFunc 函数名
+** parameters           :   uiLine 行号
+** Returned value       :   调用点，表满时返回0
+***********************************************************************************************************/
+static CriticalSite_t * prvCriticalSiteFind (const char * pcFunc, uint32_t uiLine)
+{
+	uint32_t i;
+
+	for(i = 0; i < uiCriticalSiteCnt; i++)
+	{
+		if(xCriticalSites[i].uiLine == uiLine && xCriticalSites[i].pcFunc == pcFunc)
+			return &xCriticalSites[i];
+	}
+
+	if(uiCriticalSiteCnt == TINYOS_CRITICAL_PROFILE_SITES)
+		return (CriticalSite_t *)0;
+
+	xCriticalSites[uiCriticalSiteCnt].pcFunc = pcFunc;
+	xCriticalSites[uiCriticalSiteCnt].uiLine = uiLine;
+	return &xCriticalSites[uiCriticalSiteCnt++];
+}
+
+/**********************************************************************************************************
+** Function name        :   vCriticalProfileInit
+** Descriptions         :   清空统计结果并启动时间戳计数器
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vCriticalProfileInit (void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+
+	uiCriticalSiteCnt = 0;
+	uiCriticalDropped = 0;
+	vPortTimestampInit();
+
+#ifdef TINYOS_PORT_LINUX
+	// 进程退出时输出报告，TINYOS_CRITICAL_TOP指定输出的数量
+	atexit(prvCriticalProfileAtExit);
+#endif
+
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiCriticalProfileEnter
+** Descriptions         :   进入临界区，如果是最外层则开始计时
+** parameters           :   pcFunc 调用者所在的函数
+** parameters           :   uiLine 调用者所在的行号
+** Returned value       :   进入临界区之前的中断状态值
+***********************************************************************************************************/
+uint32_t uiCriticalProfileEnter (const char * pcFunc, uint32_t uiLine)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+
+	if(!uiStatus)
+	{
+		pcCriticalFunc = pcFunc;
+		uiCriticalLine = uiLine;
+		uiCriticalStart = uiPortTimestamp();
+	}
+	return uiStatus;
+}
+
+/**********************************************************************************************************
+** Function name        :   vCriticalProfileExit
+** Descriptions         :   退出临界区，如果是最外层则结束计时并计入调用点的统计
+**                          计时在恢复中断之前结束，统计本身的开销不计入
+** parameters           :   uiStatus 进入临界区之前的中断状态值
+** Returned value       :   无
+***********************************************************************************************************/
+void vCriticalProfileExit (uint32_t uiStatus)
+{
+	if(!uiStatus)
+	{
+		uint32_t uiDuration = uiPortTimestamp() - uiCriticalStart;
+		CriticalSite_t * pxSite = prvCriticalSiteFind(pcCriticalFunc, uiCriticalLine);
+
+		if(pxSite)
+		{
+			pxSite->uiCount++;
+			pxSite->ullTotal += uiDuration;
+			if(uiDuration > pxSite->uiMax)
+				pxSite->uiMax = uiDuration;
+		}
+		else
+		{
+			uiCriticalDropped++;
+		}
+	}
+
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiCriticalProfileTop
+** Descriptions         :   按最长时长从大到小取出前若干个调用点的统计
+** parameters           :   pxSites 存放结果的数组
+** parameters           :   uiMax 数组大小
+** Returned value       :   实际取出的调用点数量
+***********************************************************************************************************/
+uint32_t uiCriticalProfileTop (CriticalSite_t * pxSites, uint32_t uiMax)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	uint32_t uiCnt = 0;
+	uint32_t i, j;
+
+	// 插入排序，调用点数量很少
+	for(i = 0; i < uiCriticalSiteCnt; i++)
+	{
+		for(j = uiCnt; j > 0 && pxSites[j - 1].uiMax < xCriticalSites[i].uiMax; j--)
+		{
+			if(j < uiMax)
+				pxSites[j] = pxSites[j - 1];
+		}
+		if(j < uiMax)
+		{
+			pxSites[j] = xCriticalSites[i];
+			if(uiCnt < uiMax)
+				uiCnt++;
+		}
+	}
+
+	vTaskExitCritical(uiStatus);
+	return uiCnt;
+}
+
+#ifdef TINYOS_PORT_LINUX
+/**********************************************************************************************************
+** Function name        :   vCriticalProfilePrint
+** Descriptions         :   输出最长的若干个临界区
+** parameters           :   uiTopN 输出的数量
+** Returned value       :   无
+***********************************************************************************************************/
+void vCriticalProfilePrint (uint32_t uiTopN)
+{
+	CriticalSite_t xTop[TINYOS_CRITICAL_PROFILE_SITES];
+	double dUsPerCount = 1e6 / uiPortTimestampFreq();
+	uint32_t uiCnt, i;
+
+	if(uiTopN > TINYOS_CRITICAL_PROFILE_SITES)
+		uiTopN = TINYOS_CRITICAL_PROFILE_SITES;
+	uiCnt = uiCriticalProfileTop(xTop, uiTopN);
+
+	printf("tinyOS critical sections, longest first (%u sites", uiCriticalSiteCnt);
+	if(uiCriticalDropped)
+		printf(", %u entries dropped", uiCriticalDropped);
+	printf(")\n%-4s %-32s %6s %12s %10s %10s\n", "rank", "site", "line", "count", "max(us)", "avg(us)");
+	for(i = 0; i < uiCnt; i++)
+	{
+		printf("%-4u %-32s %6u %12u %10.3f %10.3f\n", i + 1, xTop[i].pcFunc, xTop[i].uiLine, xTop[i].uiCount,
+			xTop[i].uiMax * dUsPerCount, xTop[i].uiCount ? (double)xTop[i].ullTotal / xTop[i].uiCount * dUsPerCount : 0.0);
+	}
+	fflush(stdout);
+}
+
+static void prvCriticalProfileAtExit (void)
+{
+	const char * pcEnv = getenv("TINYOS_CRITICAL_TOP");
+	vCriticalProfilePrint(pcEnv ? (uint32_t)atoi(pcEnv) : 10);
+}
+#endif
+
+#endif /* TINYOS_ENABLE_CRITICAL_PROFILE */
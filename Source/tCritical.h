@@ -0,0 +1,79 @@
+#ifndef _TCRITICAL_H
+#define _TCRITICAL_H
+
+#include <stdint.h>
+#include "tConfig.h"
+
+// 临界区时长测量：打开TINYOS_ENABLE_CRITICAL_PROFILE后，uiTaskEnterCritical/vTaskExitCritical被替换为
+// 带调用点信息的版本，测量每一段最外层屏蔽中断的时长，按调用点统计次数、最大值与总时长。
+// 中断响应延迟的上限即所有调用点中最大的那一项
+
+typedef struct {
+	const char * pcFunc;               // 进入临界区的函数
+	uint32_t uiLine;                   // 进入临界区的行号
+	uint32_t uiCount;                  // 次数
+	uint32_t uiMax;                    // 最长一次的时长，单位为时间戳计数
+	uint64_t ullTotal;                 // 总时长，除以次数即平均值
+}CriticalSite_t;
+
+#if TINYOS_ENABLE_CRITICAL_PROFILE
+
+/**********************************************************************************************************
+** Function name        :   vCriticalProfileInit
+** Descriptions         :   清空统计结果并启动时间戳计数器
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vCriticalProfileInit (void);
+
+/**********************************************************************************************************
+** Function name        :   uiCriticalProfileEnter
+** Descriptions         :   进入临界区，如果是最外层则开始计时
+** parameters           :   pcFunc 调用者所在的函数
+** parameters           :   uiLine 调用者所在的行号
+** Returned value       :   进入临界区之前的中断状态值
+***********************************************************************************************************/
+uint32_t uiCriticalProfileEnter (const char * pcFunc, uint32_t uiLine);
+
+/**********************************************************************************************************
+** Function name        :   vCriticalProfileExit
+** Descriptions         :   退出临界区，如果是最外层则结束计时并计入调用点的统计
+** parameters           :   uiStatus 进入临界区之前的中断状态值
+** Returned value       :   无
+***********************************************************************************************************/
+void vCriticalProfileExit (uint32_t uiStatus);
+
+/**********************************************************************************************************
+** Function name        :   uiCriticalProfileTop
+** Descriptions         :   按最长时长从大到小取出前若干个调用点的统计
+** parameters           :   pxSites 存放结果的数组
+** parameters           :   uiMax 数组大小
+** Returned value       :   实际取出的调用点数量
+***********************************************************************************************************/
+uint32_t uiCriticalProfileTop (CriticalSite_t * pxSites, uint32_t uiMax);
+
+#ifdef TINYOS_PORT_LINUX
+/**********************************************************************************************************
+** Function name        :   vCriticalProfilePrint
+** Descriptions         :   输出最长的若干个临界区
+** parameters           :   uiTopN 输出的数量
+** Returned value       :   无
+***********************************************************************************************************/
+void vCriticalProfilePrint (uint32_t uiTopN);
+#endif
+
+// 移植层中实现临界区的文件在包含tinyOS.h前定义TINYOS_CRITICAL_PROFILE_IMPL，以使用原始的函数
+#ifndef TINYOS_CRITICAL_PROFILE_IMPL
+#define uiTaskEnterCritical()                 uiCriticalProfileEnter(__FUNCTION__, __LINE__)
+#define vTaskExitCritical(uiStatus)           vCriticalProfileExit(uiStatus)
+#endif
+
+#define CRITICAL_PROFILE_INIT()               vCriticalProfileInit()
+
+#else
+
+#define CRITICAL_PROFILE_INIT()
+
+#endif /* TINYOS_ENABLE_CRITICAL_PROFILE */
+
+#endif /* _TCRITICAL_H */
@@ -0,0 +1,244 @@
+#include "tinyOS.h"
+
+#if TINYOS_ENABLE_EDF
+
+/****************** 宏/变量定义 ****************************/
+
+// 按绝对截止期排序的二叉小顶堆，堆顶为截止期最早的就绪任务，任务在堆中的下标记录在uiEdfIndex中
+// 只有经uiTaskSetDeadline设置了截止期的任务进入堆中，其数量受TINYOS_EDF_MAX_TASKS限制；
+// 继承EDF优先级的任务没有截止期，放在该优先级的链表中，不占用堆的空间
+static Task_t * g_pxEdfHeap[TINYOS_EDF_MAX_TASKS];
+static uint32_t g_uiEdfHeapCnt;
+
+// 已加入EDF调度类的任务数量，不超过堆的容量
+static uint32_t g_uiEdfTaskCnt;
+
+extern uint32_t uiTickCount;
+
+// 节拍计数会回绕，按差值的符号比较先后
+#define prvEdfBefore(pxA, pxB)         ((int32_t)((pxA)->uiDeadline - (pxB)->uiDeadline) < 0)
+
+/**********************************************************************************************************
+** Function name        :   prvEdfPlace
+** Descriptions         :   将任务放到堆的指定位置
+** parameters           :   uiIndex 位置
+** parameters           :   pxTask 任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvEdfPlace (uint32_t uiIndex, Task_t * pxTask)
+{
+	g_pxEdfHeap[uiIndex] = pxTask;
+	pxTask->uiEdfIndex = uiIndex;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvEdfSiftUp
+** Descriptions         :   从指定位置向上调整，直到父结点的截止期不晚于该任务
+** parameters           :   uiIndex 起始位置
+** parameters           :   pxTask 放入的任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvEdfSiftUp (uint32_t uiIndex, Task_t * pxTask)
+{
+	while(uiIndex > 0)
+	{
+		uint32_t uiParent = (uiIndex - 1) / 2;
+		if(!prvEdfBefore(pxTask, g_pxEdfHeap[uiParent]))
+			break;
+		prvEdfPlace(uiIndex, g_pxEdfHeap[uiParent]);
+		uiIndex = uiParent;
+	}
+	prvEdfPlace(uiIndex, pxTask);
+}
+
+/**********************************************************************************************************
+** Function name        :   prvEdfSiftDown
+** Descriptions         :   从指定位置向下调整，直到子结点的截止期都不早于该任务
+** parameters           :   uiIndex 起始位置
+** parameters           :   pxTask 放入的任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvEdfSiftDown (uint32_t uiIndex, Task_t * pxTask)
+{
+	for(;;)
+	{
+		uint32_t uiChild = uiIndex * 2 + 1;
+		if(uiChild >= g_uiEdfHeapCnt)
+			break;
+		if(uiChild + 1 < g_uiEdfHeapCnt && prvEdfBefore(g_pxEdfHeap[uiChild + 1], g_pxEdfHeap[uiChild]))
+			uiChild++;
+		if(!prvEdfBefore(g_pxEdfHeap[uiChild], pxTask))
+			break;
+		prvEdfPlace(uiIndex, g_pxEdfHeap[uiChild]);
+		uiIndex = uiChild;
+	}
+	prvEdfPlace(uiIndex, pxTask);
+}
+
+/**********************************************************************************************************
+** Function name        :   vEdfInit
+** Descriptions         :   初始化EDF就绪堆
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vEdfInit (void)
+{
+	g_uiEdfHeapCnt = 0;
+	g_uiEdfTaskCnt = 0;
+}
+
+/**********************************************************************************************************
+** Function name        :   vEdfReady
+** Descriptions         :   将任务按截止期插入EDF就绪堆
+** parameters           :   pxTask 就绪的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vEdfReady (Task_t * pxTask)
+{
+	prvEdfSiftUp(g_uiEdfHeapCnt++, pxTask);
+}
+
+/**********************************************************************************************************
+** Function name        :   vEdfUnReady
+** Descriptions         :   将任务从EDF就绪堆中移除，用堆中最后一个任务填补其位置
+** parameters           :   pxTask 待移除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vEdfUnReady (Task_t * pxTask)
+{
+	uint32_t uiIndex = pxTask->uiEdfIndex;
+	Task_t * pxLast = g_pxEdfHeap[--g_uiEdfHeapCnt];
+
+	if(pxLast == pxTask)
+		return;
+
+	// 末尾的任务可能比被移除位置的父结点更早，也可能比子结点更晚
+	if(uiIndex > 0 && prvEdfBefore(pxLast, g_pxEdfHeap[(uiIndex - 1) / 2]))
+		prvEdfSiftUp(uiIndex, pxLast);
+	else
+		prvEdfSiftDown(uiIndex, pxLast);
+}
+
+/**********************************************************************************************************
+** Function name        :   pxEdfFirst
+** Descriptions         :   截止期最早的就绪任务
+** parameters           :   无
+** Returned value       :   任务，没有就绪任务时返回0
+***********************************************************************************************************/
+Task_t * pxEdfFirst (void)
+{
+	return g_uiEdfHeapCnt ? g_pxEdfHeap[0] : (Task_t *)0;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiEdfCount
+** Descriptions         :   EDF就绪堆中的任务数量
+** parameters           :   无
+** Returned value       :   任务数量
+***********************************************************************************************************/
+uint32_t uiEdfCount (void)
+{
+	return g_uiEdfHeapCnt;
+}
+
+/**********************************************************************************************************
+** Function name        :   vEdfTaskDelete
+** Descriptions         :   任务被删除时释放其占用的EDF名额
+** parameters           :   pxTask 被删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vEdfTaskDelete (Task_t * pxTask)
+{
+	if(pxTask->uiRelDeadline)
+	{
+		pxTask->uiRelDeadline = 0;
+		g_uiEdfTaskCnt--;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   uiTaskSetDeadline
+** Descriptions         :   将任务加入EDF调度类，并设置相对截止期与周期。任务的第一个周期从调用时开始
+** parameters           :   pxTask 任务
+** parameters           :   uiRelDeadline 相对截止期(节拍数)，不能为0
+** parameters           :   uiPeriod 周期(节拍数)，为0表示非周期任务
+** Returned value       :   eErrorNoError，EDF任务数量已达上限时返回eErrorResourceFull，相对截止期为0时返回eErrorResourceUnavaliable
+***********************************************************************************************************/
+uint32_t uiTaskSetDeadline (Task_t * pxTask, uint32_t uiRelDeadline, uint32_t uiPeriod)
+{
+	uint32_t uiStatus, uiReady;
+
+	// 相对截止期为0的任务不进入EDF就绪堆，也不会在删除时释放名额
+	if(!uiRelDeadline)
+		return eErrorResourceUnavaliable;
+
+	uiStatus = uiTaskEnterCritical();
+	uiReady = (pxTask->uiState == TINYOS_TASK_STATE_RDY);
+	if(!pxTask->uiRelDeadline)
+	{
+		if(g_uiEdfTaskCnt >= TINYOS_EDF_MAX_TASKS)
+		{
+			vTaskExitCritical(uiStatus);
+			return eErrorResourceFull;
+		}
+		g_uiEdfTaskCnt++;
+	}
+
+	// 截止期决定任务是否在EDF就绪堆中，就绪的任务先移出原来的位置，修改截止期后重新加入
+	if(uiReady)
+		vTaskSchedUnRdy(pxTask);
+	pxTask->uiRelDeadline = uiRelDeadline;
+	pxTask->uiPeriod = uiPeriod;
+	pxTask->uiRelease = uiTickCount;
+	pxTask->uiDeadline = uiTickCount + uiRelDeadline;
+	if(uiReady)
+		vTaskSchedRdy(pxTask);
+
+	// 只修改基础优先级，持有互斥量时继承或天花板的优先级仍然有效，变化沿阻塞链传递
+	pxTask->uiBasePrio = TINYOS_EDF_PRIO;
+	vMutexPrioUpdate(pxTask);
+	vTaskSched();
+
+	vTaskExitCritical(uiStatus);
+	return eErrorNoError;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskWaitNextPeriod
+** Descriptions         :   周期任务完成本周期的工作后调用，延时到下一个周期开始，同时截止期顺延一个周期。
+**                          完成时已经超过截止期的，计入截止期错过次数
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskWaitNextPeriod (void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	Task_t * pxTask = pxCurrentTask;
+	uint32_t uiNow = uiTickCount;
+	int32_t iWait;
+
+	if((int32_t)(uiNow - pxTask->uiDeadline) > 0)
+		pxTask->uiDeadlineMissCnt++;
+
+	// 截止期是堆的排序依据，必须先移出堆再修改
+	vTaskSchedUnRdy(pxTask);
+	pxTask->uiRelease += pxTask->uiPeriod;
+	pxTask->uiDeadline = pxTask->uiRelease + pxTask->uiRelDeadline;
+
+	// 已经错过下一个周期的开始时刻时，立即以新的截止期重新就绪
+	iWait = (int32_t)(pxTask->uiRelease - uiNow);
+	if(iWait > 0)
+	{
+		TRACE_TASK_DELAY(pxTask, (uint32_t)iWait);
+		vTimeTaskWait(pxTask, (uint32_t)iWait);
+	}
+	else
+	{
+		vTaskSchedRdy(pxTask);
+	}
+
+	vTaskSched();
+	vTaskExitCritical(uiStatus);
+}
+
+#endif /* TINYOS_ENABLE_EDF */
@@ -0,0 +1,87 @@
+#ifndef _TEDF_H
+#define _TEDF_H
+
+#include <stdint.h>
+#include "tConfig.h"
+#include "tTask.h"
+
+// 最早截止期优先(EDF)调度类：优先级为TINYOS_EDF_PRIO且设置了截止期的就绪任务不放在g_xTaskTable的链表中，
+// 而是放在按绝对截止期排序的二叉堆中，调度时取截止期最早的任务。高于或低于该优先级的任务仍按固定优先级调度，
+// 因此EDF任务整体上抢占较低优先级的任务，同时被较高优先级的任务抢占
+
+#if TINYOS_ENABLE_EDF
+
+#if (TINYOS_EDF_PRIO <= TINYOS_TIMERTASK_PRIO) || (TINYOS_EDF_PRIO >= TINYOS_PRO_COUNT - 1)
+#error "TINYOS_EDF_PRIO must be between the timer task and the idle task priority"
+#endif
+
+/**********************************************************************************************************
+** Function name        :   vEdfInit
+** Descriptions         :   初始化EDF就绪堆
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vEdfInit (void);
+
+/**********************************************************************************************************
+** Function name        :   vEdfReady
+** Descriptions         :   将任务按截止期插入EDF就绪堆
+** parameters           :   pxTask 就绪的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vEdfReady (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vEdfUnReady
+** Descriptions         :   将任务从EDF就绪堆中移除
+** parameters           :   pxTask 待移除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vEdfUnReady (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   pxEdfFirst
+** Descriptions         :   截止期最早的就绪任务
+** parameters           :   无
+** Returned value       :   任务，没有就绪任务时返回0
+***********************************************************************************************************/
+Task_t * pxEdfFirst (void);
+
+/**********************************************************************************************************
+** Function name        :   uiEdfCount
+** Descriptions         :   EDF就绪堆中的任务数量
+** parameters           :   无
+** Returned value       :   任务数量
+***********************************************************************************************************/
+uint32_t uiEdfCount (void);
+
+/**********************************************************************************************************
+** Function name        :   vEdfTaskDelete
+** Descriptions         :   任务被删除时释放其占用的EDF名额
+** parameters           :   pxTask 被删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vEdfTaskDelete (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   uiTaskSetDeadline
+** Descriptions         :   将任务加入EDF调度类，并设置相对截止期与周期。任务的第一个周期从调用时开始
+** parameters           :   pxTask 任务
+** parameters           :   uiRelDeadline 相对截止期(节拍数)，不能为0
+** parameters           :   uiPeriod 周期(节拍数)，为0表示非周期任务
+** Returned value       :   eErrorNoError，EDF任务数量已达上限时返回eErrorResourceFull，相对截止期为0时返回eErrorResourceUnavaliable
+***********************************************************************************************************/
+uint32_t uiTaskSetDeadline (Task_t * pxTask, uint32_t uiRelDeadline, uint32_t uiPeriod);
+
+/**********************************************************************************************************
+** Function name        :   vTaskWaitNextPeriod
+** Descriptions         :   周期任务完成本周期的工作后调用，延时到下一个周期开始，同时截止期顺延一个周期。
+**                          完成时已经超过截止期的，计入截止期错过次数
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskWaitNextPeriod (void);
+
+#endif /* TINYOS_ENABLE_EDF */
+
+#endif /* _TEDF_H */
@@ -1,218 +1,366 @@
-#include "tinyOS.h"
-
-/**********************************************************************************************************
-** Function name        :   vEventInit
-** Descriptions         :   初始化事件控制块
-** parameters           :   pxEvent 事件控制块
-** parameters           :   eType 事件控制块的类型
-** Returned value       :   无
-***********************************************************************************************************/
-void vEventInit (Event_t * pxEvent, EventType_e eType)
-{
-	pxEvent->eType = eType;
-	vListInit(&pxEvent->xWaitList);
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vEventWait
-** Descriptions         :   让指定在事件控制块上等待事件发生
-** parameters           :   pxEvent 事件控制块
-** parameters           :   pxTask 等待事件发生的任务
-** parameters           :   pvMsg 事件消息存储的具体位置
-** parameters           :   uiState 消息类型
-** parameters           :   uiTImeout 等待多长时间
-** Returned value       :   优先级最高的且可运行的任务
-***********************************************************************************************************/
-void vEventWait(Event_t * pxEvent, Task_t * pxTask, void * pvMsg, uint32_t uiState, uint32_t uiTImeout)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	pxTask->uiState |= (uiState << 16);     // 标记任务处于等待某种事件的状态
-	pxTask->pxWaitEvent = pxEvent;                // 设置任务等待的事件结构
-	pxTask->pvEventMsg = pvMsg;                   // 设置任务等待事件的消息存储位置
-	pxTask->uiWaitEventResult = eErrorNoError;    // 清空事件的等待结果
-
-	// 将任务从就绪链表中移除
-	vTaskSchedUnRdy(pxTask);
-	
-	// 将任务插入到等待队列中
-	vListAddLast(&pxEvent->xWaitList, &pxTask->xEventNode);
-
-	// 如果发现有设置超时，在同时插入到延时队列中
-	// 当时间到达时，由延时处理机制负责将任务从延时列表中移除，同时从事件列表中移除
-	if(uiTImeout)
-	{
-		vTimeTaskWait(pxTask, uiTImeout);
-	}
-	
-	vTaskExitCritical(uiStatus);
-}
-
-/**********************************************************************************************************
-** Function name        :   pxEventWakeUp
-** Descriptions         :   从事件控制块中唤醒首个等待的任务
-** parameters           :   pxEvent 事件控制块
-** parameters           :   pvMsg 事件消息
-** parameters           :   uiResult 告知事件的等待结果
-** Returned value       :   首个等待的任务，如果没有任务等待，则返回0
-***********************************************************************************************************/
-Task_t * pxEventWakeUp (Event_t * pxEvent, void * pvMsg, uint32_t uiResult)
-{
-	Node_t * pxNode;
-	Task_t * pxTask;
-	
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	if((pxNode = pxListRemoveFirst(&pxEvent->xWaitList)) != (Node_t *)0)
-	{
-		pxTask = (Task_t *)pxNodeParent(pxNode, Task_t, xEventNode);
-		
-		// 设置收到的消息、结构，清除相应的等待标志位
-		pxTask->pxWaitEvent = (Event_t *)0;
-		pxTask->pvEventMsg = pvMsg;
-		pxTask->uiWaitEventResult = uiResult;
-		pxTask->uiState &= ~TINYOS_TASK_WAIT_MASK;
-		
-		// 任务申请了超时等待，这里检查下，将其从延时队列中移除
-		if(pxTask->uiDelayTicks)
-			vTimeTaskWakeUp(pxTask);
-		
-		vTaskSchedRdy(pxTask);
-	}
-	
-	vTaskExitCritical(uiStatus);
-	
-	return pxTask;
-}
-
-/**********************************************************************************************************
-** Function name        :   vEventWakeUpTask
-** Descriptions         :   从事件控制块中唤醒指定任务
-** parameters           :   event 事件控制块
-** parameters           :   task 等待唤醒的任务
-** parameters           :   msg 事件消息
-** parameters           :   result 告知事件的等待结果
-** Returned value       :   首个等待的任务，如果没有任务等待，则返回0
-***********************************************************************************************************/
-void vEventWakeUpTask (Event_t * pxEvent, Task_t * pxTask, void * pvMsg, uint32_t uiResult)
-{
-    // 进入临界区
-    uint32_t uiStatus = uiTaskEnterCritical();
-
-    vListRemove(&pxEvent->xWaitList, &pxTask->xEventNode);
-
-    // 设置收到的消息、结构，清除相应的等待标志位
-    pxTask->pxWaitEvent = (Event_t *)0;
-    pxTask->pvEventMsg = pvMsg;
-    pxTask->uiWaitEventResult = uiResult;
-    pxTask->uiState &= ~TINYOS_TASK_WAIT_MASK;
-
-    // 任务申请了超时等待，这里检查下，将其从延时队列中移除
-    if (pxTask->uiDelayTicks != 0)
-    {
-        vTimeTaskWakeUp(pxTask);
-    }
-
-    // 将任务加入就绪队列
-    vTaskSchedRdy(pxTask);
-
-    // 退出临界区
-    vTaskExitCritical(uiStatus);
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vEventRemoveTask
-** Descriptions         :   将任务从其等待队列中强制移除
-** parameters           :   pxTask 待移除的任务
-** parameters           :   pvMsg 事件消息
-** parameters           :   uiResult 告知事件的等待结果
-** Returned value       :   无
-***********************************************************************************************************/
-void vEventRemoveTask (Task_t * pxTask, void * pvMsg, uint32_t uiResult)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	// 将任务从所在的等待队列中移除
-	// 注意，这里没有检查waitEvent是否为空。既然是从事件中移除，那么认为就不可能为空
-	vListRemove(&pxTask->pxWaitEvent->xWaitList, &pxTask->xEventNode);
-
-	// 设置收到的消息、结构，清除相应的等待标志位
-	pxTask->pxWaitEvent = (Event_t *)0;
-	pxTask->pvEventMsg = pvMsg;
-	pxTask->uiWaitEventResult = uiResult;
-	pxTask->uiState &= ~TINYOS_TASK_WAIT_MASK;
-	
-	vTaskExitCritical(uiStatus);
-}
-
-/**********************************************************************************************************
-** Function name        :   uiEventRemoveAll
-** Descriptions         :   清除所有等待中的任务，将事件发送给所有任务
-** parameters           :   event 事件控制块
-** parameters           :   msg 事件消息
-** parameters           :   result 告知事件的等待结果
-** Returned value       :   唤醒的任务数量
-***********************************************************************************************************/
-uint32_t uiEventRemoveAll (Event_t *pxEvent, void * pvMsg, uint32_t uiResult)
-{
-    Node_t  * pxNode;
-    uint32_t uiCnt;
-    
-    // 进入临界区
-    uint32_t uiStatus = uiTaskEnterCritical();
-
-    // 获取等待中的任务数量
-    uiCnt = uiListCount(&pxEvent->xWaitList);
-
-    // 遍历所有等待中的任务
-    while ((pxNode = pxListRemoveFirst(&pxEvent->xWaitList)) != (Node_t *)0)
-    {                                                                   
-        // 转换为相应的任务结构                                          
-        Task_t * pxTask = (Task_t *)pxNodeParent(pxNode, Task_t, xEventNode);
-        
-		// 设置收到的消息、结构，清除相应的等待标志位
-		pxTask->pxWaitEvent = (Event_t *)0;
-		pxTask->pvEventMsg = pvMsg;
-		pxTask->uiWaitEventResult = uiResult;
-		pxTask->uiState &= ~TINYOS_TASK_WAIT_MASK;
-
-        // 任务申请了超时等待，这里检查下，将其从延时队列中移除
-        if (pxTask->uiDelayTicks != 0)
-        { 
-            vTimeTaskWakeUp(pxTask);
-        }
-
-        // 将任务加入就绪队列
-        vTaskSchedRdy(pxTask);        
-    }  
-
-    // 退出临界区
-    vTaskExitCritical(uiStatus); 
-
-    return  uiCnt;	
-}
-
-/**********************************************************************************************************
-** Function name        :   uiEventWaitCount
-** Descriptions         :   事件控制块中等待的任务数量
-** parameters           :   event 事件控制块
-** parameters           :   msg 事件消息
-** parameters           :   result 告知事件的等待结果
-** Returned value       :   唤醒的任务数量
-***********************************************************************************************************/
-uint32_t uiEventWaitCount (Event_t * pxEvent)
-{  
-    uint32_t uiCount = 0;
-
-    // 进入临界区
-    uint32_t uiStatus = uiTaskEnterCritical();
-
-    uiCount = uiListCount(&pxEvent->xWaitList);  
-
-    // 退出临界区
-    vTaskExitCritical(uiStatus);     
-
-    return uiCount;
-}  
+#include "tinyOS.h"
+
+// 按优先级排列的等待队列：等待者按优先级从高到低排列，同优先级的按等待的先后顺序排成一段。
+// 每一段的首结点与尾结点通过pxEventRunPeer互相指向对方(只有一个结点时指向自己)，插入时逐段跳过
+// 优先级更高的段，比较次数不超过队列中不同优先级的数量，而不是等待者的数量；移除只需调整相邻结点
+
+/**********************************************************************************************************
+** Function name        :   prvEventLink
+** Descriptions         :   将任务按事件控制块的排列方式插入等待队列
+** parameters           :   pxEvent 事件控制块
+** parameters           :   pxTask 等待的任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvEventLink (Event_t * pxEvent, Task_t * pxTask)
+{
+	List_t * pxList = &pxEvent->xWaitList;
+	Node_t * pxNode;
+	Task_t * pxRun = (Task_t *)0;
+	
+	if(pxEvent->eOrder == eEventOrderFifo)
+	{
+		vListAddLast(pxList, &pxTask->xEventNode);
+		return;
+	}
+	
+	// 逐段查找第一个优先级不高于该任务的段
+	for(pxNode = pxListFirst(pxList); pxNode; pxNode = pxListNext(pxList, pxRun->pxEventRunPeer))
+	{
+		pxRun = pxNodeParent(pxNode, Task_t, xEventNode);
+		if(pxRun->uiPrio >= pxTask->uiPrio)
+			break;
+	}
+	
+	if(pxNode && pxRun->uiPrio == pxTask->uiPrio)
+	{
+		// 排到同优先级一段的末尾，成为新的尾结点
+		vListInsertAfter(pxList, pxRun->pxEventRunPeer, &pxTask->xEventNode);
+		pxRun->pxEventRunPeer = &pxTask->xEventNode;
+		pxTask->pxEventRunPeer = pxNode;
+	}
+	else
+	{
+		// 单独成为一段
+		if(pxNode)
+			vListInsertForward(pxList, pxNode, &pxTask->xEventNode);
+		else
+			vListAddLast(pxList, &pxTask->xEventNode);
+		pxTask->pxEventRunPeer = &pxTask->xEventNode;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvEventUnlink
+** Descriptions         :   将任务从等待队列中移除，按优先级排列时维护所在段的首尾结点
+** parameters           :   pxEvent 事件控制块
+** parameters           :   pxTask 等待的任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvEventUnlink (Event_t * pxEvent, Task_t * pxTask)
+{
+	List_t * pxList = &pxEvent->xWaitList;
+	Node_t * pxSelf = &pxTask->xEventNode;
+	Node_t * pxPre;
+	Node_t * pxNext;
+	Task_t * pxPreWaiter = (Task_t *)0;
+	Task_t * pxNextWaiter = (Task_t *)0;
+	Task_t * pxPeerTask;
+	
+	if(pxEvent->eOrder == eEventOrderPrio)
+	{
+		pxPre = pxListPre(pxList, pxSelf);
+		pxNext = pxListNext(pxList, pxSelf);
+		if(pxPre)
+		{
+			pxPreWaiter = pxNodeParent(pxPre, Task_t, xEventNode);
+			if(pxPreWaiter->uiPrio != pxTask->uiPrio)
+				pxPreWaiter = (Task_t *)0;
+		}
+		if(pxNext)
+		{
+			pxNextWaiter = pxNodeParent(pxNext, Task_t, xEventNode);
+			if(pxNextWaiter->uiPrio != pxTask->uiPrio)
+				pxNextWaiter = (Task_t *)0;
+		}
+		
+		// 只有段首或段尾被移除时需要调整，段中间的结点与单独成段的结点直接移除
+		pxPeerTask = pxNodeParent(pxTask->pxEventRunPeer, Task_t, xEventNode);
+		if(!pxPreWaiter && pxNextWaiter)
+		{
+			pxNextWaiter->pxEventRunPeer = pxTask->pxEventRunPeer;
+			pxPeerTask->pxEventRunPeer = pxNext;
+		}
+		else if(pxPreWaiter && !pxNextWaiter)
+		{
+			pxPreWaiter->pxEventRunPeer = pxTask->pxEventRunPeer;
+			pxPeerTask->pxEventRunPeer = pxPre;
+		}
+		pxTask->pxEventRunPeer = pxSelf;
+	}
+	
+	vListRemove(pxList, pxSelf);
+}
+
+/**********************************************************************************************************
+** Function name        :   vEventInit
+** Descriptions         :   初始化事件控制块
+** parameters           :   pxEvent 事件控制块
+** parameters           :   eType 事件控制块的类型
+** Returned value       :   无
+***********************************************************************************************************/
+void vEventInit (Event_t * pxEvent, EventType_e eType)
+{
+	pxEvent->eType = eType;
+	pxEvent->eOrder = eEventOrderFifo;
+	vListInit(&pxEvent->xWaitList);
+}
+
+/**********************************************************************************************************
+** Function name        :   vEventSetOrder
+** Descriptions         :   设置等待队列的排列方式，只能在没有任务等待时调用，通常紧跟在对象的初始化之后，
+**                          例如vEventSetOrder(&xSem.xEvent, eEventOrderPrio)。初始化后默认为eEventOrderFifo
+** parameters           :   pxEvent 事件控制块
+** parameters           :   eOrder 排列方式
+** Returned value       :   无
+***********************************************************************************************************/
+void vEventSetOrder (Event_t * pxEvent, EventOrder_e eOrder)
+{
+	pxEvent->eOrder = eOrder;
+}
+
+/**********************************************************************************************************
+** Function name        :   vEventTaskSetPrio
+** Descriptions         :   修改正在等待事件的任务的优先级，按优先级排列的等待队列中同时调整任务的位置。需在临界区内调用
+** parameters           :   pxTask 正在等待事件的任务
+** parameters           :   uiPrio 新的优先级
+** Returned value       :   无
+***********************************************************************************************************/
+void vEventTaskSetPrio (Task_t * pxTask, uint32_t uiPrio)
+{
+	Event_t * pxEvent = pxTask->pxWaitEvent;
+	
+	if(pxEvent->eOrder == eEventOrderFifo || pxTask->uiPrio == uiPrio)
+	{
+		pxTask->uiPrio = uiPrio;
+		return;
+	}
+	
+	prvEventUnlink(pxEvent, pxTask);
+	pxTask->uiPrio = uiPrio;
+	prvEventLink(pxEvent, pxTask);
+}
+
+
+/**********************************************************************************************************
+** Function name        :   vEventWait
+** Descriptions         :   让指定在事件控制块上等待事件发生
+** parameters           :   pxEvent 事件控制块
+** parameters           :   pxTask 等待事件发生的任务
+** parameters           :   pvMsg 事件消息存储的具体位置
+** parameters           :   uiState 消息类型
+** parameters           :   uiTImeout 等待多长时间
+** Returned value       :   优先级最高的且可运行的任务
+***********************************************************************************************************/
+void vEventWait(Event_t * pxEvent, Task_t * pxTask, void * pvMsg, uint32_t uiState, uint32_t uiTImeout)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	pxTask->uiState |= (uiState << 16);     // 标记任务处于等待某种事件的状态
+	pxTask->pxWaitEvent = pxEvent;                // 设置任务等待的事件结构
+	pxTask->pvEventMsg = pvMsg;                   // 设置任务等待事件的消息存储位置
+	pxTask->uiWaitEventResult = eErrorNoError;    // 清空事件的等待结果
+	TRACE_EVENT_WAIT(pxTask, pxEvent);
+
+	// 将任务从就绪链表中移除
+	vTaskSchedUnRdy(pxTask);
+	
+	// 将任务插入到等待队列中
+	prvEventLink(pxEvent, pxTask);
+
+	// 如果发现有设置超时，在同时插入到延时队列中
+	// 当时间到达时，由延时处理机制负责将任务从延时列表中移除，同时从事件列表中移除
+	if(uiTImeout)
+	{
+		vTimeTaskWait(pxTask, uiTImeout);
+	}
+	
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   pxEventWakeUp
+** Descriptions         :   从事件控制块中唤醒首个等待的任务
+** parameters           :   pxEvent 事件控制块
+** parameters           :   pvMsg 事件消息
+** parameters           :   uiResult 告知事件的等待结果
+** Returned value       :   首个等待的任务，如果没有任务等待，则返回0
+***********************************************************************************************************/
+Task_t * pxEventWakeUp (Event_t * pxEvent, void * pvMsg, uint32_t uiResult)
+{
+	Node_t * pxNode;
+	Task_t * pxTask = (Task_t *)0;
+	
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	if((pxNode = pxListFirst(&pxEvent->xWaitList)) != (Node_t *)0)
+	{
+		pxTask = (Task_t *)pxNodeParent(pxNode, Task_t, xEventNode);
+		prvEventUnlink(pxEvent, pxTask);
+		TRACE_EVENT_WAKE(pxTask, pxEvent, uiResult);
+		
+		// 设置收到的消息、结构，清除相应的等待标志位
+		pxTask->pxWaitEvent = (Event_t *)0;
+		pxTask->pvEventMsg = pvMsg;
+		pxTask->uiWaitEventResult = uiResult;
+		pxTask->uiState &= ~TINYOS_TASK_WAIT_MASK;
+		
+		// 任务申请了超时等待，这里检查下，将其从延时队列中移除
+		if(pxTask->uiState & TINYOS_TASK_STATE_DELAYED)
+			vTimeTaskWakeUp(pxTask);
+		
+		vTaskSchedRdy(pxTask);
+	}
+	
+	vTaskExitCritical(uiStatus);
+	
+	return pxTask;
+}
+
+/**********************************************************************************************************
+** Function name        :   vEventWakeUpTask
+** Descriptions         :   从事件控制块中唤醒指定任务
+** parameters           :   event 事件控制块
+** parameters           :   task 等待唤醒的任务
+** parameters           :   msg 事件消息
+** parameters           :   result 告知事件的等待结果
+** Returned value       :   首个等待的任务，如果没有任务等待，则返回0
+***********************************************************************************************************/
+void vEventWakeUpTask (Event_t * pxEvent, Task_t * pxTask, void * pvMsg, uint32_t uiResult)
+{
+    // 进入临界区
+    uint32_t uiStatus = uiTaskEnterCritical();
+
+    prvEventUnlink(pxEvent, pxTask);
+    TRACE_EVENT_WAKE(pxTask, pxEvent, uiResult);
+
+    // 设置收到的消息、结构，清除相应的等待标志位
+    pxTask->pxWaitEvent = (Event_t *)0;
+    pxTask->pvEventMsg = pvMsg;
+    pxTask->uiWaitEventResult = uiResult;
+    pxTask->uiState &= ~TINYOS_TASK_WAIT_MASK;
+
+    // 任务申请了超时等待，这里检查下，将其从延时队列中移除
+    if (pxTask->uiState & TINYOS_TASK_STATE_DELAYED)
+    {
+        vTimeTaskWakeUp(pxTask);
+    }
+
+    // 将任务加入就绪队列
+    vTaskSchedRdy(pxTask);
+
+    // 退出临界区
+    vTaskExitCritical(uiStatus);
+}
+
+
+/**********************************************************************************************************
+** Function name        :   vEventRemoveTask
+** Descriptions         :   将任务从其等待队列中强制移除
+** parameters           :   pxTask 待移除的任务
+** parameters           :   pvMsg 事件消息
+** parameters           :   uiResult 告知事件的等待结果
+** Returned value       :   无
+***********************************************************************************************************/
+void vEventRemoveTask (Task_t * pxTask, void * pvMsg, uint32_t uiResult)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	Event_t * pxEvent = pxTask->pxWaitEvent;
+	
+	// 将任务从所在的等待队列中移除
+	// 注意，这里没有检查waitEvent是否为空。既然是从事件中移除，那么认为就不可能为空
+	prvEventUnlink(pxEvent, pxTask);
+	TRACE_EVENT_WAKE(pxTask, pxTask->pxWaitEvent, uiResult);
+
+	// 设置收到的消息、结构，清除相应的等待标志位
+	pxTask->pxWaitEvent = (Event_t *)0;
+	pxTask->pvEventMsg = pvMsg;
+	pxTask->uiWaitEventResult = uiResult;
+	pxTask->uiState &= ~TINYOS_TASK_WAIT_MASK;
+	
+	// 互斥量的拥有者可能继承了该任务的优先级
+	if(pxEvent->eType == eEventTYpeMutex)
+		vMutexWaiterRemoved((Mutex_t *)pxEvent);
+	
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiEventRemoveAll
+** Descriptions         :   清除所有等待中的任务，将事件发送给所有任务
+** parameters           :   event 事件控制块
+** parameters           :   msg 事件消息
+** parameters           :   result 告知事件的等待结果
+** Returned value       :   唤醒的任务数量
+***********************************************************************************************************/
+uint32_t uiEventRemoveAll (Event_t *pxEvent, void * pvMsg, uint32_t uiResult)
+{
+    Node_t  * pxNode;
+    uint32_t uiCnt;
+    
+    // 进入临界区
+    uint32_t uiStatus = uiTaskEnterCritical();
+
+    // 获取等待中的任务数量
+    uiCnt = uiListCount(&pxEvent->xWaitList);
+
+    // 遍历所有等待中的任务
+    while ((pxNode = pxListRemoveFirst(&pxEvent->xWaitList)) != (Node_t *)0)
+    {                                                                   
+        // 转换为相应的任务结构                                          
+        Task_t * pxTask = (Task_t *)pxNodeParent(pxNode, Task_t, xEventNode);
+        TRACE_EVENT_WAKE(pxTask, pxEvent, uiResult);
+        
+		// 设置收到的消息、结构，清除相应的等待标志位
+		pxTask->pxWaitEvent = (Event_t *)0;
+		pxTask->pvEventMsg = pvMsg;
+		pxTask->uiWaitEventResult = uiResult;
+		pxTask->uiState &= ~TINYOS_TASK_WAIT_MASK;
+
+        // 任务申请了超时等待，这里检查下，将其从延时队列中移除
+        if (pxTask->uiState & TINYOS_TASK_STATE_DELAYED)
+        { 
+            vTimeTaskWakeUp(pxTask);
+        }
+
+        // 将任务加入就绪队列
+        vTaskSchedRdy(pxTask);        
+    }  
+
+    // 退出临界区
+    vTaskExitCritical(uiStatus); 
+
+    return  uiCnt;	
+}
+
+/**********************************************************************************************************
+** Function name        :   uiEventWaitCount
+** Descriptions         :   事件控制块中等待的任务数量
+** parameters           :   event 事件控制块
+** parameters           :   msg 事件消息
+** parameters           :   result 告知事件的等待结果
+** Returned value       :   唤醒的任务数量
+***********************************************************************************************************/
+uint32_t uiEventWaitCount (Event_t * pxEvent)
+{  
+    uint32_t uiCount = 0;
+
+    // 进入临界区
+    uint32_t uiStatus = uiTaskEnterCritical();
+
+    uiCount = uiListCount(&pxEvent->xWaitList);  
+
+    // 退出临界区
+    vTaskExitCritical(uiStatus);     
+
+    return uiCount;
+}  
@@ -1,251 +1,374 @@
-#include "tinyOS.h"
-
-/**********************************************************************************************************
-** Function name        :   vMutexInit
-** Descriptions         :   初始化互斥信号量
-** parameters           :   mutex 等待初始化的互斥信号量
-** Returned value       :   无
-***********************************************************************************************************/
-void vMutexInit(Mutex_t * pxMutex)
-{
-	vEventInit(&pxMutex->xEvent, eEventTYpeMutex);
-	
-	pxMutex->uiLockedCnt = 0;
-	pxMutex->pxOwner = (Task_t *)0;
-	pxMutex->uiOwnerOriginalPrio = TINYOS_PRO_COUNT;
-}
-
-
-/**********************************************************************************************************
-** Function name        :   uiMutexWait
-** Descriptions         :   等待信号量
-** parameters           :   pxMutex 等待的信号量
-** parameters           :   uiWaitTicks 最大等待的ticks数，为0表示无限等待
-** Returned value       :   等待结果,tErrorResourceUnavaliable.tErrorNoError,tErrorTimeout
-***********************************************************************************************************/
-uint32_t uiMutexWait(Mutex_t * pxMutex, uint32_t uiWaitTicks)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	if(pxMutex->uiLockedCnt <= 0)
-	{
-		// 如果没有锁定，则使用当前任务进行锁定
-		pxMutex->pxOwner = pxCurrentTask;
-		pxMutex->uiOwnerOriginalPrio = pxCurrentTask->uiPrio;
-		pxMutex->uiLockedCnt++;
-		vTaskExitCritical(uiStatus);
-		return eErrorNoError;
-	}
-	else
-	{
-		// 信号量已经被锁定
-		if(pxMutex->pxOwner == pxCurrentTask)
-		{
-			// 如果是信号量的拥有者再次wait，简单增加计数
-			pxMutex->uiLockedCnt++;
-			vTaskExitCritical(uiStatus);
-			return eErrorNoError;
-		}
-		else
-		{
-			// 如果是信号量拥有者之外的任务wait，则要检查下是否需要使用
-			// 优先级继承方式处理
-			if(pxCurrentTask->uiPrio < pxMutex->pxOwner->uiPrio)
-			{
-				Task_t * pxOwnerTask = pxMutex->pxOwner;
-				
-                // 如果当前任务的优先级比拥有者优先级更高，则使用优先级继承
-                // 提升原拥有者的优先
-				if(pxOwnerTask->uiState == TINYOS_TASK_STATE_RDY)
-				{
-					// 任务处于就绪状态时，更改任务在就绪表中的位置
-					vTaskSchedUnRdy(pxOwnerTask);
-					pxOwnerTask->uiPrio = pxCurrentTask->uiPrio;
-					vTaskSchedRdy(pxOwnerTask);
-				}
-				else
-				{
-					// 其它任务状态，只需要修改优先级
-					pxOwnerTask->uiPrio = pxCurrentTask->uiPrio;
-				}
-			}
-			
-			// 当前任务进入等待队列中
-			vEventWait(&pxMutex->xEvent, pxCurrentTask, (void *)0, eEventTYpeMutex, uiWaitTicks);
-			vTaskExitCritical(uiStatus);
-			// 执行调度， 切换至其它任务
-			vTaskSched();
-			return pxCurrentTask->uiWaitEventResult;
-		}
-	}
-}
-
-/**********************************************************************************************************
-** Function name        :   uiMutexNoWaitGet
-** Descriptions         :   获取信号量，如果已经被锁定，立即返回
-** parameters           :   pxMutex 获取的信号量
-** Returned value       :   获取结果, tErrorResourceUnavaliable.tErrorNoError
-***********************************************************************************************************/
-uint32_t uiMutexNoWaitGet(Mutex_t * pxMutex)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	if(pxMutex->uiLockedCnt <= 0)
-	{
-		// 如果没有锁定，则使用当前任务进行锁定
-		pxMutex->pxOwner = pxCurrentTask;
-		pxMutex->uiOwnerOriginalPrio = pxCurrentTask->uiPrio;
-		pxMutex->uiLockedCnt++;
-		vTaskExitCritical(uiStatus);
-		return eErrorNoError;
-	}
-	else
-	{
-		// 信号量已经被锁定
-		if(pxMutex->pxOwner == pxCurrentTask)
-		{
-			// 如果是信号量的拥有者再次wait，简单增加计数
-			pxMutex->uiLockedCnt++;
-			vTaskExitCritical(uiStatus);
-			return eErrorNoError;
-		}
-		
-		vTaskExitCritical(uiStatus);
-		return eErrorResourceUnavaliable;
-	}
-}
-
-/**********************************************************************************************************
-** Function name        :   uiMutexNotify
-** Descriptions         :   通知互斥信号量可用
-** parameters           :   pxMutex 操作的信号量
-** Returned value       :   tErrorResourceFull
-***********************************************************************************************************/
-uint32_t uiMutexNotify(Mutex_t * pxMutex)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	if(pxMutex->uiLockedCnt <= 0)
-	{
-		// 锁定计数为0，信号量未被锁定，直接退出
-		vTaskExitCritical(uiStatus);
-		return eErrorNoError;
-	}
-	
-	if(pxMutex->pxOwner != pxCurrentTask)
-	{
-		// 不是拥有者释放，认为是非法
-		vTaskExitCritical(uiStatus);
-		return eErrorOwner;
-	}
-	
-	if(--pxMutex->uiLockedCnt > 0)
-	{
-		// 减1后计数仍不为0, 直接退出，不需要唤醒等待的任务
-		vTaskExitCritical(uiStatus);
-		return eErrorOwner;
-	}
-	
-	// 是否有发生优先级继承
-	if (pxMutex->uiOwnerOriginalPrio != pxMutex->pxOwner->uiPrio)
-	{
-		// 有发生优先级继承，恢复拥有者的优先级
-		if (pxMutex->pxOwner->uiState == TINYOS_TASK_STATE_RDY)
-		{
-			// 任务处于就绪状态时，更改任务在就绪表中的位置
-			vTaskSchedUnRdy(pxMutex->pxOwner);
-			pxCurrentTask->uiPrio = pxMutex->uiOwnerOriginalPrio;
-			vTaskSchedRdy(pxMutex->pxOwner);
-		}
-		else
-		{
-			// 其它状态，只需要修改优先级
-			pxCurrentTask->uiPrio = pxMutex->uiOwnerOriginalPrio;
-		}
-	}
-	
-	if(uiEventWaitCount(&pxMutex->xEvent) > 0)
-	{
-		// 如果有的话，则直接唤醒位于队列首部（最先等待）的任务
-		Task_t * pxTask = pxEventWakeUp(&pxMutex->xEvent, (void *)0, eErrorNoError);
-		
-		pxMutex->pxOwner = pxTask;
-		pxMutex->uiOwnerOriginalPrio = pxTask->uiPrio;
-		pxMutex->uiLockedCnt++;
-		
-		// 如果这个任务的优先级更高，就执行调度，切换过去
-		if(pxTask->uiPrio < pxCurrentTask->uiPrio)
-		{
-			vTaskSched();
-		}
-	}
-	vTaskExitCritical(uiStatus);
-	return eErrorNoError;
-}
-
-/**********************************************************************************************************
-** Function name        :   uiMutexDestroy
-** Descriptions         :   销毁信号量
-** parameters           :   pxMutex 销毁互斥信号量
-** Returned value       :   因销毁该信号量而唤醒的任务数量
-***********************************************************************************************************/
-uint32_t uiMutexDestroy(Mutex_t * pxMutex)
-{
-	uint32_t uiCnt = 0;
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	// 信号量是否已经被锁定，未锁定时没有任务等待，不必处理
-	if(pxMutex->uiLockedCnt > 0)
-	{
-		// 是否有发生优先级继承
-		if (pxMutex->uiOwnerOriginalPrio != pxMutex->pxOwner->uiPrio)
-		{
-			// 有发生优先级继承，恢复拥有者的优先级
-			if (pxMutex->pxOwner->uiState == TINYOS_TASK_STATE_RDY)
-			{
-				// 任务处于就绪状态时，更改任务在就绪表中的位置
-				vTaskSchedUnRdy(pxMutex->pxOwner);
-				pxMutex->pxOwner->uiPrio = pxMutex->uiOwnerOriginalPrio;
-				vTaskSchedRdy(pxMutex->pxOwner);
-			}
-			else
-			{
-				// 其它状态，只需要修改优先级
-				pxMutex->pxOwner->uiPrio = pxMutex->uiOwnerOriginalPrio;
-			}
-		}
-		
-		// 清空事件控制块中的任务
-		uiCnt = uiEventRemoveAll(&pxMutex->xEvent, (void *)0, eErrorDel);
-			
-		// 清空过程中可能有任务就绪，执行一次调度
-		if(uiCnt)
-		{
-			vTaskSched();
-		}
-	}
-	vTaskExitCritical(uiStatus);
-	return uiCnt;
-}
-
-/**********************************************************************************************************
-** Function name        :   vMutexGetInfo
-** Descriptions         :   查询状态信息
-** parameters           :   pxMutex 查询的互斥信号量
-** parameters           :   pxInfo 状态查询存储的位置
-** Returned value       :   无
-***********************************************************************************************************/
-void vMutexGetInfo (Mutex_t * pxMutex, MutexInfo_t * pxInfo)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	pxInfo->uiTaskCnt = uiEventWaitCount(&pxMutex->xEvent);
-	pxInfo->uiOwnerPrio = pxMutex->uiOwnerOriginalPrio;
-	
-	if(pxMutex->pxOwner != (Task_t *)0)
-		pxInfo->uiInheritedPrio = pxMutex->pxOwner->uiPrio;
-	else
-		pxInfo->uiInheritedPrio = TINYOS_PRO_COUNT;
-	pxInfo->pxOwner = pxMutex->pxOwner;
-	pxInfo->uiLockedCnt = pxMutex->uiLockedCnt;
-	
-	vTaskExitCritical(uiStatus);	
-}
+#include "tinyOS.h"
+
+/****************** 宏/变量定义 ****************************/
+
+// 优先级沿阻塞链传递时经过的最大深度，以及因达到TINYOS_MUTEX_CHAIN_MAX而截断的次数
+static uint32_t g_uiMutexChainDepthMax;
+static uint32_t g_uiMutexChainTruncCnt;
+
+/**********************************************************************************************************
+** Function name        :   prvMutexSetPrio
+** Descriptions         :   修改任务的优先级，任务处于就绪状态时同时调整其在就绪表中的位置
+** parameters           :   pxTask 任务
+** parameters           :   uiPrio 新的优先级
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvMutexSetPrio(Task_t * pxTask, uint32_t uiPrio)
+{
+	if(pxTask->uiState == TINYOS_TASK_STATE_RDY)
+	{
+		// 任务处于就绪状态时，更改任务在就绪表中的位置
+		vTaskSchedUnRdy(pxTask);
+		pxTask->uiPrio = uiPrio;
+		vTaskSchedRdy(pxTask);
+	}
+	else if(pxTask->pxWaitEvent)
+	{
+		// 等待事件的任务，在按优先级排列的等待队列中同时调整位置
+		vEventTaskSetPrio(pxTask, uiPrio);
+	}
+	else
+	{
+		// 其它任务状态，只需要修改优先级
+		pxTask->uiPrio = uiPrio;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvMutexTaskPrio
+** Descriptions         :   根据任务的基础优先级与持有的所有互斥量计算应有的优先级：
+**                          取基础优先级、天花板互斥量的天花板与各互斥量上等待者的优先级中最高的一个
+** parameters           :   pxTask 任务
+** Returned value       :   优先级
+***********************************************************************************************************/
+static uint32_t prvMutexTaskPrio(Task_t * pxTask)
+{
+	uint32_t uiPrio = pxTask->uiBasePrio;
+	Node_t * pxHeld;
+	Node_t * pxWait;
+	
+	for(pxHeld = pxListFirst(&pxTask->xMutexHeldList); pxHeld; pxHeld = pxListNext(&pxTask->xMutexHeldList, pxHeld))
+	{
+		Mutex_t * pxMutex = pxNodeParent(pxHeld, Mutex_t, xHeldNode);
+		
+		if(pxMutex->uiCeiling < uiPrio)
+			uiPrio = pxMutex->uiCeiling;
+		for(pxWait = pxListFirst(&pxMutex->xEvent.xWaitList); pxWait; pxWait = pxListNext(&pxMutex->xEvent.xWaitList, pxWait))
+		{
+			Task_t * pxWaiter = pxNodeParent(pxWait, Task_t, xEventNode);
+			if(pxWaiter->uiPrio < uiPrio)
+				uiPrio = pxWaiter->uiPrio;
+			
+			// 按优先级排列时首个等待者的优先级最高
+			if(pxMutex->xEvent.eOrder == eEventOrderPrio)
+				break;
+		}
+	}
+	return uiPrio;
+}
+
+/**********************************************************************************************************
+** Function name        :   vMutexPrioUpdate
+** Descriptions         :   重新计算任务的优先级。任务正在等待另一个互斥量时，变化沿阻塞链传递给该互斥量的拥有者，
+**                          直到优先级不再变化或经过TINYOS_MUTEX_CHAIN_MAX个互斥量。需在临界区内调用
+** parameters           :   pxTask 持有的互斥量、等待者或基础优先级发生变化的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexPrioUpdate(Task_t * pxTask)
+{
+	uint32_t uiDepth = 0;
+	uint32_t uiPrio;
+	
+	for(;;)
+	{
+		uiPrio = prvMutexTaskPrio(pxTask);
+		if(uiPrio == pxTask->uiPrio)
+			break;
+		prvMutexSetPrio(pxTask, uiPrio);
+		uiDepth++;
+		
+		// 任务的优先级是其等待的互斥量的拥有者的继承来源
+		if(!pxTask->pxWaitEvent || pxTask->pxWaitEvent->eType != eEventTYpeMutex)
+			break;
+		if(uiDepth == TINYOS_MUTEX_CHAIN_MAX)
+		{
+			g_uiMutexChainTruncCnt++;
+			break;
+		}
+		pxTask = ((Mutex_t *)pxTask->pxWaitEvent)->pxOwner;
+	}
+	
+	if(uiDepth > g_uiMutexChainDepthMax)
+		g_uiMutexChainDepthMax = uiDepth;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvMutexTake
+** Descriptions         :   任务成为互斥量的拥有者
+** parameters           :   pxMutex 互斥信号量
+** parameters           :   pxTask 新的拥有者
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvMutexTake(Mutex_t * pxMutex, Task_t * pxTask)
+{
+	pxMutex->pxOwner = pxTask;
+	pxMutex->uiLockedCnt++;
+	vListAddLast(&pxTask->xMutexHeldList, &pxMutex->xHeldNode);
+}
+
+/**********************************************************************************************************
+** Function name        :   vMutexInit
+** Descriptions         :   初始化互斥信号量
+** parameters           :   mutex 等待初始化的互斥信号量
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexInit(Mutex_t * pxMutex)
+{
+	vEventInit(&pxMutex->xEvent, eEventTYpeMutex);
+	
+	pxMutex->uiLockedCnt = 0;
+	pxMutex->pxOwner = (Task_t *)0;
+	pxMutex->uiCeiling = TINYOS_PRO_COUNT;
+	vNodeInit(&pxMutex->xHeldNode);
+}
+
+/**********************************************************************************************************
+** Function name        :   vMutexInitCeiling
+** Descriptions         :   初始化使用立即天花板优先级协议的互斥信号量：任务加锁时立即提升到天花板优先级，
+**                          解锁时恢复。天花板应不低于所有使用该互斥量的任务中最高的优先级，此时单核上
+**                          持有者不阻塞就不会发生竞争，也不会在这类互斥量之间死锁
+** parameters           :   pxMutex 等待初始化的互斥信号量
+** parameters           :   uiCeiling 天花板优先级
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexInitCeiling(Mutex_t * pxMutex, uint32_t uiCeiling)
+{
+	vMutexInit(pxMutex);
+	pxMutex->uiCeiling = uiCeiling;
+}
+
+
+/**********************************************************************************************************
+** Function name        :   uiMutexWait
+** Descriptions         :   等待信号量
+** parameters           :   pxMutex 等待的信号量
+** parameters           :   uiWaitTicks 最大等待的ticks数，为0表示无限等待
+** Returned value       :   等待结果,tErrorResourceUnavaliable.tErrorNoError,tErrorTimeout
+***********************************************************************************************************/
+uint32_t uiMutexWait(Mutex_t * pxMutex, uint32_t uiWaitTicks)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	if(pxMutex->uiLockedCnt <= 0)
+	{
+		// 如果没有锁定，则使用当前任务进行锁定
+		prvMutexTake(pxMutex, pxCurrentTask);
+		
+		// 天花板互斥量立即提升优先级，当前任务优先级更高，不会被抢占
+		if(pxMutex->uiCeiling < pxCurrentTask->uiPrio)
+			prvMutexSetPrio(pxCurrentTask, pxMutex->uiCeiling);
+		vTaskExitCritical(uiStatus);
+		return eErrorNoError;
+	}
+	else
+	{
+		// 信号量已经被锁定
+		if(pxMutex->pxOwner == pxCurrentTask)
+		{
+			// 如果是信号量的拥有者再次wait，简单增加计数
+			pxMutex->uiLockedCnt++;
+			vTaskExitCritical(uiStatus);
+			return eErrorNoError;
+		}
+		else
+		{
+			// 当前任务进入等待队列中
+			vEventWait(&pxMutex->xEvent, pxCurrentTask, (void *)0, eEventTYpeMutex, uiWaitTicks);
+			
+			// 当前任务的优先级更高时，拥有者继承该优先级；拥有者也在等待互斥量时继续向下传递。
+			// 天花板互斥量的拥有者通常已经不低于等待者，不会发生变化
+			vMutexPrioUpdate(pxMutex->pxOwner);
+			vTaskExitCritical(uiStatus);
+			// 执行调度， 切换至其它任务
+			vTaskSched();
+			return pxCurrentTask->uiWaitEventResult;
+		}
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   uiMutexNoWaitGet
+** Descriptions         :   获取信号量，如果已经被锁定，立即返回
+** parameters           :   pxMutex 获取的信号量
+** Returned value       :   获取结果, tErrorResourceUnavaliable.tErrorNoError
+***********************************************************************************************************/
+uint32_t uiMutexNoWaitGet(Mutex_t * pxMutex)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	if(pxMutex->uiLockedCnt <= 0)
+	{
+		// 如果没有锁定，则使用当前任务进行锁定
+		prvMutexTake(pxMutex, pxCurrentTask);
+		if(pxMutex->uiCeiling < pxCurrentTask->uiPrio)
+			prvMutexSetPrio(pxCurrentTask, pxMutex->uiCeiling);
+		vTaskExitCritical(uiStatus);
+		return eErrorNoError;
+	}
+	else
+	{
+		// 信号量已经被锁定
+		if(pxMutex->pxOwner == pxCurrentTask)
+		{
+			// 如果是信号量的拥有者再次wait，简单增加计数
+			pxMutex->uiLockedCnt++;
+			vTaskExitCritical(uiStatus);
+			return eErrorNoError;
+		}
+		
+		vTaskExitCritical(uiStatus);
+		return eErrorResourceUnavaliable;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   uiMutexNotify
+** Descriptions         :   通知互斥信号量可用
+** parameters           :   pxMutex 操作的信号量
+** Returned value       :   tErrorResourceFull
+***********************************************************************************************************/
+uint32_t uiMutexNotify(Mutex_t * pxMutex)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	uint32_t uiResched = 0;
+	
+	if(pxMutex->uiLockedCnt <= 0)
+	{
+		// 锁定计数为0，信号量未被锁定，直接退出
+		vTaskExitCritical(uiStatus);
+		return eErrorNoError;
+	}
+	
+	if(pxMutex->pxOwner != pxCurrentTask)
+	{
+		// 不是拥有者释放，认为是非法
+		vTaskExitCritical(uiStatus);
+		return eErrorOwner;
+	}
+	
+	if(--pxMutex->uiLockedCnt > 0)
+	{
+		// 减1后计数仍不为0, 直接退出，不需要唤醒等待的任务
+		vTaskExitCritical(uiStatus);
+		return eErrorOwner;
+	}
+	
+	vListRemove(&pxCurrentTask->xMutexHeldList, &pxMutex->xHeldNode);
+	pxMutex->pxOwner = (Task_t *)0;
+	
+	if(uiEventWaitCount(&pxMutex->xEvent) > 0)
+	{
+		// 如果有的话，则直接唤醒位于队列首部（最先等待）的任务
+		Task_t * pxTask = pxEventWakeUp(&pxMutex->xEvent, (void *)0, eErrorNoError);
+		
+		// 新的拥有者继承剩余等待者的优先级，或提升到天花板
+		prvMutexTake(pxMutex, pxTask);
+		vMutexPrioUpdate(pxTask);
+		uiResched = 1;
+	}
+	
+	// 只有被提升过的任务才需要重新计算，仍持有的其它互斥量上的继承保留
+	if(pxCurrentTask->uiPrio != pxCurrentTask->uiBasePrio)
+	{
+		vMutexPrioUpdate(pxCurrentTask);
+		uiResched = 1;
+	}
+	
+	// 被唤醒的任务或持有期间就绪的任务可能高于恢复后的优先级
+	if(uiResched)
+		vTaskSched();
+	vTaskExitCritical(uiStatus);
+	return eErrorNoError;
+}
+
+/**********************************************************************************************************
+** Function name        :   vMutexWaiterRemoved
+** Descriptions         :   等待者因超时等原因离开等待队列后调用，拥有者不再继承它的优先级
+** parameters           :   pxMutex 互斥信号量
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexWaiterRemoved(Mutex_t * pxMutex)
+{
+	if(pxMutex->pxOwner)
+		vMutexPrioUpdate(pxMutex->pxOwner);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiMutexDestroy
+** Descriptions         :   销毁信号量
+** parameters           :   pxMutex 销毁互斥信号量
+** Returned value       :   因销毁该信号量而唤醒的任务数量
+***********************************************************************************************************/
+uint32_t uiMutexDestroy(Mutex_t * pxMutex)
+{
+	uint32_t uiCnt = 0;
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	// 信号量是否已经被锁定，未锁定时没有任务等待，不必处理
+	if(pxMutex->uiLockedCnt > 0)
+	{
+		// 清空事件控制块中的任务
+		uiCnt = uiEventRemoveAll(&pxMutex->xEvent, (void *)0, eErrorDel);
+		
+		// 清空过程中可能有任务就绪，执行一次调度；拥有者不再继承等待者的优先级
+		if(uiCnt)
+		{
+			vMutexPrioUpdate(pxMutex->pxOwner);
+			vTaskSched();
+		}
+	}
+	vTaskExitCritical(uiStatus);
+	return uiCnt;
+}
+
+/**********************************************************************************************************
+** Function name        :   vMutexGetInfo
+** Descriptions         :   查询状态信息
+** parameters           :   pxMutex 查询的互斥信号量
+** parameters           :   pxInfo 状态查询存储的位置
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexGetInfo (Mutex_t * pxMutex, MutexInfo_t * pxInfo)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	pxInfo->uiTaskCnt = uiEventWaitCount(&pxMutex->xEvent);
+	
+	if(pxMutex->pxOwner != (Task_t *)0)
+	{
+		pxInfo->uiOwnerPrio = pxMutex->pxOwner->uiBasePrio;
+		pxInfo->uiInheritedPrio = pxMutex->pxOwner->uiPrio;
+	}
+	else
+	{
+		pxInfo->uiOwnerPrio = TINYOS_PRO_COUNT;
+		pxInfo->uiInheritedPrio = TINYOS_PRO_COUNT;
+	}
+	pxInfo->pxOwner = pxMutex->pxOwner;
+	pxInfo->uiLockedCnt = pxMutex->uiLockedCnt;
+	pxInfo->uiCeiling = pxMutex->uiCeiling;
+	
+	vTaskExitCritical(uiStatus);	
+}
+
+/**********************************************************************************************************
+** Function name        :   vMutexGetChainInfo
+** Descriptions         :   查询优先级继承沿阻塞链传递的统计
+** parameters           :   pxInfo 统计存储的位置
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexGetChainInfo (MutexChainInfo_t * pxInfo)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	pxInfo->uiDepthMax = g_uiMutexChainDepthMax;
+	pxInfo->uiTruncCnt = g_uiMutexChainTruncCnt;
+	vTaskExitCritical(uiStatus);
+}
@@ -1,86 +1,136 @@
-#ifndef TMUTEX_H
-#define TMUTEX_H
-
-#include "tConfig.h"
-#include "tEvent.h"
-
-typedef struct {
-	// 事件控制块
-	Event_t xEvent;
-	// 已被锁定的次数
-	uint32_t uiLockedCnt;
-	// 拥有者
-	Task_t * pxOwner;
-	// 拥有者原始的优先级
-	uint32_t uiOwnerOriginalPrio;
-}Mutex_t;
-
-// 互斥信号量查询结构
-typedef struct  {
-    // 等待的任务数量
-    uint32_t uiTaskCnt;
-
-    // 拥有者任务的优先级
-    uint32_t uiOwnerPrio;
-
-    // 继承优先级
-    uint32_t uiInheritedPrio;
-
-    // 当前信号量的拥有者
-    Task_t * pxOwner;
-
-    // 锁定次数
-    uint32_t uiLockedCnt;
-}MutexInfo_t;
-
-/**********************************************************************************************************
-** Function name        :   vMutexInit
-** Descriptions         :   初始化互斥信号量
-** parameters           :   mutex 等待初始化的互斥信号量
-** Returned value       :   无
-***********************************************************************************************************/
-void vMutexInit(Mutex_t * pxMutex);
-
-/**********************************************************************************************************
-** Function name        :   uiMutexWait
-** Descriptions         :   等待信号量
-** parameters           :   pxMutex 等待的信号量
-** parameters           :   uiWaitTicks 最大等待的ticks数，为0表示无限等待
-** Returned value       :   等待结果,tErrorResourceUnavaliable.tErrorNoError,tErrorTimeout
-***********************************************************************************************************/
-uint32_t uiMutexWait(Mutex_t * pxMutex, uint32_t uiWaitTicks);
-
-/**********************************************************************************************************
-** Function name        :   uiMutexNoWaitGet
-** Descriptions         :   获取信号量，如果已经被锁定，立即返回
-** parameters           :   pxMutex 获取的信号量
-** Returned value       :   获取结果, tErrorResourceUnavaliable.tErrorNoError
-***********************************************************************************************************/
-uint32_t uiMutexNoWaitGet(Mutex_t * pxMutex);
-
-/**********************************************************************************************************
-** Function name        :   uiMutexNotify
-** Descriptions         :   通知互斥信号量可用
-** parameters           :   pxMutex 操作的信号量
-** Returned value       :   tErrorResourceFull
-***********************************************************************************************************/
-uint32_t uiMutexNotify(Mutex_t * pxMutex);
-
-/**********************************************************************************************************
-** Function name        :   uiMutexDestroy
-** Descriptions         :   销毁信号量
-** parameters           :   pxMutex 销毁互斥信号量
-** Returned value       :   因销毁该信号量而唤醒的任务数量
-***********************************************************************************************************/
-uint32_t uiMutexDestroy(Mutex_t * pxMutex);
-
-/**********************************************************************************************************
-** Function name        :   vMutexGetInfo
-** Descriptions         :   查询状态信息
-** parameters           :   pxMutex 查询的互斥信号量
-** parameters           :   pxInfo 状态查询存储的位置
-** Returned value       :   无
-***********************************************************************************************************/
-void vMutexGetInfo (Mutex_t * pxMutex, MutexInfo_t * pxInfo);
-
-#endif /* TMUTEX_H */
+#ifndef TMUTEX_H
+#define TMUTEX_H
+
+#include "tConfig.h"
+#include "tEvent.h"
+
+typedef struct {
+	// 事件控制块
+	Event_t xEvent;
+	// 已被锁定的次数
+	uint32_t uiLockedCnt;
+	// 拥有者
+	Task_t * pxOwner;
+	// 天花板优先级，为TINYOS_PRO_COUNT时使用优先级继承
+	uint32_t uiCeiling;
+	// 拥有者持有的互斥量链表结点
+	Node_t xHeldNode;
+}Mutex_t;
+
+// 互斥信号量查询结构
+typedef struct  {
+    // 等待的任务数量
+    uint32_t uiTaskCnt;
+
+    // 拥有者任务不含继承的优先级
+    uint32_t uiOwnerPrio;
+
+    // 继承优先级
+    uint32_t uiInheritedPrio;
+
+    // 当前信号量的拥有者
+    Task_t * pxOwner;
+
+    // 锁定次数
+    uint32_t uiLockedCnt;
+
+    // 天花板优先级
+    uint32_t uiCeiling;
+}MutexInfo_t;
+
+// 优先级继承沿阻塞链传递的统计
+typedef struct {
+    // 一次传递中优先级发生变化的任务数量的最大值
+    uint32_t uiDepthMax;
+
+    // 达到TINYOS_MUTEX_CHAIN_MAX而停止传递的次数
+    uint32_t uiTruncCnt;
+}MutexChainInfo_t;
+
+/**********************************************************************************************************
+** Function name        :   vMutexInit
+** Descriptions         :   初始化互斥信号量
+** parameters           :   mutex 等待初始化的互斥信号量
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexInit(Mutex_t * pxMutex);
+
+/**********************************************************************************************************
+** Function name        :   vMutexInitCeiling
+** Descriptions         :   初始化使用立即天花板优先级协议的互斥信号量：任务加锁时立即提升到天花板优先级，
+**                          解锁时恢复。天花板应不低于所有使用该互斥量的任务中最高的优先级，此时单核上
+**                          持有者不阻塞就不会发生竞争，也不会在这类互斥量之间死锁
+** parameters           :   pxMutex 等待初始化的互斥信号量
+** parameters           :   uiCeiling 天花板优先级
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexInitCeiling(Mutex_t * pxMutex, uint32_t uiCeiling);
+
+/**********************************************************************************************************
+** Function name        :   uiMutexWait
+** Descriptions         :   等待信号量
+** parameters           :   pxMutex 等待的信号量
+** parameters           :   uiWaitTicks 最大等待的ticks数，为0表示无限等待
+** Returned value       :   等待结果,tErrorResourceUnavaliable.tErrorNoError,tErrorTimeout
+***********************************************************************************************************/
+uint32_t uiMutexWait(Mutex_t * pxMutex, uint32_t uiWaitTicks);
+
+/**********************************************************************************************************
+** Function name        :   uiMutexNoWaitGet
+** Descriptions         :   获取信号量，如果已经被锁定，立即返回
+** parameters           :   pxMutex 获取的信号量
+** Returned value       :   获取结果, tErrorResourceUnavaliable.tErrorNoError
+***********************************************************************************************************/
+uint32_t uiMutexNoWaitGet(Mutex_t * pxMutex);
+
+/**********************************************************************************************************
+** Function name        :   uiMutexNotify
+** Descriptions         :   通知互斥信号量可用
+** parameters           :   pxMutex 操作的信号量
+** Returned value       :   tErrorResourceFull
+***********************************************************************************************************/
+uint32_t uiMutexNotify(Mutex_t * pxMutex);
+
+/**********************************************************************************************************
+** Function name        :   uiMutexDestroy
+** Descriptions         :   销毁信号量
+** parameters           :   pxMutex 销毁互斥信号量
+** Returned value       :   因销毁该信号量而唤醒的任务数量
+***********************************************************************************************************/
+uint32_t uiMutexDestroy(Mutex_t * pxMutex);
+
+/**********************************************************************************************************
+** Function name        :   vMutexGetInfo
+** Descriptions         :   查询状态信息
+** parameters           :   pxMutex 查询的互斥信号量
+** parameters           :   pxInfo 状态查询存储的位置
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexGetInfo (Mutex_t * pxMutex, MutexInfo_t * pxInfo);
+
+/**********************************************************************************************************
+** Function name        :   vMutexGetChainInfo
+** Descriptions         :   查询优先级继承沿阻塞链传递的统计
+** parameters           :   pxInfo 统计存储的位置
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexGetChainInfo (MutexChainInfo_t * pxInfo);
+
+/**********************************************************************************************************
+** Function name        :   vMutexPrioUpdate
+** Descriptions         :   重新计算任务的优先级。任务正在等待另一个互斥量时，变化沿阻塞链传递给该互斥量的拥有者，
+**                          直到优先级不再变化或经过TINYOS_MUTEX_CHAIN_MAX个互斥量。需在临界区内调用
+** parameters           :   pxTask 持有的互斥量、等待者或基础优先级发生变化的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexPrioUpdate(Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vMutexWaiterRemoved
+** Descriptions         :   等待者因超时等原因离开等待队列后调用，拥有者不再继承它的优先级
+** parameters           :   pxMutex 互斥信号量
+** Returned value       :   无
+***********************************************************************************************************/
+void vMutexWaiterRemoved(Mutex_t * pxMutex);
+
+#endif /* TMUTEX_H */
@@ -0,0 +1,1100 @@
+// 本文件实现临界区本身，不使用临界区测量的替换版本
+#define TINYOS_CRITICAL_PROFILE_IMPL
+#include "tinyOS.h"
+
+#ifdef TINYOS_PORT_LINUX
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ucontext.h>
+#if TINYOS_ENABLE_SMP
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/****************** 宏/变量定义 ****************************/
+
+// 每个任务在主机上的运行上下文
+// x86的信号帧与函数调用帧远大于Cortex-M3，任务自带的堆栈数组不足以承载，
+// 因此任务实际运行在单独分配的主机堆栈上，Task_t::pxStack指向该结构
+typedef struct {
+	TaskStack_t * puiStackBase;          // 所属任务的堆栈数组，任务重新创建时据此复用该结构
+	ucontext_t xContext;                 // 保存的寄存器现场
+	void * pvHostStack;                  // 主机堆栈
+	TaskFunction_pt pxTaskCode;          // 任务的入口函数
+	void * pvParam;                      // 传递给任务的运行参数
+#if TINYOS_ENABLE_STACK_PROFILE
+	int iStarted;                        // 任务已经开始运行
+#endif
+}PortContext_t;
+
+static PortContext_t xPortContextTable[TINYOS_PORT_MAX_TASKS];
+
+#if TINYOS_ENABLE_SMP
+// SMP时每个核由一个主机线程模拟，线程局部变量记录线程所代表的核
+#define PORT_CORES                     TINYOS_CORE_COUNT
+#define prvPortCore()                  uiPortCoreId()
+
+static __thread uint32_t uiPortThisCore;
+static uint32_t uiPortCores;                               // 实际运行的核数
+static pthread_t xPortCoreThread[TINYOS_CORE_COUNT];
+static int iPortCoreStarted[TINYOS_CORE_COUNT];
+
+// 内核锁：屏蔽本核的信号后再加锁。同一个核上嵌套进入临界区（包括信号处理函数中）只在最外层加锁
+static Spinlock_t xPortKernelLock;
+static uint32_t uiPortLockDepth[TINYOS_CORE_COUNT];
+
+static void * prvPortCoreEntry (void * pvParam);
+static void prvPortCoreSignalHandler (int iSignal);
+#else
+#define PORT_CORES                     1
+#define prvPortCore()                  0
+#endif
+
+// 启动调度器前main()（SMP时为各核线程）所在的上下文，第一次切换时保存到这里，此后不再使用
+static ucontext_t xPortMainContext[PORT_CORES];
+
+// 相当于PendSV的挂起位，每个核一个
+static volatile sig_atomic_t iPortSwitchPending[PORT_CORES];
+
+static timer_t xPortTickTimer;
+static int iPortTickTimerCreated;
+
+#if TINYOS_SIM_VIRTUAL_TIME
+static uint32_t uiSimMasked;                 // 代替信号屏蔽的临界区标志
+static int iSimStarted;
+static uint64_t ullSimTicks;                 // 已仿真的节拍数
+static uint64_t ullSimEndTicks;              // 仿真结束的节拍数
+static uint64_t ullSimTickEvents;            // 实际执行节拍处理的次数，其余节拍被直接跳过
+static uint64_t ullSimSwitches;              // 任务切换的次数
+static uint32_t uiSimSeed;
+static uint32_t uiSimRandomState;
+static struct timespec xSimStartTime;
+#if TINYOS_ENABLE_TICKLESS
+static int iSimTickPending;                  // 低功耗空闲的一次性唤醒到期，退出临界区时执行节拍处理
+#endif
+#if TINYOS_ENABLE_IDLE_GOVERNOR
+static uint32_t uiSimIrqTicks;               // 模拟的外部中断的平均间隔(节拍)，0表示没有
+static uint32_t uiSimIrqRandomState;         // 外部中断单独使用的随机数，不影响应用的随机序列
+static uint64_t ullSimIrqNextUs;             // 下一个外部中断到达的时刻(us)
+static uint32_t uiSimTickOffsetUs;           // 被外部中断唤醒时在当前节拍内已经过的时间(us)
+#endif
+
+static void prvPortSimSetup (void);
+static void prvPortSimTick (void);
+static void prvPortSimReport (void);
+#endif
+
+extern void SysTick_Handler(void);
+extern uint32_t uiTickCount;
+
+#if TINYOS_ENABLE_STACK_PROFILE
+// 中断处理函数运行在被打断任务的主机堆栈上，调用前填充调用者栈顶以下的一段，返回后查看被改写的深度
+#define PORT_ISR_PROBE_WORDS           4096                     // 填充的字数
+#define PORT_ISR_PROBE_GAP             64                       // 填充部分与调用者栈顶之间留出的字数
+static uint32_t uiPortIsrStackPeak;
+
+static void prvPortIsrCall (void (*pxHandler)(void));
+#else
+#define prvPortIsrCall(pxHandler)      (pxHandler)()
+#endif
+
+static void prvPortPendSV (void);
+static void prvPortTaskEntry (void);
+static void prvPortTickHandler (int iSignal);
+static void prvPortIsrEnter (void);
+static void prvPortIsrExit (void);
+static void prvPortSignalMask (sigset_t * pxMask);
+
+/**********************************************************************************************************
+** Function name        :   uiTaskEnterCritical
+** Descriptions         :   进入临界区，屏蔽节拍信号
+** parameters           :   无
+** Returned value       :   进入临界区之前的屏蔽状态，1表示已屏蔽
+***********************************************************************************************************/
+uint32_t uiTaskEnterCritical (void)
+{
+#if TINYOS_SIM_VIRTUAL_TIME
+	// 仿真模式下没有异步信号，用一个标志代替信号屏蔽即可，省去系统调用
+	uint32_t uiStatus = uiSimMasked;
+	uiSimMasked = 1;
+	return uiStatus;
+#else
+	sigset_t xMask, xOldMask;
+
+	prvPortSignalMask(&xMask);
+	sigprocmask(SIG_BLOCK, &xMask, &xOldMask);
+#if TINYOS_ENABLE_SMP
+	if(uiPortLockDepth[uiPortCoreId()]++ == 0)
+		vSpinlockLock(&xPortKernelLock);
+#endif
+	return sigismember(&xOldMask, TINYOS_PORT_TICK_SIGNAL);
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskExitCritical
+** Descriptions         :   退出临界区。恢复为不屏蔽状态前，先执行挂起的任务切换，与PendSV的行为一致
+** parameters           :   uiStatus 进入临界区之前的屏蔽状态
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskExitCritical (uint32_t uiStatus)
+{
+	sigset_t xMask;
+
+	// 嵌套的临界区或者在节拍中断中，保持屏蔽
+	if(uiStatus)
+	{
+#if TINYOS_ENABLE_SMP
+		if(--uiPortLockDepth[uiPortCoreId()] == 0)
+			vSpinlockUnlock(&xPortKernelLock);
+#endif
+		return;
+	}
+
+#if TINYOS_SIM_VIRTUAL_TIME && TINYOS_ENABLE_TICKLESS
+	// 相当于开中断时执行挂起的节拍中断
+	if(iSimTickPending)
+	{
+		iSimTickPending = 0;
+		prvPortSimTick();
+	}
+#endif
+
+	if(iPortSwitchPending[prvPortCore()])
+		prvPortPendSV();
+
+#if TINYOS_SIM_VIRTUAL_TIME
+	(void)xMask;
+	uiSimMasked = 0;
+#else
+#if TINYOS_ENABLE_SMP
+	// 切换回来时可能已经在另一个核上，重新取核的序号
+	if(--uiPortLockDepth[uiPortCoreId()] == 0)
+		vSpinlockUnlock(&xPortKernelLock);
+#endif
+	prvPortSignalMask(&xMask);
+	sigprocmask(SIG_UNBLOCK, &xMask, (sigset_t *)0);
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   pxTaskStackInit
+** Descriptions         :   为任务分配主机上下文，并构造从prvPortTaskEntry开始运行的初始现场
+** parameters           :   puiStackBase     任务堆栈的起始地址（低地址）
+** parameters           :   uiStackSize      任务堆栈大小（字节）
+** parameters           :   pxTaskCode       任务的入口函数
+** parameters           :   pvParam          传递给任务的运行参数
+** Returned value       :   任务的主机上下文
+***********************************************************************************************************/
+TaskStack_t * pxTaskStackInit(TaskStack_t * puiStackBase, uint32_t uiStackSize, TaskFunction_pt pxTaskCode, void * pvParam)
+{
+	PortContext_t * pxContext = (PortContext_t *)0;
+	int i;
+
+	(void)uiStackSize;
+
+	// 同一个堆栈数组重新创建任务时，复用原来的上下文
+	for(i = 0; i < TINYOS_PORT_MAX_TASKS; i++)
+	{
+		if(xPortContextTable[i].puiStackBase == puiStackBase)
+		{
+			pxContext = &xPortContextTable[i];
+			break;
+		}
+		if(!pxContext && !xPortContextTable[i].puiStackBase)
+		{
+			pxContext = &xPortContextTable[i];
+		}
+	}
+
+	if(!pxContext)
+	{
+		fprintf(stderr, "tinyOS: more than %d tasks, increase TINYOS_PORT_MAX_TASKS\n", TINYOS_PORT_MAX_TASKS);
+		abort();
+	}
+
+	if(!pxContext->pvHostStack)
+	{
+		pxContext->pvHostStack = malloc(TINYOS_PORT_HOST_STACK_SIZE);
+		if(!pxContext->pvHostStack)
+			abort();
+	}
+
+	pxContext->puiStackBase = puiStackBase;
+	pxContext->pxTaskCode = pxTaskCode;
+	pxContext->pvParam = pvParam;
+#if TINYOS_ENABLE_STACK_PROFILE
+	{
+		uint32_t * puiWord = (uint32_t *)pxContext->pvHostStack;
+		
+		// 填充整个主机堆栈，从底部开始保持原样的部分没有用过
+		for(i = 0; i < TINYOS_PORT_HOST_STACK_SIZE / (int)sizeof(uint32_t); i++)
+			puiWord[i] = TINYOS_STACK_PROFILE_PAINT;
+		pxContext->iStarted = 0;
+	}
+#endif
+
+	getcontext(&pxContext->xContext);
+	pxContext->xContext.uc_stack.ss_sp = pxContext->pvHostStack;
+	pxContext->xContext.uc_stack.ss_size = TINYOS_PORT_HOST_STACK_SIZE;
+	pxContext->xContext.uc_link = (ucontext_t *)0;
+#if TINYOS_ENABLE_SMP
+	// 新任务在持有内核锁时被切换进来，由prvPortTaskEntry解锁后再开中断
+	prvPortSignalMask(&pxContext->xContext.uc_sigmask);
+#else
+	sigemptyset(&pxContext->xContext.uc_sigmask);           // 新任务以开中断状态开始运行
+#endif
+	makecontext(&pxContext->xContext, prvPortTaskEntry, 0);
+
+	return (TaskStack_t *)pxContext;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskStartScheduler
+** Descriptions         :   在启动tinyOS时，调用该函数，将切换至第一个任务运行
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskStartScheduler(void)
+{
+	uiTaskEnterCritical();
+#if TINYOS_ENABLE_SMP
+	{
+		// 启动其它核的线程，它们继承屏蔽状态，等本核切换到第一个任务释放内核锁后才开始调度
+		struct sigaction xAction;
+		uint32_t i;
+
+		xAction.sa_handler = prvPortCoreSignalHandler;
+		xAction.sa_flags = SA_RESTART;
+		prvPortSignalMask(&xAction.sa_mask);
+		sigaction(TINYOS_PORT_IPI_SIGNAL, &xAction, (struct sigaction *)0);
+
+		xPortCoreThread[0] = pthread_self();
+		iPortCoreStarted[0] = 1;
+		for(i = 1; i < uiPortCoreCount(); i++)
+		{
+			if(pthread_create(&xPortCoreThread[i], (pthread_attr_t *)0, prvPortCoreEntry, (void *)(uintptr_t)i) != 0)
+			{
+				perror("tinyOS: pthread_create");
+				abort();
+			}
+			iPortCoreStarted[i] = 1;
+		}
+	}
+#endif
+	prvPortPendSV();
+
+	// 与硬件版本一样，不会返回到这里
+	abort();
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskSwitch
+** Descriptions         :   调用后进行一次任务切换，调用前需要先设置好pxCurrentTask和pxNextTask
+**                          在临界区或节拍中断中调用时，切换推迟到退出时进行
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSwitch(void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	iPortSwitchPending[prvPortCore()] = 1;
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vSetSysTickPeriod
+** Descriptions         :   设置定时器中断触发的间隔，使用POSIX间隔定时器周期性发出节拍信号
+** parameters           :   ms 节拍间隔
+** Returned value       :   无
+***********************************************************************************************************/
+void vSetSysTickPeriod(uint32_t ms)
+{
+	struct sigaction xAction;
+	struct sigevent xEvent;
+	struct itimerspec xSpec;
+
+#if TINYOS_SIM_VIRTUAL_TIME
+	// 仿真模式下节拍由空闲任务驱动，不产生任何信号，从此开始计算墙上时间
+	(void)ms; (void)xAction; (void)xEvent; (void)xSpec;
+	prvPortSimSetup();
+	clock_gettime(CLOCK_MONOTONIC, &xSimStartTime);
+	return;
+#endif
+
+	xAction.sa_handler = prvPortTickHandler;
+	xAction.sa_flags = SA_RESTART;
+	prvPortSignalMask(&xAction.sa_mask);
+	sigaction(TINYOS_PORT_TICK_SIGNAL, &xAction, (struct sigaction *)0);
+
+	if(!iPortTickTimerCreated)
+	{
+		xEvent.sigev_notify = SIGEV_SIGNAL;
+		xEvent.sigev_signo = TINYOS_PORT_TICK_SIGNAL;
+		xEvent.sigev_value.sival_ptr = (void *)0;
+		if(timer_create(CLOCK_MONOTONIC, &xEvent, &xPortTickTimer) != 0)
+		{
+			perror("tinyOS: timer_create");
+			abort();
+		}
+		iPortTickTimerCreated = 1;
+	}
+
+	xSpec.it_interval.tv_sec = ms / 1000;
+	xSpec.it_interval.tv_nsec = (ms % 1000) * 1000000L;
+	xSpec.it_value = xSpec.it_interval;
+	timer_settime(xPortTickTimer, 0, &xSpec, (struct itimerspec *)0);
+}
+
+/**********************************************************************************************************
+** Function name        :   vPortTimestampInit
+** Descriptions         :   主机上直接使用单调时钟，无需初始化
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortTimestampInit(void)
+{
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortTimestamp
+** Descriptions         :   读取单调时钟的纳秒数
+** parameters           :   无
+** Returned value       :   纳秒数的低32位
+***********************************************************************************************************/
+uint32_t uiPortTimestamp(void)
+{
+	struct timespec xNow;
+	clock_gettime(CLOCK_MONOTONIC, &xNow);
+	return (uint32_t)((uint64_t)xNow.tv_sec * 1000000000ULL + xNow.tv_nsec);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortTimestampFreq
+** Descriptions         :   时间戳的计数频率
+** parameters           :   无
+** Returned value       :   1GHz
+***********************************************************************************************************/
+uint32_t uiPortTimestampFreq(void)
+{
+	return 1000000000;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortClockPhase
+** Descriptions         :   当前节拍内已经过的纳秒数。虚拟时间仿真中节拍之间不经过时间；主机上由节拍定时器
+**                          到下一次到期的剩余时间得出，相当于硬件的递减计数器
+** parameters           :   puiPending 存放是否有未处理的节拍
+** Returned value       :   纳秒数
+***********************************************************************************************************/
+uint32_t uiPortClockPhase(uint32_t * puiPending)
+{
+#if TINYOS_SIM_VIRTUAL_TIME
+	// 低功耗空闲的一次性唤醒到期后，虚拟时钟已经推进，节拍在退出临界区时才处理
+#if TINYOS_ENABLE_TICKLESS
+	*puiPending = iSimTickPending ? 1 : 0;
+#else
+	*puiPending = 0;
+#endif
+#if TINYOS_ENABLE_IDLE_GOVERNOR
+	return uiSimTickOffsetUs * 1000;
+#else
+	return 0;
+#endif
+#else
+	const int64_t llTickNs = TINYOS_ONE_TICK_TO_MS * 1000000LL;
+	struct itimerspec xSpec;
+	sigset_t xPending;
+	int64_t llLeft;
+
+	*puiPending = 0;
+	if(!iPortTickTimerCreated)
+		return 0;
+
+	// 先读剩余时间再查挂起的信号：到期发生在两者之间时，挂起的节拍使结果从新的节拍开始，只是略小
+	timer_gettime(xPortTickTimer, &xSpec);
+	sigpending(&xPending);
+	if(sigismember(&xPending, TINYOS_PORT_TICK_SIGNAL))
+	{
+		*puiPending = 1;
+		timer_gettime(xPortTickTimer, &xSpec);
+	}
+
+	llLeft = xSpec.it_value.tv_sec * 1000000000LL + xSpec.it_value.tv_nsec;
+	if(llLeft <= 0 || llLeft > llTickNs)
+		return 0;
+	return (uint32_t)(llTickNs - llLeft);
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   vPortSoftInterrupt
+** Descriptions         :   模拟软件触发的中断。与节拍中断一样在屏蔽状态下执行处理函数，
+**                          处理函数中请求的任务切换推迟到返回时进行，相当于中断退出后的PendSV
+** parameters           :   pxHandler 中断处理函数
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortSoftInterrupt (void (*pxHandler)(void))
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	TRACE_ISR_ENTER(TINYOS_TRACE_IRQ_SOFT);
+	prvPortIsrCall(pxHandler);
+	TRACE_ISR_EXIT(TINYOS_TRACE_IRQ_SOFT);
+	vTaskExitCritical(uiStatus);
+}
+
+#if TINYOS_ENABLE_TICKLESS
+#if TINYOS_SIM_VIRTUAL_TIME
+/**********************************************************************************************************
+** Function name        :   uiPortTicklessSleep
+** Descriptions         :   虚拟时钟直接推进uiTicks个节拍，最后一个节拍在退出临界区时处理
+** parameters           :   uiTicks 到下一个有工作到期的节拍为止的节拍数
+** Returned value       :   需要由内核一次补偿的节拍数，不包括挂起的最后一个节拍
+***********************************************************************************************************/
+uint32_t uiPortTicklessSleep (uint32_t uiTicks)
+{
+	// 最多推进到仿真结束，在最后一个节拍处理中结束仿真
+	if(ullSimEndTicks - ullSimTicks < uiTicks)
+		uiTicks = (uint32_t)(ullSimEndTicks - ullSimTicks);
+
+	ullSimTicks += uiTicks;
+	ullSimTickEvents++;
+	iSimTickPending = 1;
+	return uiTicks - 1;
+}
+#else
+/**********************************************************************************************************
+** Function name        :   uiPortTicklessSleep
+** Descriptions         :   把节拍定时器改为uiTicks个节拍后到期的一次性定时，在屏蔽状态下用sigwaitinfo等待。
+**                          到期的信号被取走后重新发给自己，保持挂起，退出临界区时照常执行节拍处理
+** parameters           :   uiTicks 到下一个有工作到期的节拍为止的节拍数
+** Returned value       :   需要由内核一次补偿的节拍数，不包括挂起的最后一个节拍
+***********************************************************************************************************/
+uint32_t uiPortTicklessSleep (uint32_t uiTicks)
+{
+	const int64_t llTickNs = TINYOS_ONE_TICK_TO_MS * 1000000LL;
+	struct itimerspec xSpec;
+	sigset_t xMask, xPending;
+	int64_t llFirst, llSleep, llLeft, llUsed;
+	uint32_t uiElapsed;
+
+	// 节拍已经到期，信号挂起着，不再休眠
+	sigpending(&xPending);
+	if(sigismember(&xPending, TINYOS_PORT_TICK_SIGNAL))
+		return 0;
+
+	// 当前节拍剩余的时间，加上之后的uiTicks - 1个节拍
+	timer_gettime(xPortTickTimer, &xSpec);
+	llFirst = xSpec.it_value.tv_sec * 1000000000LL + xSpec.it_value.tv_nsec;
+	if(llFirst <= 0 || llFirst > llTickNs)
+		llFirst = llTickNs;
+	llSleep = llFirst + (int64_t)(uiTicks - 1) * llTickNs;
+	xSpec.it_interval.tv_sec = 0;
+	xSpec.it_interval.tv_nsec = 0;
+	xSpec.it_value.tv_sec = llSleep / 1000000000LL;
+	xSpec.it_value.tv_nsec = llSleep % 1000000000LL;
+	timer_settime(xPortTickTimer, 0, &xSpec, (struct itimerspec *)0);
+
+	prvPortSignalMask(&xMask);
+	if(sigwaitinfo(&xMask, (siginfo_t *)0) == TINYOS_PORT_TICK_SIGNAL)
+	{
+		// 一次性定时到期，从现在开始下一个完整的节拍
+		uiElapsed = uiTicks - 1;
+		llLeft = llTickNs;
+		raise(TINYOS_PORT_TICK_SIGNAL);
+	}
+	else
+	{
+		// 被其它信号提前唤醒，统计已经越过的节拍边界，下一次信号对齐到原来的节拍边界
+		timer_gettime(xPortTickTimer, &xSpec);
+		llUsed = llSleep - (xSpec.it_value.tv_sec * 1000000000LL + xSpec.it_value.tv_nsec);
+		uiElapsed = llUsed >= llFirst ? 1 + (uint32_t)((llUsed - llFirst) / llTickNs) : 0;
+		llLeft = llFirst + uiElapsed * llTickNs - llUsed;
+		if(llLeft <= 0)
+			llLeft = 1;
+	}
+
+	xSpec.it_interval.tv_sec = llTickNs / 1000000000LL;
+	xSpec.it_interval.tv_nsec = llTickNs % 1000000000LL;
+	xSpec.it_value.tv_sec = llLeft / 1000000000LL;
+	xSpec.it_value.tv_nsec = llLeft % 1000000000LL;
+	timer_settime(xPortTickTimer, 0, &xSpec, (struct itimerspec *)0);
+	return uiElapsed;
+}
+#endif
+#endif
+
+#if TINYOS_ENABLE_IDLE_GOVERNOR
+// 主机上模拟的睡眠状态，数值参照常见Cortex-M的睡眠、停止节拍的睡眠与停机模式，用来在相同负载下对比选择策略
+static const IdleState_t xPortIdleStates[] = {
+	{"wfi",         2,     0, 5000,   100, 0},
+	{"tickless",   10,  2000, 5000,   300, 1},
+	{"stop",      500,  4000,   50, 20000, 1},
+};
+
+/**********************************************************************************************************
+** Function name        :   pxPortIdleStates
+** Descriptions         :   返回睡眠状态表
+** parameters           :   puiCount 存放状态数量
+** Returned value       :   状态表
+***********************************************************************************************************/
+const IdleState_t * pxPortIdleStates (uint32_t * puiCount)
+{
+	*puiCount = sizeof(xPortIdleStates) / sizeof(xPortIdleStates[0]);
+	return xPortIdleStates;
+}
+
+#if TINYOS_SIM_VIRTUAL_TIME
+static uint32_t prvPortSimIrqRandom (void)
+{
+	uint32_t uiValue = uiSimIrqRandomState;
+
+	uiValue ^= uiValue << 13;
+	uiValue ^= uiValue >> 17;
+	uiValue ^= uiValue << 5;
+	uiSimIrqRandomState = uiValue;
+	return uiValue;
+}
+
+/**********************************************************************************************************
+** Function name        :   vPortIdleEnter
+** Descriptions         :   虚拟时钟推进到唤醒的时刻。设置TINYOS_SIM_IRQ_TICKS后，平均每隔这么多节拍到达一个
+**                          不唤醒任何任务的外部中断，使睡眠提前结束，用来检验按历史预测空闲时长的效果
+** parameters           :   uiState 状态序号
+** parameters           :   uiTicks 到下一个有工作到期的节拍为止的节拍数
+** parameters           :   pxResult 存放结果
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortIdleEnter (uint32_t uiState, uint32_t uiTicks, IdleResult_t * pxResult)
+{
+	const uint32_t uiTickUs = TINYOS_ONE_TICK_TO_MS * 1000;
+	uint64_t ullNowUs = ullSimTicks * uiTickUs + uiSimTickOffsetUs;
+	uint32_t uiIrqTicks;
+
+	// 保持节拍的状态最多停留到下一个节拍
+	if(!xPortIdleStates[uiState].cStopTick)
+		uiTicks = 1;
+	if(ullSimEndTicks - ullSimTicks < uiTicks)
+		uiTicks = (uint32_t)(ullSimEndTicks - ullSimTicks);
+
+	if(uiSimIrqTicks && ullSimIrqNextUs == 0)
+		ullSimIrqNextUs = ullNowUs + 1 + prvPortSimIrqRandom() % (2 * uiSimIrqTicks * uiTickUs);
+
+	if(uiSimIrqTicks && ullSimIrqNextUs < (ullSimTicks + uiTicks) * uiTickUs)
+	{
+		// 外部中断先到达，期间越过的节拍由内核补偿，没有挂起的节拍
+		if(ullSimIrqNextUs < ullNowUs)
+			ullSimIrqNextUs = ullNowUs;
+		uiIrqTicks = (uint32_t)(ullSimIrqNextUs / uiTickUs - ullSimTicks);
+		ullSimTicks += uiIrqTicks;
+		uiSimTickOffsetUs = (uint32_t)(ullSimIrqNextUs % uiTickUs);
+
+		pxResult->uiElapsedTicks = uiIrqTicks;
+		pxResult->uiResidencyUs = (uint32_t)(ullSimIrqNextUs - ullNowUs);
+		pxResult->cTimerWake = 0;
+		ullSimIrqNextUs += 1 + prvPortSimIrqRandom() % (2 * uiSimIrqTicks * uiTickUs);
+		return;
+	}
+
+	pxResult->uiElapsedTicks = uiPortTicklessSleep(uiTicks);
+	pxResult->uiResidencyUs = (uint32_t)((ullSimTicks * uiTickUs) - ullNowUs);
+	pxResult->cTimerWake = 1;
+	uiSimTickOffsetUs = 0;
+}
+#else
+/**********************************************************************************************************
+** Function name        :   vPortIdleEnter
+** Descriptions         :   停止节拍的状态与uiPortTicklessSleep相同，其它状态用sigwaitinfo等待下一个信号。
+**                          主机的功耗与状态无关，停留时间按实际流逝的时间统计
+** parameters           :   uiState 状态序号
+** parameters           :   uiTicks 到下一个有工作到期的节拍为止的节拍数
+** parameters           :   pxResult 存放结果
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortIdleEnter (uint32_t uiState, uint32_t uiTicks, IdleResult_t * pxResult)
+{
+	struct timespec xStart, xEnd;
+	sigset_t xMask, xPending;
+
+	clock_gettime(CLOCK_MONOTONIC, &xStart);
+	if(xPortIdleStates[uiState].cStopTick)
+	{
+		pxResult->uiElapsedTicks = uiPortTicklessSleep(uiTicks);
+	}
+	else
+	{
+		sigpending(&xPending);
+		if(!sigismember(&xPending, TINYOS_PORT_TICK_SIGNAL))
+		{
+			prvPortSignalMask(&xMask);
+			if(sigwaitinfo(&xMask, (siginfo_t *)0) == TINYOS_PORT_TICK_SIGNAL)
+				raise(TINYOS_PORT_TICK_SIGNAL);
+		}
+		pxResult->uiElapsedTicks = 0;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &xEnd);
+
+	sigpending(&xPending);
+	pxResult->cTimerWake = sigismember(&xPending, TINYOS_PORT_TICK_SIGNAL) ? 1 : 0;
+	pxResult->uiResidencyUs = (uint32_t)((xEnd.tv_sec - xStart.tv_sec) * 1000000LL + (xEnd.tv_nsec - xStart.tv_nsec) / 1000);
+}
+#endif
+#endif
+
+#if TINYOS_ENABLE_SMP
+/**********************************************************************************************************
+** Function name        :   uiPortCoreId
+** Descriptions         :   当前线程所代表的核。任务切换后可能换到另一个线程上继续运行，
+**                          因此不能内联，每次都要重新读取线程局部变量
+** parameters           :   无
+** Returned value       :   核的序号
+***********************************************************************************************************/
+__attribute__((noinline)) uint32_t uiPortCoreId (void)
+{
+	__asm__ __volatile__("" ::: "memory");
+	return uiPortThisCore;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortCoreCount
+** Descriptions         :   实际运行的核数，由环境变量TINYOS_SMP_CORES指定，默认为TINYOS_CORE_COUNT
+** parameters           :   无
+** Returned value       :   核数
+***********************************************************************************************************/
+uint32_t uiPortCoreCount (void)
+{
+	if(!uiPortCores)
+	{
+		const char * pcEnv = getenv("TINYOS_SMP_CORES");
+		uint32_t uiCores = pcEnv ? (uint32_t)strtoul(pcEnv, (char **)0, 0) : TINYOS_CORE_COUNT;
+		
+		if(uiCores < 1)
+			uiCores = 1;
+		if(uiCores > TINYOS_CORE_COUNT)
+			uiCores = TINYOS_CORE_COUNT;
+		uiPortCores = uiCores;
+	}
+	return uiPortCores;
+}
+
+/**********************************************************************************************************
+** Function name        :   vPortCoreSignal
+** Descriptions         :   向指定核的线程发送核间中断信号，核还没有启动时忽略，启动时会自行调度
+** parameters           :   uiCore 目标核
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortCoreSignal (uint32_t uiCore)
+{
+	if(iPortCoreStarted[uiCore])
+		pthread_kill(xPortCoreThread[uiCore], TINYOS_PORT_IPI_SIGNAL);
+}
+
+/**********************************************************************************************************
+** Function name        :   vPortCoreIdle
+** Descriptions         :   等待信号，相当于WFI
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortCoreIdle (void)
+{
+	pause();
+}
+#endif
+
+#if TINYOS_SIM_VIRTUAL_TIME
+/**********************************************************************************************************
+** Function name        :   vPortSimIdle
+** Descriptions         :   由空闲任务调用，将虚拟时钟推进到下一个有工作到期的节拍并执行一次节拍处理
+**                          空闲任务运行说明没有其它任务就绪，中间的节拍不会产生任何事件，可以直接跳过
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortSimIdle (void)
+{
+	uint32_t uiTicks, uiLimit;
+	uint32_t uiStatus = uiTaskEnterCritical();
+
+	prvPortSimSetup();
+
+	uiTicks = uiTaskNextWakeTicks();
+	uiLimit = uiTimerModuleNextExpireTicks();
+	if(uiLimit < uiTicks)
+		uiTicks = uiLimit;
+
+	// 整秒处仍执行节拍处理，以保证CPU使用率统计正常进行
+	uiLimit = TICKS_PER_SEC - uiTickCount % TICKS_PER_SEC;
+	if(uiLimit < uiTicks)
+		uiTicks = uiLimit;
+
+	if(ullSimEndTicks - ullSimTicks < uiTicks)
+		uiTicks = (uint32_t)(ullSimEndTicks - ullSimTicks);
+	if(uiTicks == 0)
+		uiTicks = 1;
+
+	if(uiTicks > 1)
+		vTaskSystemTickSkip(uiTicks - 1);
+	ullSimTicks += uiTicks;
+	ullSimTickEvents++;
+	prvPortSimTick();
+
+	// 退出时执行节拍处理中挂起的任务切换
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortSimRandom
+** Descriptions         :   由仿真种子决定的伪随机数(xorshift32)，供应用构造可重现的负载
+** parameters           :   无
+** Returned value       :   32位伪随机数
+***********************************************************************************************************/
+uint32_t uiPortSimRandom (void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	uint32_t uiValue;
+
+	prvPortSimSetup();
+	uiValue = uiSimRandomState;
+	uiValue ^= uiValue << 13;
+	uiValue ^= uiValue >> 17;
+	uiValue ^= uiValue << 5;
+	uiSimRandomState = uiValue;
+
+	vTaskExitCritical(uiStatus);
+	return uiValue;
+}
+
+/**********************************************************************************************************
+** Function name        :   ullPortSimTicks
+** Descriptions         :   查询已经仿真的节拍数
+** parameters           :   无
+** Returned value       :   节拍数
+***********************************************************************************************************/
+uint64_t ullPortSimTicks (void)
+{
+	return ullSimTicks;
+}
+#endif
+
+#if TINYOS_ENABLE_STACK_PROFILE
+/**********************************************************************************************************
+** Function name        :   vPortStackProfileInit
+** Descriptions         :   主机上中断没有单独的堆栈，中断处理函数的用量在每次调用时测量，这里只清空结果
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortStackProfileInit (void)
+{
+	uiPortIsrStackPeak = 0;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortTaskStackUsed
+** Descriptions         :   任务的主机堆栈用到的最大字节数，包括在其上运行的信号处理函数
+** parameters           :   pxTask 任务
+** Returned value       :   字节数，任务还没有运行过时返回0
+***********************************************************************************************************/
+uint32_t uiPortTaskStackUsed (Task_t * pxTask)
+{
+	PortContext_t * pxContext = (PortContext_t *)pxTask->pxStack;
+	uint32_t * puiStack = (uint32_t *)pxContext->pvHostStack;
+	uint32_t uiFree = 0;
+
+	if(!pxContext->iStarted)
+		return 0;
+
+	while((uiFree < TINYOS_PORT_HOST_STACK_SIZE / sizeof(uint32_t)) && (puiStack[uiFree] == TINYOS_STACK_PROFILE_PAINT))
+		uiFree++;
+	return TINYOS_PORT_HOST_STACK_SIZE - uiFree * sizeof(uint32_t);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPortIsrStackUsed
+** Descriptions         :   中断处理函数用到的最大堆栈字节数
+** parameters           :   无
+** Returned value       :   字节数
+***********************************************************************************************************/
+uint32_t uiPortIsrStackUsed (void)
+{
+	return uiPortIsrStackPeak;
+}
+#endif
+
+/*------------------------------------------------------- 静态函数 --------------------------------------------------------*/
+
+#if TINYOS_ENABLE_STACK_PROFILE
+/**********************************************************************************************************
+** Function name        :   prvPortIsrProbePaint
+** Descriptions         :   填充调用者栈顶以下的一段，不能内联，以便根据本函数的栈帧找到调用者的栈顶
+** parameters           :   无
+** Returned value       :   填充部分的上端
+***********************************************************************************************************/
+__attribute__((noinline)) static uint32_t * prvPortIsrProbePaint (void)
+{
+	uint32_t * puiTop = (uint32_t *)__builtin_frame_address(0) - PORT_ISR_PROBE_GAP;
+	volatile uint32_t * puiWord = puiTop - PORT_ISR_PROBE_WORDS;
+
+	while(puiWord < puiTop)
+		*puiWord++ = TINYOS_STACK_PROFILE_PAINT;
+	return puiTop;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPortIsrCall
+** Descriptions         :   调用中断处理函数，并测量它用到的堆栈。处理函数中不会发生任务切换
+** parameters           :   pxHandler 中断处理函数
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortIsrCall (void (*pxHandler)(void))
+{
+	uint32_t * puiTop = prvPortIsrProbePaint();
+	uint32_t * puiWord = puiTop - PORT_ISR_PROBE_WORDS;
+	uint32_t uiUsed;
+
+	pxHandler();
+
+	while((puiWord < puiTop) && (*puiWord == TINYOS_STACK_PROFILE_PAINT))
+		puiWord++;
+	uiUsed = (uint32_t)(puiTop - puiWord + PORT_ISR_PROBE_GAP) * sizeof(uint32_t);
+	if(uiUsed > uiPortIsrStackPeak)
+		uiPortIsrStackPeak = uiUsed;
+}
+#endif
+
+
+/**********************************************************************************************************
+** Function name        :   prvPortPendSV
+** Descriptions         :   执行挂起的任务切换，必须在屏蔽节拍信号时调用
+**                          被切换出去的任务在以后被切换回来时从这里返回
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortPendSV (void)
+{
+	uint32_t uiCore = prvPortCore();
+	Task_t * pxFromTask = pxCurrentTask;
+	ucontext_t * pxFromContext;
+
+	iPortSwitchPending[uiCore] = 0;
+	pxCurrentTask = pxNextTask;
+	if(pxFromTask == pxNextTask)
+		return;
+#if TINYOS_SIM_VIRTUAL_TIME
+	ullSimSwitches++;
+#endif
+
+	// 上电后的第一个任务，没有需要保存的任务现场
+	pxFromContext = pxFromTask ? &((PortContext_t *)pxFromTask->pxStack)->xContext : &xPortMainContext[uiCore];
+	swapcontext(pxFromContext, &((PortContext_t *)pxNextTask->pxStack)->xContext);
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPortTaskEntry
+** Descriptions         :   所有任务在主机上的公共入口，切换进来时pxCurrentTask已指向本任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortTaskEntry (void)
+{
+	PortContext_t * pxContext = (PortContext_t *)pxCurrentTask->pxStack;
+	
+#if TINYOS_ENABLE_STACK_PROFILE
+	pxContext->iStarted = 1;
+#endif
+#if TINYOS_SIM_VIRTUAL_TIME
+	// 切换发生在临界区中，新任务以开中断状态开始运行
+	uiSimMasked = 0;
+#elif TINYOS_ENABLE_SMP
+	// 释放切换时持有的内核锁并开中断
+	vTaskExitCritical(0);
+#endif
+	pxContext->pxTaskCode(pxContext->pvParam);
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPortTickHandler
+** Descriptions         :   节拍信号处理函数，相当于SysTick中断。退出前执行中断中挂起的任务切换
+** parameters           :   iSignal 信号值
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortTickHandler (int iSignal)
+{
+	(void)iSignal;
+
+#if TINYOS_ENABLE_SMP
+	// 定时器信号会投递给任意一个没有屏蔽它的线程，节拍固定在核0上处理，其它核收到时转发过去
+	if(uiPortCoreId() != 0)
+	{
+		pthread_kill(xPortCoreThread[0], TINYOS_PORT_TICK_SIGNAL);
+		return;
+	}
+#endif
+
+	prvPortIsrEnter();
+	prvPortIsrCall(SysTick_Handler);
+	prvPortIsrExit();
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPortIsrEnter
+** Descriptions         :   信号处理函数开始时调用。SMP时整个处理过程持有内核锁，
+**                          否则选出的下一个任务可能在切换之前被其它核改变状态
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortIsrEnter (void)
+{
+#if TINYOS_ENABLE_SMP
+	if(uiPortLockDepth[uiPortCoreId()]++ == 0)
+		vSpinlockLock(&xPortKernelLock);
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPortIsrExit
+** Descriptions         :   信号处理函数返回前执行挂起的任务切换，相当于中断退出后的PendSV
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortIsrExit (void)
+{
+	if(iPortSwitchPending[prvPortCore()])
+		prvPortPendSV();
+
+#if TINYOS_ENABLE_SMP
+	// 切换回来时可能已经在另一个核上
+	if(--uiPortLockDepth[uiPortCoreId()] == 0)
+		vSpinlockUnlock(&xPortKernelLock);
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPortSignalMask
+** Descriptions         :   临界区需要屏蔽的信号：节拍信号，SMP时还有核间中断信号
+** parameters           :   pxMask 信号集
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortSignalMask (sigset_t * pxMask)
+{
+	sigemptyset(pxMask);
+	sigaddset(pxMask, TINYOS_PORT_TICK_SIGNAL);
+#if TINYOS_ENABLE_SMP
+	sigaddset(pxMask, TINYOS_PORT_IPI_SIGNAL);
+#endif
+}
+
+#if TINYOS_ENABLE_SMP
+/**********************************************************************************************************
+** Function name        :   prvPortCoreEntry
+** Descriptions         :   其它核的线程入口：等待内核锁后切换到本核优先级最高的任务，不再返回
+** parameters           :   pvParam 核的序号
+** Returned value       :   无
+***********************************************************************************************************/
+static void * prvPortCoreEntry (void * pvParam)
+{
+	uiPortThisCore = (uint32_t)(uintptr_t)pvParam;
+
+	// 线程创建时继承了屏蔽状态，这里只需要加锁
+	uiPortLockDepth[uiPortThisCore] = 1;
+	vSpinlockLock(&xPortKernelLock);
+
+	pxNextTask = pxTaskHightestReady();
+	prvPortPendSV();
+
+	abort();
+	return (void *)0;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPortCoreSignalHandler
+** Descriptions         :   核间中断处理函数：其它核修改了本核的就绪表，重新调度
+** parameters           :   iSignal 信号值
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortCoreSignalHandler (int iSignal)
+{
+	(void)iSignal;
+
+	prvPortIsrEnter();
+	vTaskSched();
+	prvPortIsrExit();
+}
+#endif
+
+#if TINYOS_SIM_VIRTUAL_TIME
+/**********************************************************************************************************
+** Function name        :   prvPortSimSetup
+** Descriptions         :   读取仿真参数，仅在第一次调用时生效
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortSimSetup (void)
+{
+	const char * pcEnv;
+
+	if(iSimStarted)
+		return;
+	iSimStarted = 1;
+
+	pcEnv = getenv("TINYOS_SIM_SEED");
+	uiSimSeed = pcEnv ? (uint32_t)strtoul(pcEnv, (char **)0, 0) : TINYOS_SIM_SEED;
+	uiSimRandomState = uiSimSeed ? uiSimSeed : 1;          // xorshift的状态不能为0
+
+	pcEnv = getenv("TINYOS_SIM_TICKS");
+	ullSimEndTicks = pcEnv ? strtoull(pcEnv, (char **)0, 0) : TINYOS_SIM_TICKS;
+
+#if TINYOS_ENABLE_IDLE_GOVERNOR
+	pcEnv = getenv("TINYOS_SIM_IRQ_TICKS");
+	uiSimIrqTicks = pcEnv ? (uint32_t)strtoul(pcEnv, (char **)0, 0) : 0;
+	uiSimIrqRandomState = uiSimRandomState ^ 0x9E3779B9u;
+	if(!uiSimIrqRandomState)
+		uiSimIrqRandomState = 1;
+	ullSimIrqNextUs = 0;
+#endif
+
+	clock_gettime(CLOCK_MONOTONIC, &xSimStartTime);
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPortSimTick
+** Descriptions         :   执行一次节拍处理，相当于进入SysTick中断，到达仿真时长时结束进程。需在临界区内调用
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortSimTick (void)
+{
+	prvPortIsrCall(SysTick_Handler);
+
+	if(ullSimTicks >= ullSimEndTicks)
+	{
+		prvPortSimReport();
+		exit(0);
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPortSimReport
+** Descriptions         :   输出仿真时间与墙上时间的对比
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPortSimReport (void)
+{
+	struct timespec xNow;
+	double dWallSec, dSimSec;
+
+	clock_gettime(CLOCK_MONOTONIC, &xNow);
+	dWallSec = (xNow.tv_sec - xSimStartTime.tv_sec) + (xNow.tv_nsec - xSimStartTime.tv_nsec) / 1e9;
+	dSimSec = (double)ullSimTicks * TINYOS_ONE_TICK_TO_MS / 1000.0;
+
+	printf("tinyOS sim: seed=%u ticks=%llu tick-events=%llu switches=%llu (%.1f/s) simulated=%.3fs wall=%.3fs speedup=%.1fx\n",
+		uiSimSeed, (unsigned long long)ullSimTicks, (unsigned long long)ullSimTickEvents,
+		(unsigned long long)ullSimSwitches, dSimSec > 0 ? ullSimSwitches / dSimSec : 0.0,
+		dSimSec, dWallSec, dWallSec > 0 ? dSimSec / dWallSec : 0.0);
+	fflush(stdout);
+}
+#endif
+
+#endif /* TINYOS_PORT_LINUX */
@@ -0,0 +1,61 @@
+#ifndef _TPORTLINUX_H
+#define _TPORTLINUX_H
+
+#include <stdint.h>
+
+// Linux主机移植层：用用户态上下文(ucontext)代替PendSV完成任务切换，
+// 用屏蔽SIGALRM代替PRIMASK实现临界区，用POSIX间隔定时器代替SysTick
+// SMP时每个核是一个主机线程，核间中断用发给线程的SIGUSR1模拟，临界区在屏蔽信号之外还要持有内核自旋锁。
+// 节拍信号可能由任意一个核处理，处理时统计所有核的时间片
+
+#define TINYOS_PORT_MAX_TASKS                  64                       // 主机上最多可同时存在的任务上下文数量
+#define TINYOS_PORT_HOST_STACK_SIZE            (256 * 1024)             // 每个任务实际运行使用的主机堆栈大小（字节）
+#define TINYOS_PORT_TICK_SIGNAL                SIGALRM                  // 模拟SysTick中断的信号
+#define TINYOS_PORT_IPI_SIGNAL                 SIGUSR1                  // SMP时模拟核间中断的信号
+
+// 虚拟时间仿真：不使用真实定时器，任务代码的执行不消耗虚拟时间，空闲任务运行时
+// 直接把虚拟时钟推进到下一个有任务或定时器到期的节拍。结果只由随机种子决定，可重现
+#ifndef TINYOS_SIM_VIRTUAL_TIME
+#define TINYOS_SIM_VIRTUAL_TIME                0
+#endif
+#if TINYOS_SIM_VIRTUAL_TIME && TINYOS_ENABLE_SMP
+#error "TINYOS_SIM_VIRTUAL_TIME does not support TINYOS_ENABLE_SMP"
+#endif
+#define TINYOS_SIM_SEED                        1                        // 默认随机种子，可用环境变量TINYOS_SIM_SEED覆盖
+#define TINYOS_SIM_TICKS                       (24UL * 3600 * 1000 / TINYOS_ONE_TICK_TO_MS)   // 默认仿真时长，可用环境变量TINYOS_SIM_TICKS覆盖
+
+/**********************************************************************************************************
+** Function name        :   vPortSoftInterrupt
+** Descriptions         :   模拟软件触发的中断：立即以中断上下文执行处理函数，其中唤醒的任务在处理函数返回后才切换
+** parameters           :   pxHandler 中断处理函数
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortSoftInterrupt (void (*pxHandler)(void));
+
+#if TINYOS_SIM_VIRTUAL_TIME
+/**********************************************************************************************************
+** Function name        :   vPortSimIdle
+** Descriptions         :   由空闲任务调用，将虚拟时钟推进到下一个有工作到期的节拍并执行一次节拍处理
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortSimIdle (void);
+
+/**********************************************************************************************************
+** Function name        :   uiPortSimRandom
+** Descriptions         :   由仿真种子决定的伪随机数，供应用构造可重现的负载
+** parameters           :   无
+** Returned value       :   32位伪随机数
+***********************************************************************************************************/
+uint32_t uiPortSimRandom (void);
+
+/**********************************************************************************************************
+** Function name        :   ullPortSimTicks
+** Descriptions         :   查询已经仿真的节拍数
+** parameters           :   无
+** Returned value       :   节拍数
+***********************************************************************************************************/
+uint64_t ullPortSimTicks (void);
+#endif
+
+#endif /* _TPORTLINUX_H */
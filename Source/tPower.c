@@ -0,0 +1,340 @@
+#include "tinyOS.h"
+
+#if TINYOS_ENABLE_IDLE_GOVERNOR
+
+#include <string.h>
+#ifdef TINYOS_PORT_LINUX
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+/****************** 宏/变量定义 ****************************/
+
+#define POWER_TICK_US                  (TINYOS_ONE_TICK_TO_MS * 1000)
+#define POWER_TYPICAL_NONE             0xFFFFFFFF
+#define POWER_FACTOR_ONE               1024                     // 修正系数的定点表示中的1
+
+static const IdleState_t * g_pxPowerStates;
+static uint32_t g_uiPowerStateCnt;
+static PowerStateInfo_t g_xPowerStateInfo[TINYOS_POWER_STATES_MAX];
+
+// 最近的空闲时长(us)，环形存放
+static uint32_t g_uiPowerHistory[TINYOS_POWER_HISTORY];
+static uint32_t g_uiPowerHistoryPos;
+
+// 实际空闲时长与最早到期节拍之比的滑动平均，反映其它中断提前结束空闲的程度
+static uint32_t g_uiPowerFactor;
+
+static PowerPolicy_e g_ePowerPolicy;
+static uint32_t g_uiPowerLatencyLimit;
+
+extern uint32_t uiTickCount;
+extern uint32_t uiIdleCount;
+extern uint32_t uiIdleMaxCount;
+
+/**********************************************************************************************************
+** Function name        :   prvPowerTypical
+** Descriptions         :   最近的空闲时长足够稳定(标准差小于平均值的1/6)时返回其平均值。不稳定时去掉最大的一个
+**                          再试，最多去掉四分之一
+** parameters           :   无
+** Returned value       :   典型的空闲时长(us)，没有时返回POWER_TYPICAL_NONE
+***********************************************************************************************************/
+static uint32_t prvPowerTypical (void)
+{
+	uint32_t uiThresh = POWER_TYPICAL_NONE;
+	uint32_t uiCnt, uiMax, uiAvg, i;
+	uint64_t ullSum, ullVar;
+
+	for(;;)
+	{
+		ullSum = 0;
+		uiCnt = 0;
+		uiMax = 0;
+		for(i = 0; i < TINYOS_POWER_HISTORY; i++)
+		{
+			if(g_uiPowerHistory[i] <= uiThresh)
+			{
+				ullSum += g_uiPowerHistory[i];
+				uiCnt++;
+				if(g_uiPowerHistory[i] > uiMax)
+					uiMax = g_uiPowerHistory[i];
+			}
+		}
+		uiAvg = (uint32_t)(ullSum / uiCnt);
+
+		ullVar = 0;
+		for(i = 0; i < TINYOS_POWER_HISTORY; i++)
+		{
+			if(g_uiPowerHistory[i] <= uiThresh)
+			{
+				int64_t llDiff = (int64_t)g_uiPowerHistory[i] - uiAvg;
+				ullVar += (uint64_t)(llDiff * llDiff);
+			}
+		}
+		ullVar /= uiCnt;
+
+		if((uint64_t)uiAvg * uiAvg > 36 * ullVar)
+			return uiAvg;
+		if(uiCnt * 4 <= TINYOS_POWER_HISTORY * 3 || uiMax == 0)
+			return POWER_TYPICAL_NONE;
+		uiThresh = uiMax - 1;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPowerUsable
+** Descriptions         :   睡眠状态在当前的延迟限制与空闲节拍数下是否可以使用
+** parameters           :   uiState 状态序号
+** parameters           :   uiTicks 到下一个有工作到期的节拍为止的节拍数
+** Returned value       :   1表示可以使用
+***********************************************************************************************************/
+static uint32_t prvPowerUsable (uint32_t uiState, uint32_t uiTicks)
+{
+	const IdleState_t * pxState = &g_pxPowerStates[uiState];
+
+	if(pxState->uiExitLatencyUs > g_uiPowerLatencyLimit)
+		return 0;
+	return !pxState->cStopTick || uiTicks >= TINYOS_TICKLESS_MIN_TICKS;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvPowerRecord
+** Descriptions         :   记录一次休眠的统计，并把空闲时长加入历史
+** parameters           :   uiState 进入的状态
+** parameters           :   uiTicks 休眠前到下一个有工作到期的节拍为止的节拍数
+** parameters           :   uiIdleUs 空闲时长(us)
+** parameters           :   uiResidencyUs 实际停留的时间(us)
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvPowerRecord (uint32_t uiState, uint32_t uiTicks, uint32_t uiIdleUs, uint32_t uiResidencyUs)
+{
+	uint32_t uiDeadlineUs = uiTicks * POWER_TICK_US;
+	const IdleState_t * pxState = &g_pxPowerStates[uiState];
+	PowerStateInfo_t * pxInfo = &g_xPowerStateInfo[uiState];
+	uint32_t i;
+
+	pxInfo->uiEnterCnt++;
+	pxInfo->ullResidencyUs += uiResidencyUs;
+	pxInfo->ullEnergyNj += (uint64_t)pxState->uiPowerUw * uiResidencyUs / 1000 + pxState->uiEntryEnergyNj;
+	pxInfo->ullLatencyUs += pxState->uiExitLatencyUs;
+
+	if(uiIdleUs < pxState->uiTargetResidencyUs)
+	{
+		pxInfo->uiTooDeepCnt++;
+	}
+	else
+	{
+		for(i = uiState + 1; i < g_uiPowerStateCnt; i++)
+		{
+			if(prvPowerUsable(i, uiTicks) && g_pxPowerStates[i].uiTargetResidencyUs <= uiIdleUs)
+				break;
+		}
+		if(i < g_uiPowerStateCnt)
+			pxInfo->uiTooShallowCnt++;
+		else
+			pxInfo->uiHitCnt++;
+	}
+
+	// 修正系数每次向新的比值移动1/8
+	if(uiIdleUs > uiDeadlineUs)
+		uiIdleUs = uiDeadlineUs;
+	g_uiPowerFactor = g_uiPowerFactor - g_uiPowerFactor / 8
+		+ (uint32_t)((uint64_t)uiIdleUs * POWER_FACTOR_ONE / uiDeadlineUs) / 8;
+
+	g_uiPowerHistory[g_uiPowerHistoryPos] = uiIdleUs;
+	g_uiPowerHistoryPos = (g_uiPowerHistoryPos + 1) % TINYOS_POWER_HISTORY;
+}
+
+/**********************************************************************************************************
+** Function name        :   vPowerInit
+** Descriptions         :   读取移植层的睡眠状态表，清空历史与统计
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerInit (void)
+{
+	uint32_t i;
+
+	g_pxPowerStates = pxPortIdleStates(&g_uiPowerStateCnt);
+	if(g_uiPowerStateCnt > TINYOS_POWER_STATES_MAX)
+		g_uiPowerStateCnt = TINYOS_POWER_STATES_MAX;
+
+	for(i = 0; i < TINYOS_POWER_STATES_MAX; i++)
+	{
+		memset(&g_xPowerStateInfo[i], 0, sizeof(PowerStateInfo_t));
+		if(i < g_uiPowerStateCnt)
+			g_xPowerStateInfo[i].pcName = g_pxPowerStates[i].pcName;
+	}
+	for(i = 0; i < TINYOS_POWER_HISTORY; i++)
+		g_uiPowerHistory[i] = 0;
+	g_uiPowerHistoryPos = 0;
+	g_uiPowerFactor = POWER_FACTOR_ONE;
+
+	g_ePowerPolicy = ePowerPolicyMenu;
+	g_uiPowerLatencyLimit = TINYOS_POWER_LATENCY_ANY;
+
+#ifdef TINYOS_PORT_LINUX
+	{
+		// 主机上可以不修改应用，用环境变量选择策略并在退出时输出统计
+		const char * pcPolicy = getenv("TINYOS_POWER_POLICY");
+
+		if(pcPolicy && strcmp(pcPolicy, "deadline") == 0)
+			g_ePowerPolicy = ePowerPolicyDeadline;
+		else if(pcPolicy && strcmp(pcPolicy, "shallow") == 0)
+			g_ePowerPolicy = ePowerPolicyShallow;
+		if(getenv("TINYOS_POWER_REPORT"))
+			atexit(vPowerReport);
+	}
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   vPowerIdle
+** Descriptions         :   由空闲任务调用，预测空闲时长，选择睡眠状态并进入，醒来后补偿节拍并记录统计
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerIdle (void)
+{
+	IdleResult_t xResult;
+	uint32_t uiTicks, uiLimit, uiDeadlineUs, uiPredictUs, uiIdleUs;
+	uint32_t uiState, i;
+	uint32_t uiStatus = uiTaskEnterCritical();
+
+	uiTicks = uiTaskNextWakeTicks();
+	uiLimit = uiTimerModuleNextExpireTicks();
+	if(uiLimit < uiTicks)
+		uiTicks = uiLimit;
+
+	// 整秒处仍执行节拍处理，以保证CPU使用率统计正常进行
+	uiLimit = TICKS_PER_SEC - uiTickCount % TICKS_PER_SEC;
+	if(uiLimit < uiTicks)
+		uiTicks = uiLimit;
+	if(uiTicks == 0)
+		uiTicks = 1;
+	uiDeadlineUs = uiTicks * POWER_TICK_US;
+
+	switch(g_ePowerPolicy)
+	{
+		case ePowerPolicyMenu:
+			uiPredictUs = prvPowerTypical();
+			uiLimit = (uint32_t)((uint64_t)uiDeadlineUs * g_uiPowerFactor / POWER_FACTOR_ONE);
+			if(uiLimit < uiPredictUs)
+				uiPredictUs = uiLimit;
+			break;
+		case ePowerPolicyDeadline:
+			uiPredictUs = uiDeadlineUs;
+			break;
+		default:
+			uiPredictUs = 0;
+			break;
+	}
+
+	// 选择预计停留时间不短于目标停留时间的最深的可用状态
+	uiState = 0;
+	for(i = 1; i < g_uiPowerStateCnt; i++)
+	{
+		if(prvPowerUsable(i, uiTicks) && g_pxPowerStates[i].uiTargetResidencyUs <= uiPredictUs)
+			uiState = i;
+	}
+
+	vPortIdleEnter(uiState, uiTicks, &xResult);
+	if(xResult.uiElapsedTicks)
+		vTaskSystemTickSkip(xResult.uiElapsedTicks);
+
+	// 只有中断能让任务就绪，由节拍唤醒说明空闲期至少持续到最早到期的节拍
+	uiIdleUs = xResult.cTimerWake ? uiDeadlineUs : xResult.uiResidencyUs;
+	prvPowerRecord(uiState, uiTicks, uiIdleUs, xResult.uiResidencyUs);
+
+	// 休眠的时间按每秒的空闲计数计入，CPU使用率仍然有效
+	uiIdleCount += (uint32_t)((uint64_t)xResult.uiResidencyUs * uiIdleMaxCount / 1000000);
+
+	// 退出时处理挂起的节拍中断
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vPowerSetPolicy
+** Descriptions         :   设置预测空闲时长的策略
+** parameters           :   ePolicy 策略
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerSetPolicy (PowerPolicy_e ePolicy)
+{
+	g_ePowerPolicy = ePolicy;
+}
+
+/**********************************************************************************************************
+** Function name        :   vPowerSetLatencyLimit
+** Descriptions         :   限制可以使用的睡眠状态的退出延迟，对中断响应有要求时设置
+** parameters           :   uiLatencyUs 退出延迟的上限(us)，TINYOS_POWER_LATENCY_ANY表示不限制
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerSetLatencyLimit (uint32_t uiLatencyUs)
+{
+	g_uiPowerLatencyLimit = uiLatencyUs;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPowerStateCount
+** Descriptions         :   睡眠状态的数量
+** parameters           :   无
+** Returned value       :   状态数量
+***********************************************************************************************************/
+uint32_t uiPowerStateCount (void)
+{
+	return g_uiPowerStateCnt;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiPowerGetStateInfo
+** Descriptions         :   获取睡眠状态的统计
+** parameters           :   uiState 状态序号
+** parameters           :   pxInfo 统计信息存储结构
+** Returned value       :   eErrorNoError，序号超出范围时返回eErrorResourceUnavaliable
+***********************************************************************************************************/
+uint32_t uiPowerGetStateInfo (uint32_t uiState, PowerStateInfo_t * pxInfo)
+{
+	uint32_t uiStatus;
+
+	if(uiState >= g_uiPowerStateCnt)
+		return eErrorResourceUnavaliable;
+
+	uiStatus = uiTaskEnterCritical();
+	*pxInfo = g_xPowerStateInfo[uiState];
+	vTaskExitCritical(uiStatus);
+	return eErrorNoError;
+}
+
+#ifdef TINYOS_PORT_LINUX
+/**********************************************************************************************************
+** Function name        :   vPowerReport
+** Descriptions         :   输出各睡眠状态的统计
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerReport (void)
+{
+	static const char * pcPolicyName[] = {"menu", "deadline", "shallow"};
+	uint64_t ullEnergy = 0, ullResidency = 0;
+	uint32_t i;
+
+	fprintf(stderr, "tinyOS power: policy=%s\n", pcPolicyName[g_ePowerPolicy]);
+	fprintf(stderr, "%-12s %10s %10s %10s %10s %14s %14s\n",
+		"state", "enter", "hit", "too-deep", "too-shallow", "residency-us", "energy-uJ");
+	for(i = 0; i < g_uiPowerStateCnt; i++)
+	{
+		PowerStateInfo_t * pxInfo = &g_xPowerStateInfo[i];
+
+		fprintf(stderr, "%-12s %10u %10u %10u %10u %14llu %14.1f\n", pxInfo->pcName, pxInfo->uiEnterCnt,
+			pxInfo->uiHitCnt, pxInfo->uiTooDeepCnt, pxInfo->uiTooShallowCnt,
+			(unsigned long long)pxInfo->ullResidencyUs, pxInfo->ullEnergyNj / 1000.0);
+		ullEnergy += pxInfo->ullEnergyNj;
+		ullResidency += pxInfo->ullResidencyUs;
+	}
+	fprintf(stderr, "tinyOS power: idle %.3fs, %.1f uJ, average %.1f uW\n", ullResidency / 1e6, ullEnergy / 1000.0,
+		ullResidency ? ullEnergy * 1000.0 / ullResidency : 0.0);
+}
+#endif
+
+#endif /* TINYOS_ENABLE_IDLE_GOVERNOR */
@@ -0,0 +1,132 @@
+#ifndef _TPOWER_H
+#define _TPOWER_H
+
+#include <stdint.h>
+#include "tConfig.h"
+
+// 空闲状态调节器：空闲任务每次休眠前预测这次空闲的时长，取最早到期的节拍(延时任务、定时器、预算补充)
+// 按其它中断提前唤醒的程度修正后的值，与最近若干次空闲时长中稳定的典型值中较小的一个，在移植层提供的
+// 睡眠状态中选择预计停留时间不短于其目标停留时间、退出延迟不超过限制的最深的一个。醒来后按实际的
+// 空闲时长统计选择是否合适，并按状态表中的功耗估算能耗，主机上可以在相同的负载下对比不同的选择策略
+
+#if TINYOS_ENABLE_IDLE_GOVERNOR
+
+// 移植层描述的一个睡眠状态，按从浅到深排列，第0个状态必须保持节拍运行
+typedef struct {
+	const char * pcName;
+	uint32_t uiExitLatencyUs;          // 进入加退出的延迟(us)，也是被中断唤醒后响应变慢的时间
+	uint32_t uiTargetResidencyUs;      // 停留时间不短于该值时才比更浅的状态省电(us)
+	uint32_t uiPowerUw;                // 停留期间的功耗(uW)
+	uint32_t uiEntryEnergyNj;          // 每进入、退出一次的额外能耗(nJ)
+	uint8_t cStopTick;                 // 停止周期节拍，由一次性定时唤醒
+}IdleState_t;
+
+// 移植层进入睡眠状态的结果
+typedef struct {
+	uint32_t uiElapsedTicks;           // 需要由内核一次补偿的节拍数，不包括挂起的最后一个节拍
+	uint32_t uiResidencyUs;            // 实际停留的时间(us)
+	uint8_t cTimerWake;                // 由节拍或一次性定时唤醒，而不是其它中断
+}IdleResult_t;
+
+// 预测空闲时长的策略
+typedef enum {
+	ePowerPolicyMenu = 0,              // 修正后的最早到期节拍与历史典型值中较小的一个
+	ePowerPolicyDeadline,              // 只看最早到期的节拍
+	ePowerPolicyShallow,               // 总是使用最浅的状态，作为对比的基准
+}PowerPolicy_e;
+
+// 一个睡眠状态的统计
+typedef struct {
+	const char * pcName;
+	uint32_t uiEnterCnt;               // 进入的次数
+	uint32_t uiHitCnt;                 // 空闲时长落在该状态合适的范围内的次数
+	uint32_t uiTooDeepCnt;             // 空闲时长短于目标停留时间，选得过深的次数
+	uint32_t uiTooShallowCnt;          // 空闲时长足以进入更深的可用状态，选得过浅的次数
+	uint64_t ullResidencyUs;           // 累计停留时间(us)
+	uint64_t ullEnergyNj;              // 按状态表估算的累计能耗(nJ)
+	uint64_t ullLatencyUs;             // 累计的退出延迟(us)
+}PowerStateInfo_t;
+
+/**********************************************************************************************************
+** Function name        :   vPowerInit
+** Descriptions         :   读取移植层的睡眠状态表，清空历史与统计
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerInit (void);
+
+/**********************************************************************************************************
+** Function name        :   vPowerIdle
+** Descriptions         :   由空闲任务调用，预测空闲时长，选择睡眠状态并进入，醒来后补偿节拍并记录统计
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerIdle (void);
+
+/**********************************************************************************************************
+** Function name        :   vPowerSetPolicy
+** Descriptions         :   设置预测空闲时长的策略
+** parameters           :   ePolicy 策略
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerSetPolicy (PowerPolicy_e ePolicy);
+
+/**********************************************************************************************************
+** Function name        :   vPowerSetLatencyLimit
+** Descriptions         :   限制可以使用的睡眠状态的退出延迟，对中断响应有要求时设置
+** parameters           :   uiLatencyUs 退出延迟的上限(us)，TINYOS_POWER_LATENCY_ANY表示不限制
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerSetLatencyLimit (uint32_t uiLatencyUs);
+
+/**********************************************************************************************************
+** Function name        :   uiPowerStateCount
+** Descriptions         :   睡眠状态的数量
+** parameters           :   无
+** Returned value       :   状态数量
+***********************************************************************************************************/
+uint32_t uiPowerStateCount (void);
+
+/**********************************************************************************************************
+** Function name        :   uiPowerGetStateInfo
+** Descriptions         :   获取睡眠状态的统计
+** parameters           :   uiState 状态序号
+** parameters           :   pxInfo 统计信息存储结构
+** Returned value       :   eErrorNoError，序号超出范围时返回eErrorResourceUnavaliable
+***********************************************************************************************************/
+uint32_t uiPowerGetStateInfo (uint32_t uiState, PowerStateInfo_t * pxInfo);
+
+#ifdef TINYOS_PORT_LINUX
+/**********************************************************************************************************
+** Function name        :   vPowerReport
+** Descriptions         :   输出各睡眠状态的统计
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPowerReport (void);
+#endif
+
+/**********************************************************************************************************
+** Function name        :   pxPortIdleStates
+** Descriptions         :   由移植层实现，返回睡眠状态表
+** parameters           :   puiCount 存放状态数量
+** Returned value       :   状态表
+***********************************************************************************************************/
+const IdleState_t * pxPortIdleStates (uint32_t * puiCount);
+
+/**********************************************************************************************************
+** Function name        :   vPortIdleEnter
+** Descriptions         :   由移植层实现，在临界区内进入睡眠状态。停止节拍的状态与uiPortTicklessSleep相同，
+**                          其它状态等到下一个中断；由节拍唤醒时节拍中断保持挂起，退出临界区后处理
+** parameters           :   uiState 状态序号
+** parameters           :   uiTicks 到下一个有工作到期的节拍为止的节拍数
+** parameters           :   pxResult 存放结果
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortIdleEnter (uint32_t uiState, uint32_t uiTicks, IdleResult_t * pxResult);
+
+#endif /* TINYOS_ENABLE_IDLE_GOVERNOR */
+
+#define TINYOS_POWER_LATENCY_ANY               0xFFFFFFFF              // 不限制退出延迟
+
+#endif /* _TPOWER_H */
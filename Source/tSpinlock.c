@@ -0,0 +1,60 @@
+#include "tLib.h"
+
+#if TINYOS_ENABLE_SMP
+
+#ifdef TINYOS_PORT_LINUX
+#include <sched.h>
+#endif
+
+// 忙等时的让步：主机上核由线程模拟，持锁线程可能被操作系统换出，忙等一段时间后主动让出CPU
+#ifdef TINYOS_PORT_LINUX
+#define TINYOS_SPINLOCK_YIELD_SPINS    64
+#define prvSpinlockRelax()             sched_yield()
+#else
+#define TINYOS_SPINLOCK_YIELD_SPINS    1
+#define prvSpinlockRelax()
+#endif
+
+/**********************************************************************************************************
+** Function name        :   vSpinlockInit
+** Descriptions         :   初始化自旋锁为未加锁状态
+** parameters           :   pxLock 自旋锁
+** Returned value       :   无
+***********************************************************************************************************/
+void vSpinlockInit (Spinlock_t * pxLock)
+{
+	__atomic_store_n(&pxLock->uiLocked, 0, __ATOMIC_RELEASE);
+}
+
+/**********************************************************************************************************
+** Function name        :   vSpinlockLock
+** Descriptions         :   加锁，锁被其它核持有时忙等。等待时只读不写，避免缓存行在核之间来回传递
+** parameters           :   pxLock 自旋锁
+** Returned value       :   无
+***********************************************************************************************************/
+void vSpinlockLock (Spinlock_t * pxLock)
+{
+	uint32_t uiSpins = 0;
+
+	while(__atomic_exchange_n(&pxLock->uiLocked, 1, __ATOMIC_ACQUIRE))
+	{
+		while(__atomic_load_n(&pxLock->uiLocked, __ATOMIC_RELAXED))
+		{
+			if(++uiSpins % TINYOS_SPINLOCK_YIELD_SPINS == 0)
+				prvSpinlockRelax();
+		}
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   vSpinlockUnlock
+** Descriptions         :   解锁
+** parameters           :   pxLock 自旋锁
+** Returned value       :   无
+***********************************************************************************************************/
+void vSpinlockUnlock (Spinlock_t * pxLock)
+{
+	__atomic_store_n(&pxLock->uiLocked, 0, __ATOMIC_RELEASE);
+}
+
+#endif /* TINYOS_ENABLE_SMP */
@@ -0,0 +1,258 @@
+#include "tinyOS.h"
+
+#if TINYOS_ENABLE_STACK_PROFILE
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef TINYOS_PORT_LINUX
+#include <signal.h>
+#include <stdlib.h>
+#endif
+
+/****************** 宏/变量定义 ****************************/
+
+typedef struct {
+	Task_t * pxTask;
+	const char * pcName;               // 决定该任务堆栈大小的宏名
+	uint32_t uiPeak;                   // 任务被删除前测得的峰值(字节)
+}StackProfileTask_t;
+
+static StackProfileTask_t xStackProfileTask[TINYOS_STACK_PROFILE_TASKS];
+static uint32_t uiStackProfileTaskCnt;
+
+#ifdef TINYOS_PORT_LINUX
+static void prvStackProfileAtExit (void);
+static void prvStackProfileSigInt (int iSignal);
+#endif
+
+/**********************************************************************************************************
+** Function name        :   prvStackProfileFind
+** Descriptions         :   查找任务的登记项
+** parameters           :   pxTask 任务
+** Returned value       :   登记项，没有登记时返回0
+***********************************************************************************************************/
+static StackProfileTask_t * prvStackProfileFind (Task_t * pxTask)
+{
+	uint32_t i;
+
+	for(i = 0; i < uiStackProfileTaskCnt; i++)
+	{
+		if(xStackProfileTask[i].pxTask == pxTask)
+			return &xStackProfileTask[i];
+	}
+	return (StackProfileTask_t *)0;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvStackProfilePeak
+** Descriptions         :   登记项的峰值，任务还存在时与当前测得的使用量比较
+** parameters           :   pxEntry 登记项
+** Returned value       :   字节数
+***********************************************************************************************************/
+static uint32_t prvStackProfilePeak (StackProfileTask_t * pxEntry)
+{
+	uint32_t uiUsed;
+
+	if(pxEntry->pxTask->uiState & TINYOS_TASK_STATE_DESTROYED)
+		return pxEntry->uiPeak;
+
+	uiUsed = uiPortTaskStackUsed(pxEntry->pxTask);
+	return uiUsed > pxEntry->uiPeak ? uiUsed : pxEntry->uiPeak;
+}
+
+// 向缓冲区追加格式化的内容，缓冲区不足时只累计长度
+static uint32_t prvStackProfilePrint (char * pcBuf, uint32_t uiSize, uint32_t uiLen, const char * pcFormat, ...)
+{
+	va_list xArgs;
+	int iCnt;
+
+	va_start(xArgs, pcFormat);
+	iCnt = vsnprintf(uiLen < uiSize ? pcBuf + uiLen : (char *)0, uiLen < uiSize ? uiSize - uiLen : 0, pcFormat, xArgs);
+	va_end(xArgs);
+	return uiLen + (iCnt > 0 ? (uint32_t)iCnt : 0);
+}
+
+/**********************************************************************************************************
+** Function name        :   vStackProfileInit
+** Descriptions         :   清空登记的任务，并由移植层准备中断堆栈的测量
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vStackProfileInit (void)
+{
+	uiStackProfileTaskCnt = 0;
+	vPortStackProfileInit();
+
+#ifdef TINYOS_PORT_LINUX
+	// 设置了TINYOS_STACK_PROFILE_FILE时，进程退出（包括Ctrl+C）时生成头文件
+	if(getenv("TINYOS_STACK_PROFILE_FILE"))
+	{
+		atexit(prvStackProfileAtExit);
+		signal(SIGINT, prvStackProfileSigInt);
+	}
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   uiStackProfileAdd
+** Descriptions         :   登记需要剖析的任务。多个任务使用同一个宏名时，取其中的最大值
+** parameters           :   pxTask 任务
+** parameters           :   pcName 决定该任务堆栈大小的宏名，字符串需一直有效
+** Returned value       :   eErrorNoError，或登记表已满时返回eErrorResourceFull
+***********************************************************************************************************/
+uint32_t uiStackProfileAdd (Task_t * pxTask, const char * pcName)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	StackProfileTask_t * pxEntry = prvStackProfileFind(pxTask);
+
+	if(!pxEntry)
+	{
+		if(uiStackProfileTaskCnt == TINYOS_STACK_PROFILE_TASKS)
+		{
+			vTaskExitCritical(uiStatus);
+			return eErrorResourceFull;
+		}
+		pxEntry = &xStackProfileTask[uiStackProfileTaskCnt++];
+		pxEntry->pxTask = pxTask;
+		pxEntry->uiPeak = 0;
+	}
+	pxEntry->pcName = pcName;
+
+	vTaskExitCritical(uiStatus);
+	return eErrorNoError;
+}
+
+/**********************************************************************************************************
+** Function name        :   vStackProfileTaskDelete
+** Descriptions         :   任务被删除时保存其峰值，重新创建后继续累计
+** parameters           :   pxTask 被删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vStackProfileTaskDelete (Task_t * pxTask)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	StackProfileTask_t * pxEntry = prvStackProfileFind(pxTask);
+
+	if(pxEntry)
+		pxEntry->uiPeak = prvStackProfilePeak(pxEntry);
+
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiStackProfileFormat
+** Descriptions         :   生成推荐堆栈大小的头文件内容
+** parameters           :   pcBuf 存放结果的缓冲区
+** parameters           :   uiSize 缓冲区大小
+** Returned value       :   完整内容的长度，大于等于uiSize时说明被截断
+***********************************************************************************************************/
+uint32_t uiStackProfileFormat (char * pcBuf, uint32_t uiSize)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	uint32_t uiLen = 0, uiPeak, uiWords, i, j;
+
+	uiLen = prvStackProfilePrint(pcBuf, uiSize, uiLen,
+		"// 由tinyOS堆栈剖析生成，构建时将TINYOS_STACK_SIZE_FILE定义为本文件的路径即可使用\n"
+		"// 任务堆栈的单位为字: (峰值 + %d字节异常帧) * %d%%，按8字对齐\n\n"
+		"#ifndef _TSTACKSIZE_GENERATED_H\n#define _TSTACKSIZE_GENERATED_H\n\n",
+		TINYOS_STACK_PROFILE_EXC_FRAME, 100 + TINYOS_STACK_PROFILE_MARGIN);
+
+	for(i = 0; i < uiStackProfileTaskCnt; i++)
+	{
+		uint32_t uiConfigured = 0;
+
+		// 同名的登记项合并到第一次出现的位置输出
+		for(j = 0; j < i; j++)
+		{
+			if(strcmp(xStackProfileTask[j].pcName, xStackProfileTask[i].pcName) == 0)
+				break;
+		}
+		if(j < i)
+			continue;
+
+		uiPeak = 0;
+		for(j = i; j < uiStackProfileTaskCnt; j++)
+		{
+			if(strcmp(xStackProfileTask[j].pcName, xStackProfileTask[i].pcName) == 0)
+			{
+				uint32_t uiTaskPeak = prvStackProfilePeak(&xStackProfileTask[j]);
+				uint32_t uiTaskWords = xStackProfileTask[j].pxTask->uiStackSize / sizeof(TaskStack_t);
+
+				uiPeak = uiTaskPeak > uiPeak ? uiTaskPeak : uiPeak;
+				uiConfigured = uiTaskWords > uiConfigured ? uiTaskWords : uiConfigured;
+			}
+		}
+
+		if(!uiPeak)
+		{
+			uiLen = prvStackProfilePrint(pcBuf, uiSize, uiLen, "// %s: 剖析期间没有运行，保持原来的%u字\n",
+				xStackProfileTask[i].pcName, uiConfigured);
+			continue;
+		}
+
+		uiWords = (TINYOS_STACK_PROFILE_EXC_FRAME + uiPeak) * (100 + TINYOS_STACK_PROFILE_MARGIN) / 100;
+		uiWords = (uiWords + 8 * sizeof(TaskStack_t) - 1) / (8 * sizeof(TaskStack_t)) * 8;
+		uiLen = prvStackProfilePrint(pcBuf, uiSize, uiLen, "#define %-36s %-8u// 峰值%u字节，原%u字\n",
+			xStackProfileTask[i].pcName, uiWords, uiPeak, uiConfigured);
+	}
+
+	// 中断的堆栈以字节为单位，与启动文件中的Stack_Size对应
+	uiPeak = uiPortIsrStackUsed();
+	if(uiPeak)
+	{
+		uiLen = prvStackProfilePrint(pcBuf, uiSize, uiLen, "#define %-36s %-8u// 峰值%u字节，原%u字节\n",
+			"TINYOS_ISR_STACK_SIZE", ((uiPeak * (100 + TINYOS_STACK_PROFILE_MARGIN) / 100) + 7) & ~7u,
+			uiPeak, TINYOS_ISR_STACK_SIZE);
+	}
+
+	uiLen = prvStackProfilePrint(pcBuf, uiSize, uiLen, "\n#endif\n");
+
+	vTaskExitCritical(uiStatus);
+	return uiLen;
+}
+
+#ifdef TINYOS_PORT_LINUX
+/**********************************************************************************************************
+** Function name        :   vStackProfileWrite
+** Descriptions         :   将推荐堆栈大小的头文件写入指定的文件
+** parameters           :   pcPath 文件路径
+** Returned value       :   无
+***********************************************************************************************************/
+void vStackProfileWrite (const char * pcPath)
+{
+	uint32_t uiLen = uiStackProfileFormat((char *)0, 0);
+	char * pcBuf = malloc(uiLen + 1);
+	FILE * pxFile;
+
+	if(!pcBuf)
+		return;
+	uiStackProfileFormat(pcBuf, uiLen + 1);
+
+	pxFile = fopen(pcPath, "w");
+	if(pxFile)
+	{
+		fputs(pcBuf, pxFile);
+		fclose(pxFile);
+		fprintf(stderr, "tinyOS: stack sizes written to %s\n", pcPath);
+	}
+	else
+	{
+		perror("tinyOS: stack profile");
+	}
+	free(pcBuf);
+}
+
+static void prvStackProfileAtExit (void)
+{
+	vStackProfileWrite(getenv("TINYOS_STACK_PROFILE_FILE"));
+}
+
+static void prvStackProfileSigInt (int iSignal)
+{
+	(void)iSignal;
+	exit(130);
+}
+#endif
+
+#endif /* TINYOS_ENABLE_STACK_PROFILE */
@@ -0,0 +1,100 @@
+#ifndef _TSTACKPROFILE_H
+#define _TSTACKPROFILE_H
+
+#include <stdint.h>
+#include "tConfig.h"
+#include "tTask.h"
+
+// 堆栈剖析：打开TINYOS_ENABLE_STACK_PROFILE后，登记过的任务与中断的堆栈峰值被记录下来，运行完负载后
+// 生成一个头文件，为每个登记时给出的宏名写入推荐的堆栈大小。构建时用TINYOS_STACK_SIZE_FILE指定该头文件，
+// tConfig.h与应用中用#ifndef给出的默认大小即被替换。
+// 推荐值 = (峰值 + 中断时硬件压入任务堆栈的异常帧) * (100 + TINYOS_STACK_PROFILE_MARGIN)%，按8字对齐。
+// 任务的峰值来自空闲任务测得的堆栈使用量；中断的峰值由移植层测量：Cortex-M3上为主堆栈(MSP)，
+// 主机上为信号处理函数在被打断任务的主机堆栈上用到的部分
+
+#define TINYOS_STACK_PROFILE_PAINT             0xA5A5A5A5u             // 移植层填充被测堆栈所用的图案
+#define TINYOS_STACK_PROFILE_EXC_FRAME         32                      // Cortex-M3进入中断时压入任务堆栈的字节数
+
+#if TINYOS_ENABLE_STACK_PROFILE
+
+/**********************************************************************************************************
+** Function name        :   vStackProfileInit
+** Descriptions         :   清空登记的任务，并由移植层准备中断堆栈的测量
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vStackProfileInit (void);
+
+/**********************************************************************************************************
+** Function name        :   uiStackProfileAdd
+** Descriptions         :   登记需要剖析的任务。多个任务使用同一个宏名时，取其中的最大值
+** parameters           :   pxTask 任务
+** parameters           :   pcName 决定该任务堆栈大小的宏名，字符串需一直有效
+** Returned value       :   eErrorNoError，或登记表已满时返回eErrorResourceFull
+***********************************************************************************************************/
+uint32_t uiStackProfileAdd (Task_t * pxTask, const char * pcName);
+
+/**********************************************************************************************************
+** Function name        :   vStackProfileTaskDelete
+** Descriptions         :   任务被删除时保存其峰值，重新创建后继续累计
+** parameters           :   pxTask 被删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vStackProfileTaskDelete (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   uiStackProfileFormat
+** Descriptions         :   生成推荐堆栈大小的头文件内容
+** parameters           :   pcBuf 存放结果的缓冲区
+** parameters           :   uiSize 缓冲区大小
+** Returned value       :   完整内容的长度，大于等于uiSize时说明被截断
+***********************************************************************************************************/
+uint32_t uiStackProfileFormat (char * pcBuf, uint32_t uiSize);
+
+#ifdef TINYOS_PORT_LINUX
+/**********************************************************************************************************
+** Function name        :   vStackProfileWrite
+** Descriptions         :   将推荐堆栈大小的头文件写入指定的文件
+** parameters           :   pcPath 文件路径
+** Returned value       :   无
+***********************************************************************************************************/
+void vStackProfileWrite (const char * pcPath);
+#endif
+
+/**********************************************************************************************************
+** Function name        :   vPortStackProfileInit
+** Descriptions         :   由移植层实现，准备中断堆栈的测量
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortStackProfileInit (void);
+
+/**********************************************************************************************************
+** Function name        :   uiPortTaskStackUsed
+** Descriptions         :   由移植层实现，任务堆栈用到的最大字节数
+** parameters           :   pxTask 任务
+** Returned value       :   字节数，任务还没有运行过时返回0
+***********************************************************************************************************/
+uint32_t uiPortTaskStackUsed (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   uiPortIsrStackUsed
+** Descriptions         :   由移植层实现，中断处理(包括嵌套)用到的最大堆栈字节数
+** parameters           :   无
+** Returned value       :   字节数
+***********************************************************************************************************/
+uint32_t uiPortIsrStackUsed (void);
+
+#define STACK_PROFILE_INIT()                  vStackProfileInit()
+#define STACK_PROFILE_ADD(pxTask, pcName)     uiStackProfileAdd(pxTask, pcName)
+#define STACK_PROFILE_TASK_DELETE(pxTask)     vStackProfileTaskDelete(pxTask)
+
+#else
+
+#define STACK_PROFILE_INIT()
+#define STACK_PROFILE_ADD(pxTask, pcName)
+#define STACK_PROFILE_TASK_DELETE(pxTask)
+
+#endif /* TINYOS_ENABLE_STACK_PROFILE */
+
+#endif /* _TSTACKPROFILE_H */
@@ -1,602 +1,1409 @@
-#include "tinyOS.h"
-#include "string.h"
-/****************** 全局变量 *************************/
-
-// 当前任务：记录当前是哪个任务正在运行
-Task_t * pxCurrentTask;
-
-// 下一个即将运行的任务：在任务切换之前，需要先设置好该值
-Task_t * pxNextTask;
-
-static List_t g_xTaskTable[TINYOS_PRO_COUNT];
-
-// 调度锁计数器
-static uint8_t g_cSchedLockCount;
-
-// 位图
-static Bitmap_t g_xTaskPrioBitmap;
-
-// 延时队列
-static List_t g_xTaskDelayedList;
-
-// 时钟节拍计数
-uint32_t uiTickCount;
-
-extern void vCheckCpuUsage(void);
-
-/**********************************************************************************************************
-** Function name        :   vTaskInit
-** Descriptions         :   初始化任务
-** parameters           :   pxTask           要初始化的任务结构
-** parameters           :   pxTaskCode       任务的入口函数
-** parameters           :   pvParam          传递给任务的运行参数
-** parameters           :   uiPrio           任务的优先级
-** parameters           :   pxStack          任务堆栈的起始地址（低地址）
-** parameters           :   uiStackSize      任务堆栈大小
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskInit(Task_t * pxTask, TaskFunction_pt pxTaskCode, void *pvParam, uint32_t uiPrio, TaskStack_t * pxStack, uint32_t uiStackSize)
-{
-	uint32_t * puiStackTop;
-	
-	// 为了简化代码，tinyOS无论是在启动时切换至第一个任务，还是在运行过程中在不同间任务切换
-    // 所执行的操作都是先保存当前任务的运行环境参数（CPU寄存器值）的堆栈中(如果已经运行运行起来的话)，然后再
-    // 取出从下一个任务的堆栈中取出之前的运行环境参数，然后恢复到CPU寄存器
-    // 对于切换至之前从没有运行过的任务，我们为它配置一个“虚假的”保存现场，然后使用该现场恢复。
-	pxTask->puiStackBase = pxStack;
-	pxTask->uiStackSize = uiStackSize;
-	memset(pxStack, 0, uiStackSize);
-	puiStackTop = pxStack + uiStackSize / sizeof(TaskStack_t);
-	
-    *(--puiStackTop) = (unsigned long)(1<<24);                // XPSR, 设置了Thumb模式，恢复到Thumb状态而非ARM状态运行
-    *(--puiStackTop) = (unsigned long)pxTaskCode;                  // 程序的入口地址
-    *(--puiStackTop) = (unsigned long)0x14;                   // R14(LR), 任务不会通过return xxx结束自己，所以未用
-    *(--puiStackTop) = (unsigned long)0x12;                   // R12, 未用
-    *(--puiStackTop) = (unsigned long)0x3;                    // R3, 未用
-    *(--puiStackTop) = (unsigned long)0x2;                    // R2, 未用
-    *(--puiStackTop) = (unsigned long)0x1;                    // R1, 未用
-    *(--puiStackTop) = (unsigned long)pvParam;                  // R0 = param, 传给任务的入口函数
-    *(--puiStackTop) = (unsigned long)0x11;                   // R11, 未用
-    *(--puiStackTop) = (unsigned long)0x10;                   // R10, 未用
-    *(--puiStackTop) = (unsigned long)0x9;                    // R9, 未用
-    *(--puiStackTop) = (unsigned long)0x8;                    // R8, 未用
-    *(--puiStackTop) = (unsigned long)0x7;                    // R7, 未用
-    *(--puiStackTop) = (unsigned long)0x6;                    // R6, 未用
-    *(--puiStackTop) = (unsigned long)0x5;                    // R5, 未用
-    *(--puiStackTop) = (unsigned long)0x4;                    // R4, 未用
-
-    pxTask->pxStack = puiStackTop;                                // 保存最终的值
-	pxTask->uiDelayTicks = 0;
-	pxTask->uiPrio = uiPrio;
-	pxTask->uiState = TINYOS_TASK_STATE_RDY;
-	pxTask->uiSlice = TINYOS_SLICE_MAX;
-	pxTask->uiSuspendCount = 0;
-	pxTask->vCleanResource = (void (*)(void *))0;
-	pxTask->pvCleanParam = (void *)0;
-	pxTask->cRequsetDeleteFlag = 0;
-	
-	// 任务正在等待的事件类型
-    pxTask->pxWaitEvent = (Event_t *)0;
-	pxTask->pvEventMsg = (void *)0;
-	pxTask->uiWaitEventResult = eErrorNoError;
-	
-	vNodeInit(&pxTask->xDelayNode);
-	vNodeInit(&pxTask->xLinkNode);                       // 初始化链接结点
-	vNodeInit(&pxTask->xEventNode);
-	vTaskSchedRdy(pxTask);
-}
-
-/**********************************************************************************************************
-** Function name        :   vHardwareInit
-** Descriptions         :   硬件初始化
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vHardwareInit(void)
-{
-	vSetSysTickPeriod(TINYOS_ONE_TICK_TO_MS);
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskDelayedInit
-** Descriptions         :   初始化任务延时机制
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskDelayedInit (void) 
-{
-    vListInit(&g_xTaskDelayedList);
-}
-
-/**********************************************************************************************************
-** Function name        :   vTimeTickInit
-** Descriptions         :   初始化时钟节拍计数
-** input parameters     :   无
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimeTickInit(void)
-{
-	uiTickCount = 0;
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskDelay
-** Descriptions         :   使当前任务进入延时状态。
-** parameters           :   delay 延时多少个ticks
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskDelay(uint32_t uiDelay)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	// 设置延时值，插入延时队列
-	vTimeTaskWait(pxCurrentTask, uiDelay);
-	// 将任务从就绪表中移除
-	vTaskSchedUnRdy(pxCurrentTask);
-	vTaskExitCritical(uiStatus);
-	vTaskSched();
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskSchedInit
-** Descriptions         :   初始化调度器
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSchedInit (void)
-{
-	int i = 0;
-    g_cSchedLockCount = 0;
-	vBitmapInit(&g_xTaskPrioBitmap);
-	for(i = 0; i < TINYOS_PRO_COUNT; i++)
-	{
-		vListInit(&g_xTaskTable[i]);
-	}
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskSchedEnable
-** Descriptions         :   使能任务调度
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSchedEnable(void)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	if(g_cSchedLockCount > 0)
-	{
-		if(--g_cSchedLockCount == 0)
-		{
-			vTaskSched();
-		}		
-	}
-	vTaskExitCritical(uiStatus);
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskSchedDisable
-** Descriptions         :   禁止任务调度
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSchedDisable(void)
-{
-	uint32_t status = uiTaskEnterCritical();
-	
-	if(g_cSchedLockCount < 255)
-	{
-		g_cSchedLockCount++;
-	}
-	
-	vTaskExitCritical(status);
-}
-
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskSchedRdy
-** Descriptions         :   将任务设置为就绪状态
-** input parameters     :   task    等待设置为就绪状态的任务
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSchedRdy (Task_t * pxTask)
-{
-	vListAddLast(&g_xTaskTable[pxTask->uiPrio], &pxTask->xLinkNode);
-    vBitmapSet(&g_xTaskPrioBitmap, pxTask->uiPrio);
-}
-
-/************************************************************************************************************
-** Descriptions         :   vTaskSchedUnRdy
-** Descriptions         :   将任务从就绪列表中移除
-** input parameters     :   task    等待从就绪列表中移除的任务
-** output parameters    :   None
-** Returned value       :   None
-***********************************************************************************************************/
-void vTaskSchedUnRdy (Task_t * pxTask)
-{
-    vListRemove(&g_xTaskTable[pxTask->uiPrio], &pxTask->xLinkNode);
-	if(!uiListCount(&g_xTaskTable[pxTask->uiPrio]))
-		vBitmapClear(&g_xTaskPrioBitmap, pxTask->uiPrio);
-}
-
-/************************************************************************************************************
-** Descriptions         :   vTaskSchedUnRdy
-** Descriptions         :   将任务从就绪列表中移除
-** input parameters     :   task    等待从就绪列表中移除的任务
-** output parameters    :   None
-** Returned value       :   None
-***********************************************************************************************************/
-void vTaskSchedRemove (Task_t * pxTask)
-{
-    vListRemove(&g_xTaskTable[pxTask->uiPrio], &pxTask->xLinkNode);
-	if(!uiListCount(&g_xTaskTable[pxTask->uiPrio]))
-		vBitmapClear(&g_xTaskPrioBitmap, pxTask->uiPrio);
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskSetCleanCallFunc
-** Descriptions         :   设置任务被删除时调用的清理函数
-** parameters           :   pxTask  待设置的任务
-** parameters           :   pvClean  清理函数入口地址
-** parameters           :   pvParam  传递给清理函数的参数
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSetCleanCallFunc (Task_t * pxTask, void (*pvClean)(void *param), void * pvParam)
-{
-	pxTask->vCleanResource = pvClean;
-	pxTask->pvCleanParam = pvParam;
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskForceDelete
-** Descriptions         :   强制删除指定的任务
-** parameters           :   task  需要删除的任务
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskForceDelete(Task_t * pxTask)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	if( pxTask->uiState & TINYOS_TASK_STATE_DELAYED)  // 如果任务位于延时队列中
-	{
-		vTimeTaskRemove(pxTask);
-	}
-	else if(!(pxTask->uiState & TINYOS_TASK_STATE_SUSPEND))  // 如果任务处于就绪链表中
-	{
-		vTaskSchedRemove (pxTask);
-	}
-	
-	if(pxTask->vCleanResource)                        // 如果任务有清理资源函数，则调用
-		pxTask->vCleanResource(pxTask->pvCleanParam);
-	
-	if(pxCurrentTask == pxTask)                       // 如果被删除的是当前任务，则进行任务调度
-		vTaskSched();
-	
-	vTaskExitCritical(uiStatus);
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskRequestDelete
-** Descriptions         :   请求删除某个任务，由任务自己决定是否删除自己
-** parameters           :   pxTask  需要删除的任务
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskRequestDelete(Task_t * pxTask)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	pxTask->cRequsetDeleteFlag = 1;
-	vTaskExitCritical(uiStatus);
-}
-
-/**********************************************************************************************************
-** Function name        :   cTaskIsRequestedDelete
-** Descriptions         :   是否已经被请求删除自己
-** parameters           :   无
-** Returned value       :   非0表示请求删除，0表示无请求
-***********************************************************************************************************/
-uint8_t cTaskIsRequestedDelete (void)
-{
-	uint8_t cDelete;
-	uint32_t uiStatus = uiTaskEnterCritical();
-	cDelete = pxCurrentTask->cRequsetDeleteFlag;
-	vTaskExitCritical(uiStatus);
-	return cDelete;
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskDeleteSelf
-** Descriptions         :   删除当前任务
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskDeleteSelf (void)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	// 任务在调用该函数时，必须处于就绪态，不可能处于延时或者挂起状态
-	// 所以，只要从就绪队列中移除即可
-	vTaskSchedRemove(pxCurrentTask);
-	
-	if(pxCurrentTask->vCleanResource)
-		pxCurrentTask->vCleanResource(pxCurrentTask->pvCleanParam);
-	
-	vTaskSched();
-	
-	vTaskExitCritical(uiStatus);
-}
-
-
-/**********************************************************************************************************
-** Function name        :   tTaskSuspend
-** Descriptions         :   挂起指定的任务
-** parameters           :   task        待挂起的任务
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSuspend(Task_t * pxTask)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	if(!(pxTask->uiState & TINYOS_TASK_STATE_DELAYED))
-	{
-        // 增加挂起计数，仅当该任务被执行第一次挂起操作时，才考虑是否
-        // 要执行任务切换操作
-        if (++pxTask->uiSuspendCount <= 1)
-		{
-			pxTask->uiState |= TINYOS_TASK_STATE_SUSPEND;
-			vTaskSchedUnRdy(pxTask);   // 从就绪队列中移除该任务
-			
-			if(pxTask == pxCurrentTask)  // 如果该任务为当前任务，则进行任务切换
-				vTaskSched();
-		}
-	}
-	
-	vTaskExitCritical(uiStatus);
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskWakeUp
-** Descriptions         :   唤醒被挂起的任务
-** parameters           :   task        待唤醒的任务
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskWakeUp (Task_t * pxTask)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	
-	if((pxTask->uiState & TINYOS_TASK_STATE_SUSPEND))
-	{
-        // 递减挂起计数，如果为0了，则清除挂起标志，同时设置进入就绪状态
-        if (--pxTask->uiSuspendCount == 0) 
-		{
-			pxTask->uiState &= ~TINYOS_TASK_STATE_SUSPEND;
-			vTaskSchedRdy(pxTask);
-			
-			vTaskSched();  // 因为被唤醒任务可能优先级更高，所以需要进行任务调度
-		}
-	}
-	
-	vTaskExitCritical(uiStatus);
-}
-
-
-/**********************************************************************************************************
-** Function name        :   pxTaskHightestReady
-** Descriptions         :   获取优先级最高的任务
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-Task_t * pxTaskHightestReady (void)
-{
-	uint32_t uiPrio = uiBitmapGetFirstSet(&g_xTaskPrioBitmap);
-	Node_t *pxFirstNode = pxListFirst(&g_xTaskTable[uiPrio]);
-	return pxNodeParent(pxFirstNode, Task_t, xLinkNode);
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskSetNext
-** Descriptions         :   设置下一个任务
-** parameters           :   pxTask 
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSetNext(Task_t *pxTask)
-{
-	pxNextTask = pxTask;
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskSystemTickHandler
-** Descriptions         :   系统时钟节拍处理
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSystemTickHandler(void)
-{
-	uint32_t status = uiTaskEnterCritical();
-	Node_t *pxNode = pxListFirst(&g_xTaskDelayedList);
-	
-	if(pxNode)
-	{
-		Task_t *pxTask = pxNodeParent(pxNode, Task_t, xDelayNode);     
-		pxTask->uiDelayTicks--;
-		while(!pxTask->uiDelayTicks)
-		{
-			vTimeTaskWakeUp(pxTask);   // 将任务从延时队列中删除
-			vTaskSchedRdy(pxTask);     // 根据优先级将任务加入就绪优先级数组
-			
-			// 如果任务还处于等待事件的状态，则将其从事件等待队列中唤醒
-			if (pxTask->pxWaitEvent)
-			{
-				vEventRemoveTask(pxTask, (void *)0, eErrorTimeout);
-			}
-			
-			pxNode = pxListNext(&g_xTaskDelayedList, pxNode);
-			if(!pxNode) break;
-			pxTask = pxNodeParent(pxNode, Task_t, xDelayNode);
-		}
-	}
-	
-	/* 如果时间片用完的话，则将当前任务移动到链表的最后一项，从而在调度函数中完成任务切换 */
-	if(--pxCurrentTask->uiSlice == 0)
-	{
-		/* 需要进行链表节点数量判断，因为可能调用延时函数，将任务从就绪链表中清除 */
-		if(uiListCount(&g_xTaskTable[pxCurrentTask->uiPrio]) > 0)
-		{
-			vListRemove(&g_xTaskTable[pxCurrentTask->uiPrio], &pxCurrentTask->xLinkNode);
-			pxCurrentTask->uiSlice = TINYOS_SLICE_MAX;
-			vListAddLast(&g_xTaskTable[pxCurrentTask->uiPrio], &pxCurrentTask->xLinkNode);			
-		}
-	}
-	
-	// 节拍计数增加
-	uiTickCount ++;
-	
-	// 检查CPU使用率
-	vCheckCpuUsage();
-	
-	// 防止中断嵌套调用 
-	vTaskExitCritical(status);
-
-    // 通知定时器模块节拍事件
-    vTimerModuleTickNotify();	
-	
-	// 这个过程中可能有任务延时完毕(delayTicks = 0)，进行一次调度。
-	vTaskSched();
-}
-
-/**********************************************************************************************************
-** Function name        :   vTaskGetInfo
-** Descriptions         :   获取任务相关信息
-** parameters           :   task 需要查询的任务
-** parameters           :   info 任务信息存储结构
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskGetInfo (Task_t * pxTask, TaskInfo_t * pxInfo)
-{
-	uint32_t * puiStackEnd;
-	
-   // 进入临界区
-    uint32_t uiStatus = uiTaskEnterCritical();
-
-    pxInfo->uiDelayTicks = pxTask->uiDelayTicks;                // 延时信息
-    pxInfo->uiPrio = pxTask->uiPrio;                            // 任务优先级
-    pxInfo->uiState = pxTask->uiState;                          // 任务状态
-    pxInfo->uiSlice = pxTask->uiSlice;                          // 剩余时间片
-    pxInfo->uiSuspendCount = pxTask->uiSuspendCount;            // 被挂起的次数
-
-	// 计算堆栈使用量
-	pxInfo->uiStackFree = 0;
-	puiStackEnd = pxTask->puiStackBase;
-	while((*puiStackEnd++ == 0) && (puiStackEnd <= pxTask->puiStackBase + pxTask->uiStackSize / sizeof(TaskStack_t)))
-	{
-		pxInfo->uiStackFree++;
-	}
-	
-	// 转换成字节数
-	pxInfo->uiStackFree *= sizeof(TaskStack_t);
-	
-    // 退出临界区
-    vTaskExitCritical(uiStatus); 
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskSched
-** Descriptions         :   任务调度接口。tinyOS通过它来选择下一个具体的任务，然后切换至该任务运行。
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSched ( void ) 
-{    
-	Task_t * pxTempTask;
-	uint32_t status = uiTaskEnterCritical();
-	
-	if(g_cSchedLockCount > 0)
-	{
-		vTaskExitCritical(status);
-		return;
-	}
-	
-	pxTempTask = pxTaskHightestReady();
-	if(pxTempTask != pxCurrentTask)
-	{
-		pxNextTask = pxTempTask;
-		vTaskSwitch();
-	}
-
-	vTaskExitCritical(status);
-}
-
-
-/**********************************************************************************************************
-** Function name        :   vTimeTaskWait
-** Descriptions         :   将任务加入延时队列中
-** input parameters     :   task    需要延时的任务
-**                          ticks   延时的ticks
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimeTaskWait (Task_t * pxTask, uint32_t uiTicks)
-{
-	int sum = 0, i;
-	Node_t *pxCur = g_xTaskDelayedList.xHeadNode.pxNextNode;
-	
-	for(i = 0; i < g_xTaskDelayedList.uiNodeCnt; i++)
-	{
-		Task_t *pxTemp = pxNodeParent(pxCur, Task_t, xDelayNode);
-		sum += pxTemp->uiDelayTicks;
-
-		if(sum > uiTicks)
-		{
-			pxTask->uiDelayTicks = uiTicks - (sum - pxTemp->uiDelayTicks);
-			vListInsertForward(&g_xTaskDelayedList, pxCur, &pxTask->xDelayNode);
-			break;
-		}
-		pxCur = pxListNext(&g_xTaskDelayedList, pxCur);
-	}
-	if(sum <= uiTicks)           // 如果延时队列中所有节点的时延之和小于等于当前任务，则将任务加入队列末尾
-	{
-		pxTask->uiDelayTicks = uiTicks - sum;
-		vListAddLast(&g_xTaskDelayedList, &pxTask->xDelayNode);
-	}
-	else if(pxTask->uiDelayTicks)  // 否则，任务已经插入到队列中，则将任务后面的第一个节点的时延进行更新
-	{
-		Task_t *pxTemp = pxNodeParent(pxCur, Task_t, xDelayNode);
-		pxTemp->uiDelayTicks -= pxTask->uiDelayTicks;
-	}
-    pxTask->uiState |= TINYOS_TASK_STATE_DELAYED;
-}
-
-/**********************************************************************************************************
-** Function name        :   vTimeTaskWakeUp
-** Descriptions         :   将延时的任务从延时队列中唤醒
-** input parameters     :   pxTask  需要唤醒的任务
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimeTaskWakeUp (Task_t * pxTask)
-{
-    vListRemove(&g_xTaskDelayedList, &(pxTask->xDelayNode));
-    pxTask->uiState &= ~TINYOS_TASK_STATE_DELAYED;
-}
-
-/**********************************************************************************************************
-** Function name        :   vTimeTaskRemove
-** Descriptions         :   将延时的任务从延时队列中移除
-** input parameters     :   task  需要移除的任务
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimeTaskRemove (Task_t * pxTask)
-{
-    vListRemove(&g_xTaskDelayedList, &(pxTask->xDelayNode));
-    pxTask->uiState &= ~TINYOS_TASK_STATE_DELAYED;
-}
-
-
-
-
+#include "tinyOS.h"
+#include "string.h"
+/****************** 全局变量 *************************/
+
+#if TINYOS_ENABLE_SMP
+// 每个核的当前任务与下一个任务，通过pxCurrentTask/pxNextTask访问本核的一项
+Task_t * g_pxCurrentTask[TINYOS_CORE_COUNT];
+Task_t * g_pxNextTask[TINYOS_CORE_COUNT];
+
+// 每个核的就绪任务数量（包括正在运行的任务），用于负载均衡
+static uint32_t g_uiCoreReadyCnt[TINYOS_CORE_COUNT];
+
+#define TASK_CORES                     TINYOS_CORE_COUNT
+#define prvTaskCore(pxTask)            ((pxTask)->uiCore)
+#define prvThisCore()                  uiPortCoreId()
+#define prvCoreCurrentTask(uiCore)     (g_pxCurrentTask[uiCore])
+#else
+// 当前任务：记录当前是哪个任务正在运行
+Task_t * pxCurrentTask;
+
+// 下一个即将运行的任务：在任务切换之前，需要先设置好该值
+Task_t * pxNextTask;
+
+// 单核时就绪表只有一份，核的序号恒为0
+#define TASK_CORES                     1
+#define prvTaskCore(pxTask)            0
+#define prvThisCore()                  0
+#define prvCoreCurrentTask(uiCore)     pxCurrentTask
+#endif
+
+// 就绪表：每个核每个优先级一个链表
+static List_t g_xTaskTable[TASK_CORES][TINYOS_PRO_COUNT];
+
+// 调度锁计数器，每个核一个：禁止调度只是让本核不切换任务，其它核照常调度
+static uint8_t g_cSchedLockCount[TASK_CORES];
+
+// 位图
+static Bitmap_t g_xTaskPrioBitmap[TASK_CORES];
+
+#if TINYOS_ENABLE_EDF
+// 设置了截止期、处于EDF优先级的任务放在EDF就绪堆中。该优先级上没有截止期的任务(直接以该优先级创建，
+// 或因互斥量继承、天花板临时提升)仍放在该优先级的链表中轮转，先于堆中的任务运行
+#define prvTaskInEdfHeap(pxTask)       ((pxTask)->uiPrio == TINYOS_EDF_PRIO && (pxTask)->uiRelDeadline)
+#define prvTaskPrioEmpty(uiCore, uiPrio)  (!uiListCount(&g_xTaskTable[uiCore][uiPrio]) \
+                                           && ((uiPrio) != TINYOS_EDF_PRIO || !uiEdfCount()))
+#else
+#define prvTaskPrioEmpty(uiCore, uiPrio)  (!uiListCount(&g_xTaskTable[uiCore][uiPrio]))
+#endif
+
+// 延时队列：分层时间轮，或按到期时间排序、存放差值的链表
+#if TINYOS_ENABLE_DELAY_WHEEL
+static Wheel_t g_xTaskDelayWheel;
+#else
+static List_t g_xTaskDelayedList;
+#endif
+
+// 时钟节拍计数
+uint32_t uiTickCount;
+
+// 中断中唤醒了可能抢占当前任务的任务，由vTaskYieldFromISR统一调度
+static uint8_t g_cYieldPending[TASK_CORES];
+
+// 所有任务按顺序由空闲任务填充与检查堆栈，检查完一轮后移到链表末尾
+static List_t g_xTaskStackList;
+
+// 主机移植上任务运行在单独的主机堆栈上，不会用到堆栈数组；硬件上pxStack即任务切换出去时保存的栈顶
+#ifdef TINYOS_PORT_LINUX
+#define prvTaskStackLive(pxTask, puiAddr)      0
+#define prvTaskStackTopFree(pxTask)            ((pxTask)->uiStackSize / sizeof(TaskStack_t))
+#else
+#define prvTaskStackLive(pxTask, puiAddr)      ((TaskStack_t *)(puiAddr) >= (pxTask)->pxStack)
+#define prvTaskStackTopFree(pxTask)            ((uint32_t)((pxTask)->pxStack - (pxTask)->puiStackBase))
+#endif
+
+// 从底部开始已经填充的字数，其余部分只有哨兵可以判断是否用过
+#if TINYOS_STACK_LAZY_FILL
+#define prvTaskStackFilled(pxTask)             ((pxTask)->uiStackFilled)
+#else
+#define prvTaskStackFilled(pxTask)             ((pxTask)->uiStackSize / sizeof(TaskStack_t))
+#endif
+
+static void prvTaskStackRemove (Task_t * pxTask);
+static void prvTaskStackPaint (TaskStack_t * puiStack, uint32_t uiWords);
+static uint32_t prvTaskDelayRemaining (Task_t * pxTask);
+
+extern void vCheckCpuUsage(void);
+
+#if TINYOS_ENABLE_SMP
+static uint32_t prvTaskIdlestCore (void);
+static void prvTaskCoreKick (uint32_t uiCore, Task_t * pxTask, uint8_t cRemoved);
+static void prvTaskBalance (void);
+#endif
+
+/**********************************************************************************************************
+** Function name        :   vTaskInit
+** Descriptions         :   初始化任务
+** parameters           :   pxTask           要初始化的任务结构
+** parameters           :   pxTaskCode       任务的入口函数
+** parameters           :   pvParam          传递给任务的运行参数
+** parameters           :   uiPrio           任务的优先级
+** parameters           :   pxStack          任务堆栈的起始地址（低地址）
+** parameters           :   uiStackSize      任务堆栈大小
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskInit(Task_t * pxTask, TaskFunction_pt pxTaskCode, void *pvParam, uint32_t uiPrio, TaskStack_t * pxStack, uint32_t uiStackSize)
+{
+	uint32_t uiStatus;
+	
+	// 为了简化代码，tinyOS无论是在启动时切换至第一个任务，还是在运行过程中在不同间任务切换
+    // 所执行的操作都是先保存当前任务的运行环境参数（CPU寄存器值）的堆栈中(如果已经运行运行起来的话)，然后再
+    // 取出从下一个任务的堆栈中取出之前的运行环境参数，然后恢复到CPU寄存器
+    // 对于切换至之前从没有运行过的任务，我们为它配置一个“虚假的”保存现场，然后使用该现场恢复。
+	pxTask->puiStackBase = pxStack;
+	pxTask->uiStackSize = uiStackSize;
+#if TINYOS_STACK_LAZY_FILL
+	{
+		// 只写入哨兵，哨兵之间的部分可能残留以前的数据，由空闲任务在任务用到之前填充
+		uint32_t i;
+		for(i = 0; i < uiStackSize / sizeof(TaskStack_t); i += TINYOS_STACK_SENTINEL_WORDS)
+		{
+			pxStack[i] = TINYOS_STACK_PAINT;
+		}
+		pxTask->uiStackFilled = 0;
+		pxTask->cStackFilling = 1;
+	}
+#else
+	prvTaskStackPaint(pxStack, uiStackSize / sizeof(TaskStack_t));
+#endif
+	pxTask->pxStack = pxTaskStackInit(pxStack, uiStackSize, pxTaskCode, pvParam);   // 由移植层构造初始现场并保存栈顶
+	pxTask->uiStackFreeMin = prvTaskStackTopFree(pxTask);                          // 初始现场以下都没有用过
+	pxTask->uiStackScan = 0;
+#if !TINYOS_ENABLE_DELAY_WHEEL
+	pxTask->uiDelayTicks = 0;
+#endif
+	pxTask->uiPrio = uiPrio;
+	pxTask->uiBasePrio = uiPrio;
+	vListInit(&pxTask->xMutexHeldList);
+	pxTask->uiState = TINYOS_TASK_STATE_RDY;
+	pxTask->uiSliceQuantum = TINYOS_SLICE_MAX;
+	pxTask->uiSlice = TINYOS_SLICE_MAX;
+	pxTask->uiRunTicks = 0;
+	pxTask->uiSuspendCount = 0;
+	pxTask->vCleanResource = (void (*)(void *))0;
+	pxTask->pvCleanParam = (void *)0;
+	pxTask->cRequsetDeleteFlag = 0;
+	
+	// 任务正在等待的事件类型
+    pxTask->pxWaitEvent = (Event_t *)0;
+	pxTask->pvEventMsg = (void *)0;
+	pxTask->uiWaitEventResult = eErrorNoError;
+	
+#if TINYOS_ENABLE_EDF
+	pxTask->uiDeadline = 0;
+	pxTask->uiRelDeadline = 0;
+	pxTask->uiPeriod = 0;
+	pxTask->uiRelease = 0;
+	pxTask->uiDeadlineMissCnt = 0;
+#endif
+
+#if TINYOS_ENABLE_BUDGET
+	pxTask->uiBudget = 0;
+	pxTask->uiBudgetOverrunCnt = 0;
+	pxTask->cBudgetReplCnt = 0;
+	vNodeInit(&pxTask->xBudgetNode);
+#endif
+
+#if TINYOS_ENABLE_ADMISSION
+	pxTask->uiAdmissionPeriod = 0;
+	pxTask->uiExecMax = 0;
+	pxTask->ullExecJob = 0;
+	pxTask->uiResponseTime = 0;
+	vNodeInit(&pxTask->xAdmissionNode);
+#endif
+
+#if TINYOS_ENABLE_SMP
+	pxTask->uiAffinity = TINYOS_CORE_ANY;
+	pxTask->uiMigrateCnt = 0;
+#endif
+	
+#if TINYOS_ENABLE_DELAY_WHEEL
+	vWheelNodeInit(&pxTask->xDelayNode);
+#else
+	vNodeInit(&pxTask->xDelayNode);
+#endif
+	vNodeInit(&pxTask->xLinkNode);                       // 初始化链接结点
+	vNodeInit(&pxTask->xEventNode);
+	pxTask->pxEventRunPeer = &pxTask->xEventNode;
+	vNodeInit(&pxTask->xStackNode);
+	TRACE_TASK_CREATE(pxTask);
+	
+	uiStatus = uiTaskEnterCritical();
+#if TINYOS_ENABLE_SMP
+	pxTask->uiCore = prvTaskIdlestCore();                // 新任务放到就绪任务最少的核
+#endif
+	vListAddLast(&g_xTaskStackList, &pxTask->xStackNode);
+	vTaskSchedRdy(pxTask);
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vHardwareInit
+** Descriptions         :   硬件初始化
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vHardwareInit(void)
+{
+	vSetSysTickPeriod(TINYOS_ONE_TICK_TO_MS);
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskDelayedInit
+** Descriptions         :   初始化任务延时机制
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskDelayedInit (void) 
+{
+#if TINYOS_ENABLE_DELAY_WHEEL
+	vWheelInit(&g_xTaskDelayWheel);
+#else
+    vListInit(&g_xTaskDelayedList);
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimeTickInit
+** Descriptions         :   初始化时钟节拍计数
+** input parameters     :   无
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimeTickInit(void)
+{
+	uiTickCount = 0;
+	vClockInit();
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskDelay
+** Descriptions         :   使当前任务进入延时状态。
+** parameters           :   delay 延时多少个ticks
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskDelay(uint32_t uiDelay)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	TRACE_TASK_DELAY(pxCurrentTask, uiDelay);
+	// 设置延时值，插入延时队列
+	vTimeTaskWait(pxCurrentTask, uiDelay);
+	// 将任务从就绪表中移除
+	vTaskSchedUnRdy(pxCurrentTask);
+	vTaskExitCritical(uiStatus);
+	vTaskSched();
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskSchedInit
+** Descriptions         :   初始化调度器
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSchedInit (void)
+{
+	int i = 0, c;
+	TRACE_INIT();
+	CRITICAL_PROFILE_INIT();
+	STACK_PROFILE_INIT();
+	for(c = 0; c < TASK_CORES; c++)
+	{
+		g_cSchedLockCount[c] = 0;
+		vBitmapInit(&g_xTaskPrioBitmap[c]);
+		for(i = 0; i < TINYOS_PRO_COUNT; i++)
+		{
+			vListInit(&g_xTaskTable[c][i]);
+		}
+	}
+#if TINYOS_ENABLE_EDF
+	vEdfInit();
+#endif
+#if TINYOS_ENABLE_BUDGET
+	vBudgetInit();
+#endif
+#if TINYOS_ENABLE_ADMISSION
+	vAdmissionInit();
+#endif
+	vListInit(&g_xTaskStackList);
+}
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskSchedEnable
+** Descriptions         :   使能任务调度
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSchedEnable(void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	if(g_cSchedLockCount[prvThisCore()] > 0)
+	{
+		if(--g_cSchedLockCount[prvThisCore()] == 0)
+		{
+			vTaskSched();
+		}		
+	}
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskSchedDisable
+** Descriptions         :   禁止任务调度
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSchedDisable(void)
+{
+	uint32_t status = uiTaskEnterCritical();
+	
+	if(g_cSchedLockCount[prvThisCore()] < 255)
+	{
+		g_cSchedLockCount[prvThisCore()]++;
+	}
+	
+	vTaskExitCritical(status);
+}
+
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskSchedRdy
+** Descriptions         :   将任务设置为就绪状态
+** input parameters     :   task    等待设置为就绪状态的任务
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSchedRdy (Task_t * pxTask)
+{
+#if TINYOS_ENABLE_BUDGET
+	// 预算用完而暂停的任务在预算补充时才进入就绪表
+	if(pxTask->uiState & TINYOS_TASK_STATE_THROTTLED)
+		return;
+#endif
+	TRACE_TASK_READY(pxTask);
+#if TINYOS_ENABLE_SMP
+	// 绑定了核的任务在就绪时迁移过去，正在运行的任务不能换核
+	if(pxTask->uiAffinity != TINYOS_CORE_ANY && pxTask->uiCore != pxTask->uiAffinity
+		&& g_pxCurrentTask[pxTask->uiCore] != pxTask)
+		pxTask->uiCore = pxTask->uiAffinity;
+#endif
+#if TINYOS_ENABLE_EDF
+	// 有截止期的EDF任务放入按截止期排序的堆中
+	if(prvTaskInEdfHeap(pxTask))
+		vEdfReady(pxTask);
+	else
+#endif
+	vListAddLast(&g_xTaskTable[prvTaskCore(pxTask)][pxTask->uiPrio], &pxTask->xLinkNode);
+    vBitmapSet(&g_xTaskPrioBitmap[prvTaskCore(pxTask)], pxTask->uiPrio);
+#if TINYOS_ENABLE_SMP
+	g_uiCoreReadyCnt[pxTask->uiCore]++;
+	prvTaskCoreKick(pxTask->uiCore, pxTask, 0);
+#endif
+}
+
+/************************************************************************************************************
+** Descriptions         :   vTaskSchedUnRdy
+** Descriptions         :   将任务从就绪列表中移除
+** input parameters     :   task    等待从就绪列表中移除的任务
+** output parameters    :   None
+** Returned value       :   None
+***********************************************************************************************************/
+void vTaskSchedUnRdy (Task_t * pxTask)
+{
+#if TINYOS_ENABLE_BUDGET
+	if(pxTask->uiState & TINYOS_TASK_STATE_THROTTLED)
+		return;
+#endif
+#if TINYOS_ENABLE_EDF
+	if(prvTaskInEdfHeap(pxTask))
+		vEdfUnReady(pxTask);
+	else
+#endif
+    vListRemove(&g_xTaskTable[prvTaskCore(pxTask)][pxTask->uiPrio], &pxTask->xLinkNode);
+	if(prvTaskPrioEmpty(prvTaskCore(pxTask), pxTask->uiPrio))
+		vBitmapClear(&g_xTaskPrioBitmap[prvTaskCore(pxTask)], pxTask->uiPrio);
+#if TINYOS_ENABLE_SMP
+	g_uiCoreReadyCnt[pxTask->uiCore]--;
+	prvTaskCoreKick(pxTask->uiCore, pxTask, 1);
+#endif
+}
+
+/************************************************************************************************************
+** Descriptions         :   vTaskSchedUnRdy
+** Descriptions         :   将任务从就绪列表中移除
+** input parameters     :   task    等待从就绪列表中移除的任务
+** output parameters    :   None
+** Returned value       :   None
+***********************************************************************************************************/
+void vTaskSchedRemove (Task_t * pxTask)
+{
+#if TINYOS_ENABLE_BUDGET
+	if(pxTask->uiState & TINYOS_TASK_STATE_THROTTLED)
+		return;
+#endif
+#if TINYOS_ENABLE_EDF
+	if(prvTaskInEdfHeap(pxTask))
+		vEdfUnReady(pxTask);
+	else
+#endif
+    vListRemove(&g_xTaskTable[prvTaskCore(pxTask)][pxTask->uiPrio], &pxTask->xLinkNode);
+	if(prvTaskPrioEmpty(prvTaskCore(pxTask), pxTask->uiPrio))
+		vBitmapClear(&g_xTaskPrioBitmap[prvTaskCore(pxTask)], pxTask->uiPrio);
+#if TINYOS_ENABLE_SMP
+	g_uiCoreReadyCnt[pxTask->uiCore]--;
+	prvTaskCoreKick(pxTask->uiCore, pxTask, 1);
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskSetCleanCallFunc
+** Descriptions         :   设置任务被删除时调用的清理函数
+** parameters           :   pxTask  待设置的任务
+** parameters           :   pvClean  清理函数入口地址
+** parameters           :   pvParam  传递给清理函数的参数
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSetCleanCallFunc (Task_t * pxTask, void (*pvClean)(void *param), void * pvParam)
+{
+	pxTask->vCleanResource = pvClean;
+	pxTask->pvCleanParam = pvParam;
+}
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskForceDelete
+** Descriptions         :   强制删除指定的任务
+** parameters           :   task  需要删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskForceDelete(Task_t * pxTask)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	if( pxTask->uiState & TINYOS_TASK_STATE_DELAYED)  // 如果任务位于延时队列中
+	{
+		vTimeTaskRemove(pxTask);
+	}
+	else if(!(pxTask->uiState & TINYOS_TASK_STATE_SUSPEND))  // 如果任务处于就绪链表中
+	{
+		vTaskSchedRemove (pxTask);
+	}
+	
+#if TINYOS_ENABLE_EDF
+	vEdfTaskDelete(pxTask);
+#endif
+#if TINYOS_ENABLE_BUDGET
+	vBudgetTaskDelete(pxTask);
+#endif
+#if TINYOS_ENABLE_ADMISSION
+	vAdmissionTaskDelete(pxTask);
+#endif
+	prvTaskStackRemove(pxTask);
+	STACK_PROFILE_TASK_DELETE(pxTask);
+	pxTask->uiState |= TINYOS_TASK_STATE_DESTROYED;
+	
+	if(pxTask->vCleanResource)                        // 如果任务有清理资源函数，则调用
+		pxTask->vCleanResource(pxTask->pvCleanParam);
+	
+	if(pxCurrentTask == pxTask)                       // 如果被删除的是当前任务，则进行任务调度
+		vTaskSched();
+	
+	vTaskExitCritical(uiStatus);
+}
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskRequestDelete
+** Descriptions         :   请求删除某个任务，由任务自己决定是否删除自己
+** parameters           :   pxTask  需要删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskRequestDelete(Task_t * pxTask)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	pxTask->cRequsetDeleteFlag = 1;
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   cTaskIsRequestedDelete
+** Descriptions         :   是否已经被请求删除自己
+** parameters           :   无
+** Returned value       :   非0表示请求删除，0表示无请求
+***********************************************************************************************************/
+uint8_t cTaskIsRequestedDelete (void)
+{
+	uint8_t cDelete;
+	uint32_t uiStatus = uiTaskEnterCritical();
+	cDelete = pxCurrentTask->cRequsetDeleteFlag;
+	vTaskExitCritical(uiStatus);
+	return cDelete;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskDeleteSelf
+** Descriptions         :   删除当前任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskDeleteSelf (void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	// 任务在调用该函数时，必须处于就绪态，不可能处于延时或者挂起状态
+	// 所以，只要从就绪队列中移除即可
+	vTaskSchedRemove(pxCurrentTask);
+#if TINYOS_ENABLE_EDF
+	vEdfTaskDelete(pxCurrentTask);
+#endif
+#if TINYOS_ENABLE_BUDGET
+	vBudgetTaskDelete(pxCurrentTask);
+#endif
+#if TINYOS_ENABLE_ADMISSION
+	vAdmissionTaskDelete(pxCurrentTask);
+#endif
+	prvTaskStackRemove(pxCurrentTask);
+	STACK_PROFILE_TASK_DELETE(pxCurrentTask);
+	pxCurrentTask->uiState |= TINYOS_TASK_STATE_DESTROYED;
+	
+	if(pxCurrentTask->vCleanResource)
+		pxCurrentTask->vCleanResource(pxCurrentTask->pvCleanParam);
+	
+	vTaskSched();
+	
+	vTaskExitCritical(uiStatus);
+}
+
+
+/**********************************************************************************************************
+** Function name        :   tTaskSuspend
+** Descriptions         :   挂起指定的任务
+** parameters           :   task        待挂起的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSuspend(Task_t * pxTask)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	if(!(pxTask->uiState & TINYOS_TASK_STATE_DELAYED))
+	{
+        // 增加挂起计数，仅当该任务被执行第一次挂起操作时，才考虑是否
+        // 要执行任务切换操作
+        if (++pxTask->uiSuspendCount <= 1)
+		{
+			pxTask->uiState |= TINYOS_TASK_STATE_SUSPEND;
+			TRACE_TASK_SUSPEND(pxTask);
+			vTaskSchedUnRdy(pxTask);   // 从就绪队列中移除该任务
+			
+			if(pxTask == pxCurrentTask)  // 如果该任务为当前任务，则进行任务切换
+				vTaskSched();
+		}
+	}
+	
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskWakeUp
+** Descriptions         :   唤醒被挂起的任务
+** parameters           :   task        待唤醒的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskWakeUp (Task_t * pxTask)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	if((pxTask->uiState & TINYOS_TASK_STATE_SUSPEND))
+	{
+        // 递减挂起计数，如果为0了，则清除挂起标志，同时设置进入就绪状态
+        if (--pxTask->uiSuspendCount == 0) 
+		{
+			pxTask->uiState &= ~TINYOS_TASK_STATE_SUSPEND;
+			vTaskSchedRdy(pxTask);
+			
+			vTaskSched();  // 因为被唤醒任务可能优先级更高，所以需要进行任务调度
+		}
+	}
+	
+	vTaskExitCritical(uiStatus);
+}
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskYield
+** Descriptions         :   当前任务主动让出CPU，移到同优先级就绪队列的末尾，并重新获得完整的时间片
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskYield (void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	List_t * pxList = &g_xTaskTable[prvTaskCore(pxCurrentTask)][pxCurrentTask->uiPrio];
+	
+	if(uiListCount(pxList) > 1)
+	{
+		vListRemove(pxList, &pxCurrentTask->xLinkNode);
+		vListAddLast(pxList, &pxCurrentTask->xLinkNode);
+		pxCurrentTask->uiSlice = pxCurrentTask->uiSliceQuantum;
+		vTaskSched();
+	}
+	
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskSetSlice
+** Descriptions         :   设置任务的时间片长度。同优先级的任务按各自的时间片轮转，运行时间之比即时间片之比
+** parameters           :   pxTask 任务
+** parameters           :   uiSliceQuantum 时间片长度(节拍数)，为0表示不参与时间片轮转
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSetSlice (Task_t * pxTask, uint32_t uiSliceQuantum)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	pxTask->uiSliceQuantum = uiSliceQuantum;
+	
+	// 剩余的时间片不超过新的长度，缩短时间片立即生效
+	if(pxTask->uiSlice > uiSliceQuantum || !pxTask->uiSlice)
+		pxTask->uiSlice = uiSliceQuantum;
+	
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   prvTaskStackPaint
+** Descriptions         :   用TINYOS_STACK_PAINT填充一段堆栈
+** parameters           :   puiStack 起始地址
+** parameters           :   uiWords 字数
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTaskStackPaint (TaskStack_t * puiStack, uint32_t uiWords)
+{
+	while(uiWords--)
+	{
+		*puiStack++ = TINYOS_STACK_PAINT;
+	}
+}
+
+#if TINYOS_STACK_LAZY_FILL
+/**********************************************************************************************************
+** Function name        :   prvTaskStackFillStep
+** Descriptions         :   为任务填充一段堆栈。只在上方的哨兵完好、并且这一段位于任务保存的栈顶以下时才填充，
+**                          既不会破坏任务正在使用的数据，也不会抹掉堆栈曾经用到的痕迹。条件不满足时该任务的填充结束
+** parameters           :   pxTask 任务，不能正在其它核上运行
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTaskStackFillStep (Task_t * pxTask)
+{
+	TaskStack_t * puiSegment = pxTask->puiStackBase + pxTask->uiStackFilled;
+	uint32_t uiNext = pxTask->uiStackFilled + TINYOS_STACK_SENTINEL_WORDS;
+	
+	if((pxTask != pxCurrentTask) && (uiNext < pxTask->uiStackSize / sizeof(TaskStack_t))
+		&& (puiSegment[TINYOS_STACK_SENTINEL_WORDS] == TINYOS_STACK_PAINT) && !prvTaskStackLive(pxTask, &puiSegment[TINYOS_STACK_SENTINEL_WORDS]))
+	{
+		prvTaskStackPaint(puiSegment, TINYOS_STACK_SENTINEL_WORDS);
+		pxTask->uiStackFilled = uiNext;
+	}
+	else
+	{
+		// 哨兵已被改写、到达了任务正在使用的部分，或者是调用者自己正在使用的堆栈
+		pxTask->cStackFilling = 0;
+	}
+}
+#endif
+
+/**********************************************************************************************************
+** Function name        :   prvTaskStackScanStep
+** Descriptions         :   从堆栈底部向上查找第一个不是填充图案的字，每次最多检查TINYOS_STACK_MONITOR_WORDS个字，
+**                          下次从本次停下的位置继续。只需查找到上次测得的剩余量为止，因为使用量只会增加。
+**                          还没有填充的部分按哨兵判断：上方的哨兵完好，说明任务没有用到这一段
+** parameters           :   pxTask 任务
+** Returned value       :   1表示本轮检查完成，0表示还需要继续
+***********************************************************************************************************/
+static uint32_t prvTaskStackScanStep (Task_t * pxTask)
+{
+	uint32_t * puiStack = pxTask->puiStackBase;
+	uint32_t uiWords = pxTask->uiStackSize / sizeof(TaskStack_t);
+	uint32_t uiEnd = pxTask->uiStackFreeMin;
+	uint32_t uiScan = pxTask->uiStackScan;
+	uint32_t uiBudget = TINYOS_STACK_MONITOR_WORDS;
+	
+	while(uiBudget && (uiScan < uiEnd))
+	{
+		uint32_t * puiWord = &puiStack[uiScan];
+		
+		if((uiScan >= prvTaskStackFilled(pxTask)) && (uiScan % TINYOS_STACK_SENTINEL_WORDS == 0)
+			&& (uiScan + TINYOS_STACK_SENTINEL_WORDS < uiWords) && (puiWord[TINYOS_STACK_SENTINEL_WORDS] == TINYOS_STACK_PAINT))
+		{
+			uiScan += TINYOS_STACK_SENTINEL_WORDS;
+			uiBudget--;
+		}
+		else if((uiEnd - uiScan >= 4) && (((puiWord[0] ^ TINYOS_STACK_PAINT) | (puiWord[1] ^ TINYOS_STACK_PAINT)
+			| (puiWord[2] ^ TINYOS_STACK_PAINT) | (puiWord[3] ^ TINYOS_STACK_PAINT)) == 0))
+		{
+			// 一次比较4个字，绝大多数时间花在没有用过的部分上
+			uiScan += 4;
+			uiBudget = uiBudget > 4 ? uiBudget - 4 : 0;
+		}
+		else if(puiWord[0] == TINYOS_STACK_PAINT)
+		{
+			uiScan++;
+			uiBudget--;
+		}
+		else
+		{
+			uiEnd = uiScan;
+		}
+	}
+	
+	if(uiScan < uiEnd)
+	{
+		pxTask->uiStackScan = uiScan;
+		return 0;
+	}
+	
+	pxTask->uiStackFreeMin = uiEnd;
+	pxTask->uiStackScan = 0;
+	return 1;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskStackMonitorStep
+** Descriptions         :   由空闲任务调用，处理链表中的第一个任务：堆栈还没有填充完成的填充一段，否则检查一段
+**                          堆栈的使用量，检查完一轮后移到链表末尾。每次只在临界区中处理很短的一段
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskStackMonitorStep (void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	Node_t * pxNode = pxListFirst(&g_xTaskStackList);
+	
+	if(pxNode)
+	{
+		Task_t * pxTask = pxNodeParent(pxNode, Task_t, xStackNode);
+		uint32_t uiDone;
+#if TINYOS_STACK_LAZY_FILL
+		uint32_t uiCore;
+		
+		// 正在其它核上运行的任务，保存的栈顶已经过时，以后再填充
+		for(uiCore = 0; uiCore < TASK_CORES; uiCore++)
+		{
+			if(uiCore != prvThisCore() && prvCoreCurrentTask(uiCore) == pxTask)
+				break;
+		}
+		
+		if(pxTask->cStackFilling && (uiCore == TASK_CORES))
+		{
+			prvTaskStackFillStep(pxTask);
+			uiDone = 0;
+		}
+		else if(pxTask->cStackFilling)
+		{
+			uiDone = 1;
+		}
+		else
+#endif
+		{
+			uiDone = prvTaskStackScanStep(pxTask);
+		}
+		
+		if(uiDone)
+		{
+			vListRemove(&g_xTaskStackList, &pxTask->xStackNode);
+			vListAddLast(&g_xTaskStackList, &pxTask->xStackNode);
+		}
+	}
+	
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   prvTaskStackRemove
+** Descriptions         :   任务被删除时，将其从堆栈检查链表中移除
+** parameters           :   pxTask 任务
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTaskStackRemove (Task_t * pxTask)
+{
+	if(pxTask->xStackNode.pxNextNode != &pxTask->xStackNode)
+	{
+		vListRemove(&g_xTaskStackList, &pxTask->xStackNode);
+		vNodeInit(&pxTask->xStackNode);
+	}
+}
+
+#if TINYOS_ENABLE_SMP
+/**********************************************************************************************************
+** Function name        :   vTaskSetAffinity
+** Descriptions         :   将任务绑定到指定的核，绑定后不参与负载均衡。正在其它核上运行的任务在下次就绪时迁移
+** parameters           :   pxTask 任务
+** parameters           :   uiCore 核的序号，TINYOS_CORE_ANY或不存在的核表示取消绑定
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSetAffinity (Task_t * pxTask, uint32_t uiCore)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	if(uiCore >= uiPortCoreCount())
+		uiCore = TINYOS_CORE_ANY;
+	pxTask->uiAffinity = uiCore;
+	
+	// 就绪的任务立即迁移。当前任务迁移自己时，在切换出去之前一直持有内核锁，目标核不会提前运行它
+	if(uiCore != TINYOS_CORE_ANY && uiCore != pxTask->uiCore && pxTask->uiState == TINYOS_TASK_STATE_RDY
+		&& (pxTask == pxCurrentTask || g_pxCurrentTask[pxTask->uiCore] != pxTask))
+	{
+		vTaskSchedUnRdy(pxTask);
+		pxTask->uiCore = uiCore;
+		vTaskSchedRdy(pxTask);
+		
+		if(pxTask == pxCurrentTask)
+			vTaskSched();
+	}
+	
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   prvTaskIdlestCore
+** Descriptions         :   就绪任务最少的核
+** parameters           :   无
+** Returned value       :   核的序号
+***********************************************************************************************************/
+static uint32_t prvTaskIdlestCore (void)
+{
+	uint32_t uiCore = 0, i;
+	
+	for(i = 1; i < uiPortCoreCount(); i++)
+	{
+		if(g_uiCoreReadyCnt[i] < g_uiCoreReadyCnt[uiCore])
+			uiCore = i;
+	}
+	return uiCore;
+}
+
+/**********************************************************************************************************
+** Function name        :   prvTaskCoreKick
+** Descriptions         :   修改了其它核的就绪表后调用，该核的调度结果可能改变时发送核间中断
+** parameters           :   uiCore 就绪表所属的核
+** parameters           :   pxTask 加入或移出的任务
+** parameters           :   cRemoved 1表示移出，0表示加入
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTaskCoreKick (uint32_t uiCore, Task_t * pxTask, uint8_t cRemoved)
+{
+	Task_t * pxRunning = g_pxCurrentTask[uiCore];
+	
+	if(uiCore == prvThisCore())
+		return;
+	
+	// 加入的任务优先级更高，或者移出的正是该核正在运行的任务
+	if(cRemoved ? (pxRunning == pxTask) : (!pxRunning || pxTask->uiPrio < pxRunning->uiPrio))
+		vPortCoreSignal(uiCore);
+}
+
+/**********************************************************************************************************
+** Function name        :   prvTaskBalance
+** Descriptions         :   负载均衡：就绪任务最多与最少的核相差2个以上时，从最多的核上迁移一个没有运行、
+**                          没有绑定的任务到最少的核。优先迁移优先级最高的等待任务，它最需要空闲的核
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTaskBalance (void)
+{
+	uint32_t uiBusy = 0, uiIdle = 0, uiPrio, i;
+	
+	for(i = 1; i < uiPortCoreCount(); i++)
+	{
+		if(g_uiCoreReadyCnt[i] > g_uiCoreReadyCnt[uiBusy])
+			uiBusy = i;
+		if(g_uiCoreReadyCnt[i] < g_uiCoreReadyCnt[uiIdle])
+			uiIdle = i;
+	}
+	
+	// 只差一个任务时迁移过去也不会更均衡，只会来回摆动
+	if(g_uiCoreReadyCnt[uiBusy] < g_uiCoreReadyCnt[uiIdle] + 2)
+		return;
+	
+	for(uiPrio = uiBitmapGetFirstSet(&g_xTaskPrioBitmap[uiBusy]); uiPrio < TINYOS_PRO_COUNT; uiPrio++)
+	{
+		List_t * pxList = &g_xTaskTable[uiBusy][uiPrio];
+		Node_t * pxNode;
+		
+		for(pxNode = pxListFirst(pxList); pxNode; pxNode = pxListNext(pxList, pxNode))
+		{
+			Task_t * pxTask = pxNodeParent(pxNode, Task_t, xLinkNode);
+			
+			if(pxTask == g_pxCurrentTask[uiBusy] || pxTask->uiAffinity != TINYOS_CORE_ANY)
+				continue;
+			
+			vTaskSchedUnRdy(pxTask);
+			pxTask->uiCore = uiIdle;
+			pxTask->uiMigrateCnt++;
+			vTaskSchedRdy(pxTask);
+			return;
+		}
+	}
+}
+#endif
+
+/**********************************************************************************************************
+** Function name        :   pxTaskHightestReady
+** Descriptions         :   获取优先级最高的任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+Task_t * pxTaskHightestReady (void)
+{
+	uint32_t uiCore = prvThisCore();
+	uint32_t uiPrio = uiBitmapGetFirstSet(&g_xTaskPrioBitmap[uiCore]);
+	Node_t *pxFirstNode;
+	
+	pxFirstNode = pxListFirst(&g_xTaskTable[uiCore][uiPrio]);
+#if TINYOS_ENABLE_EDF
+	// EDF优先级的链表为空时才运行堆中截止期最早的任务
+	if(uiPrio == TINYOS_EDF_PRIO && !pxFirstNode)
+		return pxEdfFirst();
+#endif
+	return pxNodeParent(pxFirstNode, Task_t, xLinkNode);
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskSetNext
+** Descriptions         :   设置下一个任务
+** parameters           :   pxTask 
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSetNext(Task_t *pxTask)
+{
+	pxNextTask = pxTask;
+#if TINYOS_ENABLE_ADMISSION
+	vAdmissionSwitch(pxTask);
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   prvTaskSliceTick
+** Descriptions         :   统计核上当前任务的运行节拍，时间片用完时将其移到同优先级链表的末尾
+** parameters           :   uiCore 核的序号
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTaskSliceTick (uint32_t uiCore)
+{
+	Task_t * pxTask = prvCoreCurrentTask(uiCore);
+	List_t * pxList;
+	
+	if(!pxTask)
+		return;
+	
+	// 记录任务实际运行的节拍数，用于核对各任务的时间片权重
+	pxTask->uiRunTicks++;
+	
+#if TINYOS_ENABLE_BUDGET
+	// 预算用完的任务已被降级或暂停，不再参与原优先级的轮转
+	if(pxTask->uiBudget && uiBudgetCharge(pxTask))
+		return;
+#endif
+	
+	/* 如果时间片用完的话，则将当前任务移动到链表的最后一项，从而在调度函数中完成任务切换 */
+	/* 时间片长度为0的任务不参与轮转，一直运行到主动放弃CPU */
+	if(pxTask->uiSliceQuantum && --pxTask->uiSlice == 0)
+	{
+		pxTask->uiSlice = pxTask->uiSliceQuantum;
+		pxList = &g_xTaskTable[uiCore][pxTask->uiPrio];
+		
+#if TINYOS_ENABLE_EDF
+		/* EDF就绪堆中的任务不在该优先级的链表里，顺序由截止期决定，不轮转 */
+		if(prvTaskInEdfHeap(pxTask))
+			return;
+#endif
+		
+		/* 任务可能已经调用延时等函数离开了就绪链表，只是还没有切换出去，此时不能再移动它的结点 */
+		if(pxTask->uiState == TINYOS_TASK_STATE_RDY)
+		{
+			vListRemove(pxList, &pxTask->xLinkNode);
+			vListAddLast(pxList, &pxTask->xLinkNode);
+#if TINYOS_ENABLE_SMP
+			// 其它核上的轮转由该核自己完成切换
+			if(uiCore != prvThisCore() && uiListCount(pxList) > 1)
+				vPortCoreSignal(uiCore);
+#endif
+		}
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskSystemTickHandler
+** Descriptions         :   系统时钟节拍处理
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSystemTickHandler(void)
+{
+#if TINYOS_ENABLE_SMP
+	uint32_t i;
+#endif
+	uint32_t status = uiTaskEnterCritical();
+#if TINYOS_ENABLE_DELAY_WHEEL
+	WheelNode_t *pxDelay;
+	
+	// 时间轮转过一个槽，槽中的任务都在本节拍到期
+	vWheelTick(&g_xTaskDelayWheel);
+	while((pxDelay = pxWheelDue(&g_xTaskDelayWheel)) != (WheelNode_t *)0)
+	{
+		Task_t *pxTask = pxNodeParent(pxDelay, Task_t, xDelayNode);
+		
+		vTimeTaskWakeUp(pxTask);
+		vTaskSchedRdy(pxTask);
+		if (pxTask->pxWaitEvent)
+		{
+			vEventRemoveTask(pxTask, (void *)0, eErrorTimeout);
+		}
+	}
+#else
+	Node_t *pxNode = pxListFirst(&g_xTaskDelayedList);
+	
+	if(pxNode)
+	{
+		Task_t *pxTask = pxNodeParent(pxNode, Task_t, xDelayNode);     
+		pxTask->uiDelayTicks--;
+		while(!pxTask->uiDelayTicks)
+		{
+			vTimeTaskWakeUp(pxTask);   // 将任务从延时队列中删除
+			vTaskSchedRdy(pxTask);     // 根据优先级将任务加入就绪优先级数组
+			
+			// 如果任务还处于等待事件的状态，则将其从事件等待队列中唤醒
+			if (pxTask->pxWaitEvent)
+			{
+				vEventRemoveTask(pxTask, (void *)0, eErrorTimeout);
+			}
+			
+			pxNode = pxListNext(&g_xTaskDelayedList, pxNode);
+			if(!pxNode) break;
+			pxTask = pxNodeParent(pxNode, Task_t, xDelayNode);
+		}
+	}
+#endif
+	
+#if TINYOS_ENABLE_SMP
+	// 节拍只在核0上处理，各核的时间片都在这里统计
+	for(i = 0; i < uiPortCoreCount(); i++)
+	{
+		prvTaskSliceTick(i);
+	}
+	
+	if(uiTickCount % TINYOS_SMP_BALANCE_TICKS == 0)
+		prvTaskBalance();
+#else
+	prvTaskSliceTick(0);
+#endif
+	
+	// 节拍计数增加
+	uiTickCount ++;
+	
+#if TINYOS_ENABLE_BUDGET
+	// 补充到期的CPU预算
+	vBudgetTick();
+#endif
+	
+	// 检查CPU使用率
+	vCheckCpuUsage();
+	
+	// 防止中断嵌套调用 
+	vTaskExitCritical(status);
+
+    // 通知定时器模块节拍事件
+    vTimerModuleTickNotify();	
+	
+	// 这个过程中可能有任务延时完毕(delayTicks = 0)，进行一次调度。
+	vTaskSched();
+}
+
+/**********************************************************************************************************
+** Function name        :   uiTaskNextWakeTicks
+** Descriptions         :   查询距离延时队列中最早的任务到期还有多少个节拍
+** parameters           :   无
+** Returned value       :   节拍数，延时队列为空时返回TINYOS_TICKS_NONE
+***********************************************************************************************************/
+uint32_t uiTaskNextWakeTicks (void)
+{
+#if TINYOS_ENABLE_DELAY_WHEEL
+	// 时间轮上层的槽下移时也需要处理节拍，返回值可能早于实际的到期时间
+	uint32_t uiTicks = uiWheelNextTicks(&g_xTaskDelayWheel);
+#else
+	Node_t * pxNode = pxListFirst(&g_xTaskDelayedList);
+	uint32_t uiTicks = TINYOS_TICKS_NONE;
+	
+	// 延时队列按差值存储，首个结点的延时即为最早到期的时间
+	if(pxNode)
+	{
+		Task_t * pxTask = pxNodeParent(pxNode, Task_t, xDelayNode);
+		uiTicks = pxTask->uiDelayTicks;
+	}
+#endif
+	
+#if TINYOS_ENABLE_BUDGET
+	// 暂停或降级的任务在预算补充时恢复，同样不能跳过
+	if(uiBudgetNextTicks() < uiTicks)
+		uiTicks = uiBudgetNextTicks();
+#endif
+	return uiTicks;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskSystemTickSkip
+** Descriptions         :   一次性推进多个节拍，期间不会有任务或定时器到期，由调用者保证
+**                          uiTicks小于uiTaskNextWakeTicks与uiTimerModuleNextExpireTicks的返回值
+** parameters           :   uiTicks 推进的节拍数
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSystemTickSkip (uint32_t uiTicks)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+#if TINYOS_ENABLE_DELAY_WHEEL
+	vWheelSkip(&g_xTaskDelayWheel, uiTicks);
+#else
+	Node_t * pxNode = pxListFirst(&g_xTaskDelayedList);
+	
+	// 差值队列只需要修改首个结点
+	if(pxNode)
+	{
+		Task_t * pxTask = pxNodeParent(pxNode, Task_t, xDelayNode);
+		pxTask->uiDelayTicks -= uiTicks;
+	}
+#endif
+	
+	uiTickCount += uiTicks;
+	vClockTickAdvance(uiTicks);
+	
+	vTimerModuleTickSkip(uiTicks);
+	
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskGetInfo
+** Descriptions         :   获取任务相关信息
+** parameters           :   task 需要查询的任务
+** parameters           :   info 任务信息存储结构
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskGetInfo (Task_t * pxTask, TaskInfo_t * pxInfo)
+{
+   // 进入临界区
+    uint32_t uiStatus = uiTaskEnterCritical();
+
+    pxInfo->uiDelayTicks = prvTaskDelayRemaining(pxTask);       // 剩余的延时
+    pxInfo->uiPrio = pxTask->uiPrio;                            // 任务优先级
+    pxInfo->uiBasePrio = pxTask->uiBasePrio;                    // 不含继承的优先级
+    pxInfo->uiState = pxTask->uiState;                          // 任务状态
+    pxInfo->uiSlice = pxTask->uiSlice;                          // 剩余时间片
+    pxInfo->uiSliceQuantum = pxTask->uiSliceQuantum;            // 时间片长度
+    pxInfo->uiRunTicks = pxTask->uiRunTicks;                    // 已运行的节拍数
+    pxInfo->uiSuspendCount = pxTask->uiSuspendCount;            // 被挂起的次数
+#if TINYOS_ENABLE_EDF
+    pxInfo->uiDeadline = pxTask->uiDeadline;                    // 绝对截止期
+    pxInfo->uiDeadlineMissCnt = pxTask->uiDeadlineMissCnt;      // 错过截止期的次数
+#endif
+#if TINYOS_ENABLE_BUDGET
+    pxInfo->uiBudgetLeft = pxTask->uiBudget ? pxTask->uiBudgetLeft : 0;   // 剩余的CPU预算
+    pxInfo->uiBudgetOverrunCnt = pxTask->uiBudgetOverrunCnt;    // 预算用完的次数
+#endif
+#if TINYOS_ENABLE_ADMISSION
+    pxInfo->uiExecMax = pxTask->uiExecMax;                      // 测得的最长作业执行时间
+    pxInfo->uiResponseTime = pxTask->uiResponseTime;            // 最坏响应时间
+#endif
+#if TINYOS_ENABLE_SMP
+    pxInfo->uiCore = pxTask->uiCore;                            // 所在的核
+    pxInfo->uiMigrateCnt = pxTask->uiMigrateCnt;                // 被迁移的次数
+#endif
+
+	// 堆栈使用量由空闲任务在后台测得，这里只读取缓存的结果
+	pxInfo->uiStackSize = pxTask->uiStackSize;
+	pxInfo->uiStackFree = pxTask->uiStackFreeMin * sizeof(TaskStack_t);
+	
+    // 退出临界区
+    vTaskExitCritical(uiStatus); 
+}
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskSched
+** Descriptions         :   任务调度接口。tinyOS通过它来选择下一个具体的任务，然后切换至该任务运行。
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSched ( void ) 
+{    
+	Task_t * pxTempTask;
+	uint32_t status = uiTaskEnterCritical();
+	
+	if(g_cSchedLockCount[prvThisCore()] > 0)
+	{
+		vTaskExitCritical(status);
+		return;
+	}
+	
+	pxTempTask = pxTaskHightestReady();
+#if TINYOS_ENABLE_ADMISSION
+	// 切换在PendSV中才真正发生，期间可能再次调度，因此与上一次选出的任务比较
+	vAdmissionSwitch(pxTempTask);
+#endif
+	if(pxTempTask != pxCurrentTask)
+	{
+		pxNextTask = pxTempTask;
+		TRACE_TASK_SWITCH(pxNextTask);
+		vTaskSwitch();
+	}
+
+	vTaskExitCritical(status);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiTaskPreempts
+** Descriptions         :   刚就绪的任务是否应当抢占当前任务：优先级更高，或者同在EDF优先级时当前任务在就绪堆中，
+**                          而该任务没有截止期(先于堆中的任务运行)或截止期更早。唤醒任务的各处都按这一规则决定是否调度
+** parameters           :   pxTask 刚就绪的任务，为0表示没有
+** Returned value       :   1表示应当调度，0表示不需要
+***********************************************************************************************************/
+uint32_t uiTaskPreempts (Task_t * pxTask)
+{
+	if(!pxTask)
+		return 0;
+	if(pxTask->uiPrio < pxCurrentTask->uiPrio)
+		return 1;
+#if TINYOS_ENABLE_EDF
+	if(pxTask->uiPrio == pxCurrentTask->uiPrio && prvTaskInEdfHeap(pxCurrentTask))
+		return !prvTaskInEdfHeap(pxTask) || (int32_t)(pxTask->uiDeadline - pxCurrentTask->uiDeadline) < 0;
+#endif
+	return 0;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskYieldFromISRMark
+** Descriptions         :   中断中唤醒任务后调用，被唤醒的任务可能抢占当前任务时记下待调度标志，不立即调度
+** parameters           :   pxTask 被唤醒的任务，为0表示没有唤醒任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskYieldFromISRMark (Task_t * pxTask)
+{
+	if(uiTaskPreempts(pxTask))
+		g_cYieldPending[prvThisCore()] = 1;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTaskYieldFromISR
+** Descriptions         :   中断退出前调用一次，如果中断中的FromISR操作唤醒了更高优先级的任务，则执行一次调度
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskYieldFromISR (void)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	if(g_cYieldPending[prvThisCore()])
+	{
+		g_cYieldPending[prvThisCore()] = 0;
+		vTaskSched();
+	}
+	
+	vTaskExitCritical(uiStatus);
+}
+
+
+/**********************************************************************************************************
+** Function name        :   vTimeTaskWait
+** Descriptions         :   将任务加入延时队列中
+** input parameters     :   task    需要延时的任务
+**                          ticks   延时的ticks
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimeTaskWait (Task_t * pxTask, uint32_t uiTicks)
+{
+#if TINYOS_ENABLE_DELAY_WHEEL
+	vWheelAdd(&g_xTaskDelayWheel, &pxTask->xDelayNode, uiTicks);
+#else
+	int sum = 0, i;
+	Node_t *pxCur = g_xTaskDelayedList.xHeadNode.pxNextNode;
+	
+	for(i = 0; i < g_xTaskDelayedList.uiNodeCnt; i++)
+	{
+		Task_t *pxTemp = pxNodeParent(pxCur, Task_t, xDelayNode);
+		sum += pxTemp->uiDelayTicks;
+
+		if(sum > uiTicks)
+		{
+			pxTask->uiDelayTicks = uiTicks - (sum - pxTemp->uiDelayTicks);
+			vListInsertForward(&g_xTaskDelayedList, pxCur, &pxTask->xDelayNode);
+			break;
+		}
+		pxCur = pxListNext(&g_xTaskDelayedList, pxCur);
+	}
+	if(sum <= uiTicks)           // 如果延时队列中所有节点的时延之和小于等于当前任务，则将任务加入队列末尾
+	{
+		pxTask->uiDelayTicks = uiTicks - sum;
+		vListAddLast(&g_xTaskDelayedList, &pxTask->xDelayNode);
+	}
+	else if(pxTask->uiDelayTicks)  // 否则，任务已经插入到队列中，则将任务后面的第一个节点的时延进行更新
+	{
+		Task_t *pxTemp = pxNodeParent(pxCur, Task_t, xDelayNode);
+		pxTemp->uiDelayTicks -= pxTask->uiDelayTicks;
+	}
+#endif
+    pxTask->uiState |= TINYOS_TASK_STATE_DELAYED;
+}
+
+#if !TINYOS_ENABLE_DELAY_WHEEL
+/**********************************************************************************************************
+** Function name        :   prvTimeTaskUnlink
+** Descriptions         :   从差值队列中取下任务，剩余的差值加到后一个任务上，后面的任务到期时间不变
+** input parameters     :   pxTask  需要取下的任务
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTimeTaskUnlink (Task_t * pxTask)
+{
+	Node_t *pxNext = pxListNext(&g_xTaskDelayedList, &pxTask->xDelayNode);
+	
+	if(pxNext)
+	{
+		Task_t *pxTemp = pxNodeParent(pxNext, Task_t, xDelayNode);
+		pxTemp->uiDelayTicks += pxTask->uiDelayTicks;
+	}
+	vListRemove(&g_xTaskDelayedList, &(pxTask->xDelayNode));
+}
+#endif
+
+/**********************************************************************************************************
+** Function name        :   prvTaskDelayRemaining
+** Descriptions         :   任务的延时还剩多少个节拍
+** input parameters     :   pxTask  任务
+** output parameters    :   无
+** Returned value       :   节拍数，不在延时队列中时返回0
+***********************************************************************************************************/
+static uint32_t prvTaskDelayRemaining (Task_t * pxTask)
+{
+#if TINYOS_ENABLE_DELAY_WHEEL
+	return uiWheelRemaining(&g_xTaskDelayWheel, &pxTask->xDelayNode);
+#else
+	Node_t *pxCur = pxListFirst(&g_xTaskDelayedList);
+	uint32_t uiSum = 0;
+	
+	if(!(pxTask->uiState & TINYOS_TASK_STATE_DELAYED))
+		return 0;
+	
+	// 差值队列中到期时间是前面所有结点的差值之和
+	while(pxCur)
+	{
+		Task_t *pxTemp = pxNodeParent(pxCur, Task_t, xDelayNode);
+		uiSum += pxTemp->uiDelayTicks;
+		if(pxTemp == pxTask)
+			break;
+		pxCur = pxListNext(&g_xTaskDelayedList, pxCur);
+	}
+	return uiSum;
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimeTaskWakeUp
+** Descriptions         :   将延时的任务从延时队列中唤醒
+** input parameters     :   pxTask  需要唤醒的任务
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimeTaskWakeUp (Task_t * pxTask)
+{
+#if TINYOS_ENABLE_DELAY_WHEEL
+	vWheelRemove(&g_xTaskDelayWheel, &pxTask->xDelayNode);
+#else
+	prvTimeTaskUnlink(pxTask);
+#endif
+    pxTask->uiState &= ~TINYOS_TASK_STATE_DELAYED;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimeTaskRemove
+** Descriptions         :   将延时的任务从延时队列中移除
+** input parameters     :   task  需要移除的任务
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimeTaskRemove (Task_t * pxTask)
+{
+#if TINYOS_ENABLE_DELAY_WHEEL
+	vWheelRemove(&g_xTaskDelayWheel, &pxTask->xDelayNode);
+#else
+	prvTimeTaskUnlink(pxTask);
+#endif
+    pxTask->uiState &= ~TINYOS_TASK_STATE_DELAYED;
+}
+
+
+
+
@@ -1,262 +1,471 @@
-#ifndef _TTASK_H
-#define _TTASK_H
-
-#include <stdint.h>
-#include "tLib.h"
-
-#define TINYOS_TASK_STATE_RDY                   0
-#define TINYOS_TASK_STATE_DESTROYED             (1 << 0)
-#define TINYOS_TASK_STATE_DELAYED               (1 << 1)
-#define TINYOS_TASK_STATE_SUSPEND               (1 << 2)
-
-#define TINYOS_TASK_WAIT_MASK                   (0xFF << 16)
-
-typedef uint32_t TaskStack_t;
-
-typedef struct {
-	TaskStack_t *pxStack;
-	uint32_t * puiStackBase;
-	uint32_t uiStackSize;
-	uint32_t uiDelayTicks;
-	uint32_t uiPrio;
-	Node_t xDelayNode;
-	Node_t xLinkNode;
-	Node_t xEventNode;
-	uint32_t uiSlice;
-	uint32_t uiState;
-	uint32_t uiSuspendCount;
-	uint8_t cRequsetDeleteFlag;
-	void (*vCleanResource) (void *param);
-	void * pvCleanParam;
-	
-    // 任务正在等待的事件类型
-    struct _Event * pxWaitEvent;
-
-    // 等待事件的消息存储位置
-    void * pvEventMsg;
-
-    // 等待事件的结果
-    uint32_t uiWaitEventResult;	
-	
-    // 等待的事件检查类型（复位，置位，全部满足，部分满足）
-    uint32_t uiWaitFlagsCheckType;
-
-    // 等待的事件标志
-    uint32_t uiWaitEventFlags;
-}Task_t;
-
-typedef struct {
-	uint32_t uiDelayTicks;
-	uint32_t uiPrio;
-	uint32_t uiState;
-	uint32_t uiSlice;
-	uint32_t uiSuspendCount;
-	
-	uint32_t uiStackSize;
-	uint32_t uiStackFree;
-}TaskInfo_t;
-
-
-typedef void (*TaskFunction_pt)(void *);
-
-// 当前任务：记录当前是哪个任务正在运行
-extern Task_t * pxCurrentTask;
-
-// 下一个即将运行的任务：在任务切换之前，需要先设置好该值
-extern Task_t * pxNextTask;
-
-/**********************************************************************************************************
-** Function name        :   vTaskInit
-** Descriptions         :   初始化任务
-** parameters           :   pxTask           要初始化的任务结构
-** parameters           :   pxTaskCode       任务的入口函数
-** parameters           :   uiPrio           传递给任务的运行参数
-** parameters           :   prio             任务的优先级
-** parameters           :   pxStack          任务堆栈的起始地址（低地址）
-** parameters           :   uiStackSize      任务堆栈大小
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskInit(Task_t * pxTask, TaskFunction_pt pxTaskCode, void *pvParam, uint32_t uiPrio, TaskStack_t * pxStack, uint32_t uiStackSize);
-
-/**********************************************************************************************************
-** Function name        :   vTaskStartScheduler
-** Descriptions         :   在启动tinyOS时，调用该函数，将切换至第一个任务运行
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskStartScheduler(void);
-
-/**********************************************************************************************************
-** Function name        :   vTaskDelayedInit
-** Descriptions         :   初始化任务延时机制
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskDelayedInit (void);
-
-/**********************************************************************************************************
-** Function name        :   vTimeTickInit
-** Descriptions         :   初始化时钟节拍计数
-** input parameters     :   无
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimeTickInit(void);
-
-/**********************************************************************************************************
-** Function name        :   vTaskDelay
-** Descriptions         :   使当前任务进入延时状态。
-** parameters           :   delay 延时多少个ticks
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskDelay(uint32_t uiDelay);
-
-
-/**********************************************************************************************************
-** Function name        :   uiTaskEnterCritical
-** Descriptions         :   进入临界区
-** parameters           :   无
-** Returned value       :   进入临界区之前的中断状态值
-***********************************************************************************************************/
-uint32_t uiTaskEnterCritical (void);
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskExitCritical
-** Descriptions         :   退出临界区
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskExitCritical (uint32_t uiStatus);
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskSchedInit
-** Descriptions         :   初始化调度器
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSchedInit (void);
-
-/**********************************************************************************************************
-** Function name        :   vTaskSchedEnable
-** Descriptions         :   使能任务调度
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSchedEnable(void);
-
-/**********************************************************************************************************
-** Function name        :   vTaskSchedDisable
-** Descriptions         :   禁止任务调度
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSchedDisable(void);
-
-/**********************************************************************************************************
-** Function name        :   vTaskSchedRdy
-** Descriptions         :   将任务设置为就绪状态
-** input parameters     :   task    等待设置为就绪状态的任务
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSchedRdy (Task_t * pxTask);
-
-/************************************************************************************************************
-** Descriptions         :   vTaskSchedUnRdy
-** Descriptions         :   将任务从就绪列表中移除
-** input parameters     :   task    等待从就绪列表中移除的任务
-** output parameters    :   None
-** Returned value       :   None
-***********************************************************************************************************/
-void vTaskSchedUnRdy (Task_t * pxTask);
-
-/**********************************************************************************************************
-** Function name        :   vTaskSwitch
-** Descriptions         :   进行一次任务切换，tinyOS会预先配置好currentTask和nextTask, 然后调用该函数，切换至
-**                          nextTask运行
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSwitch(void);
-
-/**********************************************************************************************************
-** Function name        :   tTaskSuspend
-** Descriptions         :   挂起指定的任务
-** parameters           :   task        待挂起的任务
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSuspend(Task_t * pxTask);
-
-/**********************************************************************************************************
-** Function name        :   vTaskWakeUp
-** Descriptions         :   唤醒被挂起的任务
-** parameters           :   task        待唤醒的任务
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskWakeUp (Task_t * pxTask);
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskSetNext
-** Descriptions         :   设置下一个任务
-** parameters           :   pxTask 
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSetNext(Task_t *pxTask);
-
-/**********************************************************************************************************
-** Function name        :   pxTaskHightestReady
-** Descriptions         :   获取优先级最高的任务
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-Task_t * pxTaskHightestReady (void);
-
-/************************************************************************************************************
-** Descriptions         :   vTaskSchedUnRdy
-** Descriptions         :   将任务从就绪列表中移除
-** input parameters     :   task    等待从就绪列表中移除的任务
-** output parameters    :   None
-** Returned value       :   None
-***********************************************************************************************************/
-void vTaskSchedRemove (Task_t * pxTask);
-
-/**********************************************************************************************************
-** Function name        :   vTaskSched
-** Descriptions         :   任务调度接口。tinyOS通过它来选择下一个具体的任务，然后切换至该任务运行。
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSched ( void );
-
-/**********************************************************************************************************
-** Function name        :   vTimeTaskWait
-** Descriptions         :   将任务加入延时队列中
-** input parameters     :   task    需要延时的任务
-**                          ticks   延时的ticks
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimeTaskWait (Task_t * pxTask, uint32_t uiTicks);
-
-/**********************************************************************************************************
-** Function name        :   vTimeTaskWakeUp
-** Descriptions         :   将延时的任务从延时队列中唤醒
-** input parameters     :   pxTask  需要唤醒的任务
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimeTaskWakeUp (Task_t * pxTask);
-
-/**********************************************************************************************************
-** Function name        :   vTimeTaskRemove
-** Descriptions         :   将延时的任务从延时队列中移除
-** input parameters     :   task  需要移除的任务
-** output parameters    :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimeTaskRemove (Task_t * pxTask);
-
-#endif
+#ifndef _TTASK_H
+#define _TTASK_H
+
+#include <stdint.h>
+#include "tLib.h"
+#include "tWheel.h"
+
+#define TINYOS_TASK_STATE_RDY                   0
+#define TINYOS_TASK_STATE_DESTROYED             (1 << 0)
+#define TINYOS_TASK_STATE_DELAYED               (1 << 1)
+#define TINYOS_TASK_STATE_SUSPEND               (1 << 2)
+#define TINYOS_TASK_STATE_THROTTLED             (1 << 3)              // CPU预算用完，暂停运行直到预算补充
+
+#define TINYOS_TASK_WAIT_MASK                   (0xFF << 16)
+
+#define TINYOS_TICKS_NONE                       0xFFFFFFFF              // 没有到期的任务或定时器
+
+#define TINYOS_CORE_ANY                         0xFFFFFFFF              // 任务不绑定核，可由负载均衡迁移
+
+typedef uint32_t TaskStack_t;
+
+typedef struct {
+	TaskStack_t *pxStack;
+	uint32_t * puiStackBase;
+	uint32_t uiStackSize;
+	uint32_t uiPrio;
+	uint32_t uiBasePrio;               // 不含互斥量继承与天花板提升的优先级
+#if TINYOS_ENABLE_DELAY_WHEEL
+	WheelNode_t xDelayNode;            // 延时或超时等待时在时间轮中的结点
+#else
+	uint32_t uiDelayTicks;             // 延时队列中与前一个任务到期时间的差值
+	Node_t xDelayNode;
+#endif
+	Node_t xLinkNode;
+	Node_t xEventNode;
+	Node_t * pxEventRunPeer;           // 按优先级排列的等待队列中，同优先级一段的首尾结点互相指向对方
+	uint32_t uiSlice;                  // 剩余的时间片
+	uint32_t uiSliceQuantum;           // 时间片长度，为0表示不参与时间片轮转
+	uint32_t uiRunTicks;               // 运行的节拍数
+	uint32_t uiState;
+	uint32_t uiSuspendCount;
+	uint8_t cRequsetDeleteFlag;
+	void (*vCleanResource) (void *param);
+	void * pvCleanParam;
+	
+    // 任务正在等待的事件类型
+    struct _Event * pxWaitEvent;
+
+    // 等待事件的消息存储位置
+    void * pvEventMsg;
+
+    // 等待事件的结果
+    uint32_t uiWaitEventResult;	
+	
+    // 等待的事件检查类型（复位，置位，全部满足，部分满足）
+    uint32_t uiWaitFlagsCheckType;
+
+    // 等待的事件标志
+    uint32_t uiWaitEventFlags;
+
+    // 持有的互斥量，释放时据此重新计算继承的优先级
+    List_t xMutexHeldList;
+
+#if TINYOS_ENABLE_EDF
+	uint32_t uiDeadline;               // 绝对截止期(节拍)
+	uint32_t uiRelDeadline;            // 相对截止期，为0表示不属于EDF调度类
+	uint32_t uiPeriod;                 // 周期，为0表示非周期任务
+	uint32_t uiRelease;                // 本周期的开始时刻
+	uint32_t uiEdfIndex;               // 在EDF就绪堆中的位置
+	uint32_t uiDeadlineMissCnt;        // 错过截止期的次数
+#endif
+
+#if TINYOS_ENABLE_BUDGET
+	uint32_t uiBudget;                 // 每个周期的CPU预算(节拍)，为0表示不限制
+	uint32_t uiBudgetPeriod;           // 预算的补充周期
+	uint32_t uiBudgetLeft;             // 剩余的预算
+	uint32_t uiBudgetPrio;             // 预算用完后降到的优先级，或TINYOS_BUDGET_THROTTLE
+	uint32_t uiBudgetNormalPrio;       // 预算用完前的优先级
+	uint32_t uiBudgetOverrunCnt;       // 预算用完的次数
+	uint32_t uiBudgetLastTick;         // 上一次扣除预算的节拍
+	uint32_t uiBudgetReplTime[TINYOS_BUDGET_REPL_MAX];    // 等待中的补充时刻
+	uint32_t uiBudgetReplAmount[TINYOS_BUDGET_REPL_MAX];  // 等待中的补充数量
+	uint8_t cBudgetReplHead;           // 最早一项补充的位置
+	uint8_t cBudgetReplCnt;            // 等待中的补充项数
+	Node_t xBudgetNode;                // 等待预算补充的链表结点
+#endif
+
+#if TINYOS_ENABLE_ADMISSION
+	uint32_t uiAdmissionPeriod;        // 声明的周期(节拍)，为0表示没有声明
+	uint32_t uiAdmissionDeadline;      // 声明的相对截止期(节拍)
+	uint32_t uiAdmissionWcet;          // 声明的最坏执行时间(微秒)
+	uint32_t uiAdmissionPrio;          // 声明时的优先级，不受优先级继承与预算降级影响
+	uint32_t uiExecMax;                // 测得的最长作业执行时间(微秒)
+	uint64_t ullExecJob;               // 本次作业已经执行的时间(时间戳计数)
+	uint32_t uiResponseTime;           // 最近一次分析得到的最坏响应时间(微秒)
+	Node_t xAdmissionNode;             // 声明过的任务链表结点
+#endif
+
+#if TINYOS_ENABLE_SMP
+	uint32_t uiCore;                   // 所在就绪表的核，任务运行期间不变
+	uint32_t uiAffinity;               // 绑定的核，TINYOS_CORE_ANY表示不绑定
+	uint32_t uiMigrateCnt;             // 被负载均衡迁移的次数
+#endif
+
+	uint32_t uiStackFreeMin;           // 空闲任务测得的堆栈最少剩余字数
+	uint32_t uiStackScan;              // 本轮检查已经到达的位置(字)
+	Node_t xStackNode;                 // 等待空闲任务检查堆栈的链表结点
+#if TINYOS_STACK_LAZY_FILL
+	uint32_t uiStackFilled;            // 从堆栈底部开始已经清零的字数
+	uint8_t cStackFilling;             // 堆栈还没有清零完成
+#endif
+}Task_t;
+
+typedef struct {
+	uint32_t uiDelayTicks;
+	uint32_t uiPrio;
+	uint32_t uiBasePrio;
+	uint32_t uiState;
+	uint32_t uiSlice;
+	uint32_t uiSliceQuantum;
+	uint32_t uiRunTicks;
+	uint32_t uiSuspendCount;
+	
+	uint32_t uiStackSize;
+	uint32_t uiStackFree;
+
+#if TINYOS_ENABLE_EDF
+	uint32_t uiDeadline;
+	uint32_t uiDeadlineMissCnt;
+#endif
+
+#if TINYOS_ENABLE_BUDGET
+	uint32_t uiBudgetLeft;
+	uint32_t uiBudgetOverrunCnt;
+#endif
+
+#if TINYOS_ENABLE_ADMISSION
+	uint32_t uiExecMax;
+	uint32_t uiResponseTime;
+#endif
+
+#if TINYOS_ENABLE_SMP
+	uint32_t uiCore;
+	uint32_t uiMigrateCnt;
+#endif
+}TaskInfo_t;
+
+
+typedef void (*TaskFunction_pt)(void *);
+
+#if TINYOS_ENABLE_SMP
+/**********************************************************************************************************
+** Function name        :   uiPortCoreId
+** Descriptions         :   由移植层实现，返回当前运行代码所在的核
+** parameters           :   无
+** Returned value       :   核的序号，从0开始
+***********************************************************************************************************/
+uint32_t uiPortCoreId (void);
+
+/**********************************************************************************************************
+** Function name        :   uiPortCoreCount
+** Descriptions         :   由移植层实现，返回实际运行的核数，不超过TINYOS_CORE_COUNT
+** parameters           :   无
+** Returned value       :   核数
+***********************************************************************************************************/
+uint32_t uiPortCoreCount (void);
+
+/**********************************************************************************************************
+** Function name        :   vPortCoreSignal
+** Descriptions         :   由移植层实现，向指定的核发送核间中断，使其重新调度
+** parameters           :   uiCore 目标核
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortCoreSignal (uint32_t uiCore);
+
+// 每个核各自的当前任务与下一个任务，pxCurrentTask/pxNextTask总是指本核的
+extern Task_t * g_pxCurrentTask[TINYOS_CORE_COUNT];
+extern Task_t * g_pxNextTask[TINYOS_CORE_COUNT];
+#define pxCurrentTask                   (g_pxCurrentTask[uiPortCoreId()])
+#define pxNextTask                      (g_pxNextTask[uiPortCoreId()])
+#else
+// 当前任务：记录当前是哪个任务正在运行
+extern Task_t * pxCurrentTask;
+
+// 下一个即将运行的任务：在任务切换之前，需要先设置好该值
+extern Task_t * pxNextTask;
+#endif
+
+/**********************************************************************************************************
+** Function name        :   vTaskInit
+** Descriptions         :   初始化任务
+** parameters           :   pxTask           要初始化的任务结构
+** parameters           :   pxTaskCode       任务的入口函数
+** parameters           :   uiPrio           传递给任务的运行参数
+** parameters           :   prio             任务的优先级
+** parameters           :   pxStack          任务堆栈的起始地址（低地址）
+** parameters           :   uiStackSize      任务堆栈大小
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskInit(Task_t * pxTask, TaskFunction_pt pxTaskCode, void *pvParam, uint32_t uiPrio, TaskStack_t * pxStack, uint32_t uiStackSize);
+
+/**********************************************************************************************************
+** Function name        :   vTaskStartScheduler
+** Descriptions         :   在启动tinyOS时，调用该函数，将切换至第一个任务运行
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskStartScheduler(void);
+
+/**********************************************************************************************************
+** Function name        :   vTaskDelayedInit
+** Descriptions         :   初始化任务延时机制
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskDelayedInit (void);
+
+/**********************************************************************************************************
+** Function name        :   vTimeTickInit
+** Descriptions         :   初始化时钟节拍计数
+** input parameters     :   无
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimeTickInit(void);
+
+/**********************************************************************************************************
+** Function name        :   vTaskDelay
+** Descriptions         :   使当前任务进入延时状态。
+** parameters           :   delay 延时多少个ticks
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskDelay(uint32_t uiDelay);
+
+
+/**********************************************************************************************************
+** Function name        :   uiTaskEnterCritical
+** Descriptions         :   进入临界区
+** parameters           :   无
+** Returned value       :   进入临界区之前的中断状态值
+***********************************************************************************************************/
+uint32_t uiTaskEnterCritical (void);
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskExitCritical
+** Descriptions         :   退出临界区
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskExitCritical (uint32_t uiStatus);
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskSchedInit
+** Descriptions         :   初始化调度器
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSchedInit (void);
+
+/**********************************************************************************************************
+** Function name        :   vTaskSchedEnable
+** Descriptions         :   使能任务调度
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSchedEnable(void);
+
+/**********************************************************************************************************
+** Function name        :   vTaskSchedDisable
+** Descriptions         :   禁止任务调度
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSchedDisable(void);
+
+/**********************************************************************************************************
+** Function name        :   vTaskSchedRdy
+** Descriptions         :   将任务设置为就绪状态
+** input parameters     :   task    等待设置为就绪状态的任务
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSchedRdy (Task_t * pxTask);
+
+/************************************************************************************************************
+** Descriptions         :   vTaskSchedUnRdy
+** Descriptions         :   将任务从就绪列表中移除
+** input parameters     :   task    等待从就绪列表中移除的任务
+** output parameters    :   None
+** Returned value       :   None
+***********************************************************************************************************/
+void vTaskSchedUnRdy (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vTaskSwitch
+** Descriptions         :   进行一次任务切换，tinyOS会预先配置好currentTask和nextTask, 然后调用该函数，切换至
+**                          nextTask运行
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSwitch(void);
+
+/**********************************************************************************************************
+** Function name        :   pxTaskStackInit
+** Descriptions         :   在任务堆栈中构造初始运行现场，由移植层(switch.c/tPortLinux.c)实现
+** parameters           :   puiStackBase     任务堆栈的起始地址（低地址）
+** parameters           :   uiStackSize      任务堆栈大小（字节）
+** parameters           :   pxTaskCode       任务的入口函数
+** parameters           :   pvParam          传递给任务的运行参数
+** Returned value       :   任务初始的栈顶，保存在Task_t的pxStack中
+***********************************************************************************************************/
+TaskStack_t * pxTaskStackInit(TaskStack_t * puiStackBase, uint32_t uiStackSize, TaskFunction_pt pxTaskCode, void * pvParam);
+
+/**********************************************************************************************************
+** Function name        :   tTaskSuspend
+** Descriptions         :   挂起指定的任务
+** parameters           :   task        待挂起的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSuspend(Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vTaskWakeUp
+** Descriptions         :   唤醒被挂起的任务
+** parameters           :   task        待唤醒的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskWakeUp (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vTaskYield
+** Descriptions         :   当前任务主动让出CPU，切换到同优先级的下一个就绪任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskYield (void);
+
+/**********************************************************************************************************
+** Function name        :   vTaskSetSlice
+** Descriptions         :   设置任务的时间片长度，任务创建时为TINYOS_SLICE_MAX
+** parameters           :   pxTask 任务
+** parameters           :   uiSliceQuantum 时间片长度(节拍数)，为0表示不参与时间片轮转
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSetSlice (Task_t * pxTask, uint32_t uiSliceQuantum);
+
+/**********************************************************************************************************
+** Function name        :   vTaskStackMonitorStep
+** Descriptions         :   由空闲任务调用，为新创建的任务清零一段堆栈，或者检查一段任务堆栈的使用量
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskStackMonitorStep (void);
+
+#if TINYOS_ENABLE_SMP
+/**********************************************************************************************************
+** Function name        :   vTaskSetAffinity
+** Descriptions         :   将任务绑定到指定的核，绑定后不参与负载均衡。正在其它核上运行的任务在下次就绪时迁移
+** parameters           :   pxTask 任务
+** parameters           :   uiCore 核的序号，TINYOS_CORE_ANY表示取消绑定
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSetAffinity (Task_t * pxTask, uint32_t uiCore);
+#endif
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskSetNext
+** Descriptions         :   设置下一个任务
+** parameters           :   pxTask 
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSetNext(Task_t *pxTask);
+
+/**********************************************************************************************************
+** Function name        :   pxTaskHightestReady
+** Descriptions         :   获取优先级最高的任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+Task_t * pxTaskHightestReady (void);
+
+/************************************************************************************************************
+** Descriptions         :   vTaskSchedUnRdy
+** Descriptions         :   将任务从就绪列表中移除
+** input parameters     :   task    等待从就绪列表中移除的任务
+** output parameters    :   None
+** Returned value       :   None
+***********************************************************************************************************/
+void vTaskSchedRemove (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vTaskSched
+** Descriptions         :   任务调度接口。tinyOS通过它来选择下一个具体的任务，然后切换至该任务运行。
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSched ( void );
+
+/**********************************************************************************************************
+** Function name        :   uiTaskPreempts
+** Descriptions         :   刚就绪的任务是否应当抢占当前任务：优先级更高，或者同在EDF优先级时当前任务在就绪堆中，
+**                          而该任务没有截止期(先于堆中的任务运行)或截止期更早。唤醒任务的各处都按这一规则决定是否调度
+** parameters           :   pxTask 刚就绪的任务，为0表示没有
+** Returned value       :   1表示应当调度，0表示不需要
+***********************************************************************************************************/
+uint32_t uiTaskPreempts (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vTaskYieldFromISRMark
+** Descriptions         :   中断中唤醒任务后调用，被唤醒的任务可能抢占当前任务时记下待调度标志，不立即调度
+** parameters           :   pxTask 被唤醒的任务，为0表示没有唤醒任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskYieldFromISRMark (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vTaskYieldFromISR
+** Descriptions         :   中断退出前调用一次，如果中断中的FromISR操作唤醒了更高优先级的任务，则执行一次调度
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskYieldFromISR (void);
+
+/**********************************************************************************************************
+** Function name        :   uiTaskNextWakeTicks
+** Descriptions         :   查询距离延时队列中最早的任务到期还有多少个节拍
+** parameters           :   无
+** Returned value       :   节拍数，延时队列为空时返回TINYOS_TICKS_NONE
+***********************************************************************************************************/
+uint32_t uiTaskNextWakeTicks (void);
+
+/**********************************************************************************************************
+** Function name        :   vTaskSystemTickSkip
+** Descriptions         :   一次性推进多个节拍，期间不会有任务或定时器到期，由调用者保证
+** parameters           :   uiTicks 推进的节拍数
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSystemTickSkip (uint32_t uiTicks);
+
+/**********************************************************************************************************
+** Function name        :   vTimeTaskWait
+** Descriptions         :   将任务加入延时队列中
+** input parameters     :   task    需要延时的任务
+**                          ticks   延时的ticks
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimeTaskWait (Task_t * pxTask, uint32_t uiTicks);
+
+/**********************************************************************************************************
+** Function name        :   vTimeTaskWakeUp
+** Descriptions         :   将延时的任务从延时队列中唤醒
+** input parameters     :   pxTask  需要唤醒的任务
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimeTaskWakeUp (Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   vTimeTaskRemove
+** Descriptions         :   将延时的任务从延时队列中移除
+** input parameters     :   task  需要移除的任务
+** output parameters    :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimeTaskRemove (Task_t * pxTask);
+
+#endif
@@ -1,258 +1,415 @@
-#include "tinyOS.h"
-
-// "硬"定时器列表
-static List_t xTimerHardList;
-
-// "软"定时器列表
-static List_t xTimerSoftList;
-
-// 用于访问软定时器列表的信号量
-static Sem_t xTimerProtectSem;
-
-// 用于软定时器任务与中断同步的计数信号量
-static Sem_t xTimerTickSem;
-
-static Task_t xTimeTask;
-static TaskStack_t xTimerTaskStack[TINYOS_STACK_SIZE];
-
-
-static void prvTimerSoftTask(void * pvParam);
-static void prvTimerCallFuncList (List_t * pxTimerList);
-
-/**********************************************************************************************************
-** Function name        :   vTimerInit
-** Descriptions         :   初始化定时器
-** parameters           :   pxTimer 等待初始化的定时器
-** parameters           :   uiDelayTicks 定时器初始启动的延时ticks数。
-** parameters           :   uiDurationTicks 给周期性定时器用的周期tick数，一次性定时器无效
-** parameters           :   pxTimerFunc 定时器回调函数
-** parameters           :   pvArg 传递给定时器回调函数的参数
-** parameters           :   uiConfig 定时器的初始配置
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimerInit (Timer_t * pxTimer, uint32_t uiDelayTicks, uint32_t uiDurationTicks,
-                 void (*pxTimerFunc) (void * arg), void * pvArg, uint32_t uiConfig)
-{
-	vNodeInit(&pxTimer->xLinkNode);
-	pxTimer->uiStartDelayTicks = uiDelayTicks;
-	pxTimer->uiDurationTicks = uiDurationTicks;
-	pxTimer->pvTimerFunc = pxTimerFunc;
-	pxTimer->pvArg = pvArg;
-	pxTimer->uiConfig = uiConfig;
-	
-	if(uiDelayTicks)
-	{
-		pxTimer->uiDelayTicks = pxTimer->uiStartDelayTicks;
-	}
-	else
-	{
-		pxTimer->uiDelayTicks = uiDurationTicks;
-	}
-	pxTimer->eState = eTimerCreated;
-}
-
-/**********************************************************************************************************
-** Function name        :   vTimerStart
-** Descriptions         :   启动定时器
-** parameters           :   pxTimer 等待启动的定时器
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimerStart (Timer_t * pxTimer)
-{
-	switch(pxTimer->eState)
-	{
-		case eTimerCreated:
-		case eTimerStopped:
-			pxTimer->uiDelayTicks = pxTimer->uiStartDelayTicks ? pxTimer->uiStartDelayTicks : pxTimer->uiDurationTicks;
-			pxTimer->eState = eTimerStarted;
-			
-			// 根据定时器类型加入相应的定时器列表
-			if(pxTimer->uiConfig & TIMER_CONFIG_TYPE_HARD)
-			{
-				// 硬定时器，在时钟节拍中断中处理，所以使用critical来防护
-				uint32_t uiStatus = uiTaskEnterCritical();
-				// 加入硬定时器列表
-				vListAddLast(&xTimerHardList, &pxTimer->xLinkNode);
-				vTaskExitCritical(uiStatus);
-			}
-			else
-			{
-				// 软定时器，先获取信号量。以处理此时定时器任务此时同时在访问软定时器列表导致的冲突问题
-				uiSemWait(&xTimerProtectSem, 0);
-				vListAddLast(&xTimerSoftList, &pxTimer->xLinkNode);
-				vSemNotify(&xTimerProtectSem);
-			}
-			break;
-		default:
-			break;
-	}
-}
-
-/**********************************************************************************************************
-** Function name        :   vTimerStop
-** Descriptions         :   终止定时器
-** parameters           :   pxTimer 等待启动的定时器
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimerStop (Timer_t * pxTimer)
-{
-	switch(pxTimer->eState)
-	{
-		case eTimerStarted:
-		case eTimerRunning:
-			// 如果已经启动，判断定时器类型，然后从相应的延时列表中移除
-			if(pxTimer->uiConfig & TIMER_CONFIG_TYPE_HARD)
-			{
-				// 硬定时器，在时钟节拍中断中处理，所以使用critical来防护
-				uint32_t uiStatus = uiTaskEnterCritical();
-				vListRemove(&xTimerHardList, &pxTimer->xLinkNode);
-				vTaskExitCritical(uiStatus);
-			}
-			else
-			{
-				// 软定时器，先获取信号量。以处理此时定时器任务此时同时在访问软定时器列表导致的冲突问题
-				uiSemWait(&xTimerProtectSem, 0);
-				vListRemove(&xTimerSoftList, &pxTimer->xLinkNode);
-				vSemNotify(&xTimerProtectSem);
-			}
-			pxTimer->eState = eTimerStopped;
-			break;
-		default:
-			break;
-	}
-}
-
-/**********************************************************************************************************
-** Function name        :   vTimerModuleTickNotify
-** Descriptions         :   通知定时模块，系统节拍tick增加
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimerModuleTickNotify (void)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	// 处理硬定时器列表
-	prvTimerCallFuncList(&xTimerHardList);
-	vTaskExitCritical(uiStatus);
-	
-	vSemNotify(&xTimerTickSem);
-}
-
-/**********************************************************************************************************
-** Function name        :   vTimerModuleInit
-** Descriptions         :   定时器模块初始化
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimerModuleInit (void)
-{
-	vListInit(&xTimerHardList);
-	vListInit(&xTimerSoftList);
-	vSemInit(&xTimerProtectSem, 1, 1);
-	vSemInit(&xTimerTickSem, 0, 0);
-}
-
-/**********************************************************************************************************
-** Function name        :   vTimerInitTask
-** Descriptions         :   初始化软定时器任务
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimerInitTask(void)
-{
-#if TINYOS_TIMERTASK_PRIO >= (TINYOS_PRO_COUNT - 1)
-    #error "The proprity of timer task must be greater then (TINYOS_PRO_COUNT - 1)"
-#endif
-    vTaskInit(&xTimeTask, prvTimerSoftTask, (void *)0,
-        TINYOS_TIMERTASK_PRIO, xTimerTaskStack, sizeof(xTimerTaskStack));
-}
-
-/**********************************************************************************************************
-** Function name        :   vTimerDestroy
-** Descriptions         :   销毁定时器
-** parameters           :   pxTimer 销毁的定时器
-** Returned value       :   无
-***********************************************************************************************************/
-void vTimerDestroy (Timer_t * pxTimer)
-{
-	vTimerStop(pxTimer);
-	pxTimer->eState = eTimerDestroyed;
-}
-
-/**********************************************************************************************************
-** Function name        :   tTimerGetInfo
-** Descriptions         :   查询状态信息
-** parameters           :   pxTimer 查询的定时器
-** parameters           :   pxInfo 状态查询存储的位置
-** Returned value       :   无
-***********************************************************************************************************/
-void tTimerGetInfo (Timer_t * pxTimer, TimerInfo_t * pxInfo)
-{
-	uint32_t uiStatus = uiTaskEnterCritical();
-	pxInfo->uiStartDelayTicks = pxTimer->uiStartDelayTicks;
-	pxInfo->uiDurationTicks   = pxTimer->uiDurationTicks;
-	pxInfo->pvTimerFunc       = pxTimer->pvTimerFunc;
-	pxInfo->pvArg             = pxTimer->pvArg;
-	pxInfo->uiConfig          = pxTimer->uiConfig;
-	pxInfo->eSstate           = pxTimer->eState;
-	vTaskExitCritical(uiStatus);
-}
-
-
-
-/**********************************************************************************************************
-** Function name        :   prvTimerSoftTask
-** Descriptions         :   处理软定时器列表的任务
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-static void prvTimerSoftTask(void * pvParam)
-{
-	for(;;)
-	{
-        // 等待系统节拍发送的中断事件信号
-        uiSemWait(&xTimerTickSem, 0);
-
-        // 获取软定时器列表的访问权限
-        uiSemWait(&xTimerProtectSem, 0);
-
-        // 处理软定时器列表
-        prvTimerCallFuncList(&xTimerSoftList);
-
-        // 释放定时器列表访问权限
-        vSemNotify(&xTimerProtectSem);
-	}
-}
-
-/**********************************************************************************************************
-** Function name        :   prvTimerCallFuncList
-** Descriptions         :   遍历指定的定时器列表，调用各个定时器处理函数
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-static void prvTimerCallFuncList (List_t * pxTimerList)
-{
-	Node_t * pxNode = pxListFirst(pxTimerList);
-	
-	while(pxNode)
-	{
-		Timer_t * pxTimer = pxNodeParent(pxNode, Timer_t, xLinkNode);
-		
-		// 如果延时已到，则调用定时器处理函数
-		if((!pxTimer->uiDelayTicks) || (--pxTimer->uiDelayTicks == 0))
-		{
-			pxTimer->eState = eTimerRunning;
-			pxTimer->pvTimerFunc(pxTimer->pvArg);
-			pxTimer->eState = eTimerStarted;
-			
-			if(pxTimer->uiDurationTicks > 0)
-				pxTimer->uiDelayTicks = pxTimer->uiDurationTicks;
-			else
-			{
-				vListRemove(pxTimerList, &pxTimer->xLinkNode);
-				pxTimer->eState = eTimerStopped;
-			}
-		}
-		pxNode = pxListNext(pxTimerList, pxNode);
-	}
-}
+#include "tinyOS.h"
+
+// "硬"定时器时间轮，在节拍中断中推进
+static Wheel_t xTimerHardWheel;
+
+// "软"定时器时间轮，在定时器任务中推进
+static Wheel_t xTimerSoftWheel;
+
+// 用于访问软定时器时间轮的信号量
+static Sem_t xTimerProtectSem;
+
+// 软定时器需要处理时，节拍中断用于唤醒定时器任务的信号量
+static Sem_t xTimerTickSem;
+
+// 已经过、软定时器时间轮还没有推进的节拍数。时间轮为空并且定时器任务不在处理时，节拍直接并入时间轮，不积累
+static uint32_t uiTimerSoftPending;
+
+// 定时器任务取走积累的节拍后正在推进软定时器时间轮，期间到期的定时器不在时间轮中，节拍必须积累
+static uint8_t cTimerSoftBusy;
+
+// 软定时器时间轮下一个需要处理的节拍，从时间轮的当前节拍算起。积累的节拍数达到它时唤醒定时器任务，
+// 唤醒后到定时器任务处理完之前为TINYOS_TICKS_NONE
+static uint32_t uiTimerSoftWake;
+
+static Task_t xTimeTask;
+static TaskStack_t xTimerTaskStack[TINYOS_STACK_SIZE];
+
+
+static void prvTimerSoftTask(void * pvParam);
+static void prvTimerWheelTick (Wheel_t * pxWheel);
+static void prvTimerSoftRearm (void);
+static void prvTimerSoftFold (void);
+
+/**********************************************************************************************************
+** Function name        :   vTimerInit
+** Descriptions         :   初始化定时器
+** parameters           :   pxTimer 等待初始化的定时器
+** parameters           :   uiDelayTicks 定时器初始启动的延时ticks数。
+** parameters           :   uiDurationTicks 给周期性定时器用的周期tick数，一次性定时器无效
+** parameters           :   pxTimerFunc 定时器回调函数
+** parameters           :   pvArg 传递给定时器回调函数的参数
+** parameters           :   uiConfig 定时器的初始配置
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimerInit (Timer_t * pxTimer, uint32_t uiDelayTicks, uint32_t uiDurationTicks,
+                 void (*pxTimerFunc) (void * arg), void * pvArg, uint32_t uiConfig)
+{
+	vWheelNodeInit(&pxTimer->xLinkNode);
+	pxTimer->uiStartDelayTicks = uiDelayTicks;
+	pxTimer->uiDurationTicks = uiDurationTicks;
+	pxTimer->pvTimerFunc = pxTimerFunc;
+	pxTimer->pvArg = pvArg;
+	pxTimer->uiConfig = uiConfig;
+	pxTimer->eState = eTimerCreated;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimerStart
+** Descriptions         :   启动定时器
+** parameters           :   pxTimer 等待启动的定时器
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimerStart (Timer_t * pxTimer)
+{
+	uint32_t uiTicks = pxTimer->uiStartDelayTicks ? pxTimer->uiStartDelayTicks : pxTimer->uiDurationTicks;
+
+	switch(pxTimer->eState)
+	{
+		case eTimerCreated:
+		case eTimerStopped:
+			// 根据定时器类型加入相应的时间轮，延时为0的定时器在下一个节拍到期
+			if(pxTimer->uiConfig & TIMER_CONFIG_TYPE_HARD)
+			{
+				// 硬定时器，在时钟节拍中断中处理，所以使用critical来防护
+				uint32_t uiStatus = uiTaskEnterCritical();
+				pxTimer->eState = eTimerStarted;
+				vWheelAdd(&xTimerHardWheel, &pxTimer->xLinkNode, uiTicks);
+				vTaskExitCritical(uiStatus);
+			}
+			else
+			{
+				// 软定时器，先获取信号量。以处理此时定时器任务此时同时在访问软定时器时间轮导致的冲突问题
+				uint32_t uiStatus;
+				
+				uiSemWait(&xTimerProtectSem, 0);
+				uiStatus = uiTaskEnterCritical();
+				pxTimer->eState = eTimerStarted;
+				
+				// 时间轮还没有推进积累的节拍，到期时间需要加上这些节拍
+				prvTimerSoftFold();
+				uiTicks = uiTicks ? uiTicks : 1;
+				uiTicks = (uiTicks + uiTimerSoftPending < uiTicks) ? 0xFFFFFFFF : uiTicks + uiTimerSoftPending;
+				vWheelAdd(&xTimerSoftWheel, &pxTimer->xLinkNode, uiTicks);
+				prvTimerSoftRearm();
+				vTaskExitCritical(uiStatus);
+				vSemNotify(&xTimerProtectSem);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimerStop
+** Descriptions         :   终止定时器
+** parameters           :   pxTimer 等待启动的定时器
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimerStop (Timer_t * pxTimer)
+{
+	switch(pxTimer->eState)
+	{
+		case eTimerStarted:
+		case eTimerRunning:
+			// 如果已经启动，判断定时器类型，然后从相应的时间轮中移除；正在执行回调的定时器不在时间轮中，
+			// 状态改为停止后回调返回时不再重新加入
+			if(pxTimer->uiConfig & TIMER_CONFIG_TYPE_HARD)
+			{
+				// 硬定时器，在时钟节拍中断中处理，所以使用critical来防护
+				uint32_t uiStatus = uiTaskEnterCritical();
+				vWheelRemove(&xTimerHardWheel, &pxTimer->xLinkNode);
+				pxTimer->eState = eTimerStopped;
+				vTaskExitCritical(uiStatus);
+			}
+			else
+			{
+				// 软定时器，先获取信号量。以处理此时定时器任务此时同时在访问软定时器时间轮导致的冲突问题
+				uint32_t uiStatus;
+				
+				uiSemWait(&xTimerProtectSem, 0);
+				uiStatus = uiTaskEnterCritical();
+				vWheelRemove(&xTimerSoftWheel, &pxTimer->xLinkNode);
+				pxTimer->eState = eTimerStopped;
+				prvTimerSoftFold();
+				prvTimerSoftRearm();
+				vTaskExitCritical(uiStatus);
+				vSemNotify(&xTimerProtectSem);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimerModuleTickNotify
+** Descriptions         :   通知定时模块，系统节拍tick增加
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimerModuleTickNotify (void)
+{
+	uint32_t uiStatus;
+	
+	// 处理硬定时器时间轮，只访问本节拍到期的定时器
+	prvTimerWheelTick(&xTimerHardWheel);
+	
+	// 软定时器只积累节拍，有定时器到期或需要下移时才唤醒定时器任务，定时器任务处理前不再重复唤醒
+	uiStatus = uiTaskEnterCritical();
+	uiTimerSoftPending++;
+	prvTimerSoftFold();
+	if(uiTimerSoftPending >= uiTimerSoftWake)
+	{
+		uiTimerSoftWake = TINYOS_TICKS_NONE;
+		vSemNotify(&xTimerTickSem);
+	}
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiTimerModuleNextExpireTicks
+** Descriptions         :   查询距离最早的定时器到期还有多少个节拍
+** parameters           :   无
+** Returned value       :   节拍数，没有启动的定时器时返回TINYOS_TICKS_NONE
+***********************************************************************************************************/
+uint32_t uiTimerModuleNextExpireTicks (void)
+{
+	uint32_t uiTicks, uiSoftTicks;
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	// 时间轮上层的槽下移时也需要处理节拍，返回值可能早于实际的到期时间
+	uiTicks = uiWheelNextTicks(&xTimerHardWheel);
+	if(uiTimerSoftWake == TINYOS_TICKS_NONE)
+		uiSoftTicks = TINYOS_TICKS_NONE;
+	else
+		uiSoftTicks = uiTimerSoftWake > uiTimerSoftPending ? uiTimerSoftWake - uiTimerSoftPending : 1;
+	if(uiSoftTicks < uiTicks)
+		uiTicks = uiSoftTicks;
+	
+	vTaskExitCritical(uiStatus);
+	return uiTicks;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimerModuleTickSkip
+** Descriptions         :   一次性推进多个节拍，调用者保证期间没有定时器到期
+** parameters           :   uiTicks 推进的节拍数
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimerModuleTickSkip (uint32_t uiTicks)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	
+	vWheelSkip(&xTimerHardWheel, uiTicks);
+	uiTimerSoftPending += uiTicks;
+	prvTimerSoftFold();
+	
+	vTaskExitCritical(uiStatus);
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimerModuleInit
+** Descriptions         :   定时器模块初始化
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimerModuleInit (void)
+{
+	vWheelInit(&xTimerHardWheel);
+	vWheelInit(&xTimerSoftWheel);
+	vSemInit(&xTimerProtectSem, 1, 1);
+	vSemInit(&xTimerTickSem, 0, 0);
+	uiTimerSoftPending = 0;
+	uiTimerSoftWake = TINYOS_TICKS_NONE;
+	cTimerSoftBusy = 0;
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimerInitTask
+** Descriptions         :   初始化软定时器任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimerInitTask(void)
+{
+#if TINYOS_TIMERTASK_PRIO >= (TINYOS_PRO_COUNT - 1)
+    #error "The proprity of timer task must be greater then (TINYOS_PRO_COUNT - 1)"
+#endif
+    vTaskInit(&xTimeTask, prvTimerSoftTask, (void *)0,
+        TINYOS_TIMERTASK_PRIO, xTimerTaskStack, sizeof(xTimerTaskStack));
+    STACK_PROFILE_ADD(&xTimeTask, "TINYOS_STACK_SIZE");
+}
+
+/**********************************************************************************************************
+** Function name        :   vTimerDestroy
+** Descriptions         :   销毁定时器
+** parameters           :   pxTimer 销毁的定时器
+** Returned value       :   无
+***********************************************************************************************************/
+void vTimerDestroy (Timer_t * pxTimer)
+{
+	vTimerStop(pxTimer);
+	pxTimer->eState = eTimerDestroyed;
+}
+
+/**********************************************************************************************************
+** Function name        :   tTimerGetInfo
+** Descriptions         :   查询状态信息
+** parameters           :   pxTimer 查询的定时器
+** parameters           :   pxInfo 状态查询存储的位置
+** Returned value       :   无
+***********************************************************************************************************/
+void tTimerGetInfo (Timer_t * pxTimer, TimerInfo_t * pxInfo)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	pxInfo->uiStartDelayTicks = pxTimer->uiStartDelayTicks;
+	pxInfo->uiDurationTicks   = pxTimer->uiDurationTicks;
+	pxInfo->pvTimerFunc       = pxTimer->pvTimerFunc;
+	pxInfo->pvArg             = pxTimer->pvArg;
+	pxInfo->uiConfig          = pxTimer->uiConfig;
+	pxInfo->eSstate           = pxTimer->eState;
+	vTaskExitCritical(uiStatus);
+}
+
+
+
+/**********************************************************************************************************
+** Function name        :   prvTimerSoftRearm
+** Descriptions         :   软定时器时间轮改变后重新设定唤醒定时器任务的节拍，需在临界区内调用
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTimerSoftRearm (void)
+{
+	uiTimerSoftWake = uiWheelNextTicks(&xTimerSoftWheel);
+	if(uiTimerSoftWake <= uiTimerSoftPending)
+	{
+		uiTimerSoftWake = TINYOS_TICKS_NONE;
+		vSemNotify(&xTimerTickSem);
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvTimerSoftFold
+** Descriptions         :   软定时器时间轮为空、并且定时器任务不在推进时间轮时，把积累的节拍直接并入时间轮并清零。
+**                          由节拍处理、启动与停止定时器调用，积累的节拍数只在有启动的软定时器或定时器任务正在处理时增长。
+**                          需在临界区内调用
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTimerSoftFold (void)
+{
+	if(!xTimerSoftWheel.uiCount && !cTimerSoftBusy)
+	{
+		vWheelSkip(&xTimerSoftWheel, uiTimerSoftPending);
+		uiTimerSoftPending = 0;
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvTimerSoftTask
+** Descriptions         :   处理软定时器时间轮的任务，只在有软定时器到期或需要下移时被唤醒
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTimerSoftTask(void * pvParam)
+{
+	uint32_t uiStatus, uiTicks, uiNext;
+	
+	for(;;)
+	{
+        // 等待节拍中断或启动、停止定时器时发送的信号
+        uiSemWait(&xTimerTickSem, 0);
+
+        // 获取软定时器时间轮的访问权限
+        uiSemWait(&xTimerProtectSem, 0);
+
+        for(;;)
+        {
+            // 取走积累的节拍，处理期间节拍中断只积累不唤醒；没有积累的节拍时重新设定唤醒的节拍
+            uiStatus = uiTaskEnterCritical();
+            uiTicks = uiTimerSoftPending;
+            uiTimerSoftPending = 0;
+            uiTimerSoftWake = uiTicks ? TINYOS_TICKS_NONE : uiWheelNextTicks(&xTimerSoftWheel);
+            cTimerSoftBusy = uiTicks ? 1 : 0;
+            vTaskExitCritical(uiStatus);
+            if(!uiTicks)
+                break;
+
+            // 一次处理落后的节拍，中间没有定时器到期的节拍直接跳过
+            while(uiTicks)
+            {
+                uiNext = uiWheelNextTicks(&xTimerSoftWheel);
+                if(uiNext > uiTicks)
+                {
+                    vWheelSkip(&xTimerSoftWheel, uiTicks);
+                    break;
+                }
+                vWheelSkip(&xTimerSoftWheel, uiNext - 1);
+                prvTimerWheelTick(&xTimerSoftWheel);
+                uiTicks -= uiNext;
+            }
+        }
+
+        // 释放定时器时间轮访问权限
+        vSemNotify(&xTimerProtectSem);
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   prvTimerWheelTick
+** Descriptions         :   推进定时器时间轮一个节拍，调用到期的定时器处理函数。每次临界区只移动一个结点，
+**                          回调在临界区外执行，关中断的时间与定时器的数量无关
+** parameters           :   pxWheel 硬定时器或软定时器时间轮
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvTimerWheelTick (Wheel_t * pxWheel)
+{
+	WheelNode_t * pxNode;
+	Timer_t * pxTimer;
+	uint32_t uiStatus, uiMore;
+	
+	do
+	{
+		uiStatus = uiTaskEnterCritical();
+		uiMore = uiWheelTickStep(pxWheel);
+		vTaskExitCritical(uiStatus);
+	}while(uiMore);
+	
+	for(;;)
+	{
+		uiStatus = uiTaskEnterCritical();
+		pxNode = pxWheelDue(pxWheel);
+		if(!pxNode)
+		{
+			vTaskExitCritical(uiStatus);
+			break;
+		}
+		
+		pxTimer = pxNodeParent(pxNode, Timer_t, xLinkNode);
+		vWheelRemove(pxWheel, pxNode);
+		pxTimer->eState = eTimerRunning;
+		TRACE_TIMER_FIRE(pxTimer, pxWheel == &xTimerHardWheel);
+		vTaskExitCritical(uiStatus);
+		
+		pxTimer->pvTimerFunc(pxTimer->pvArg);
+		
+		// 回调中没有停止定时器时，周期定时器重新加入时间轮，一次性定时器停止
+		uiStatus = uiTaskEnterCritical();
+		if(pxTimer->eState == eTimerRunning)
+		{
+			if(pxTimer->uiDurationTicks > 0)
+			{
+				vWheelAdd(pxWheel, pxNode, pxTimer->uiDurationTicks);
+				pxTimer->eState = eTimerStarted;
+			}
+			else
+			{
+				pxTimer->eState = eTimerStopped;
+			}
+		}
+		vTaskExitCritical(uiStatus);
+	}
+}
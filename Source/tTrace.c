@@ -0,0 +1,110 @@
+#include "tinyOS.h"
+
+#if TINYOS_ENABLE_TRACE
+
+#ifdef TINYOS_PORT_LINUX
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+/****************** 宏/变量定义 ****************************/
+
+// 导出时整体读取该结构，调试器中可用 dump binary memory trace.bin &g_xTrace (&g_xTrace + 1) 导出
+// 时间戳取自内核的64位单调时钟ullClockNow()，与节拍计数在同一时间轴上，虚拟时间仿真中即为仿真时间
+Trace_t g_xTrace;
+
+#ifdef TINYOS_PORT_LINUX
+static void prvTraceDumpAtExit (void);
+static void prvTraceSigInt (int iSignal);
+#endif
+
+/**********************************************************************************************************
+** Function name        :   vTraceInit
+** Descriptions         :   初始化跟踪缓冲区
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTraceInit (void)
+{
+	g_xTrace.xHeader.uiMagic = TINYOS_TRACE_MAGIC;
+	g_xTrace.xHeader.usVersion = TINYOS_TRACE_VERSION;
+	g_xTrace.xHeader.usEventSize = sizeof(TraceEvent_t);
+	g_xTrace.xHeader.uiCapacity = TINYOS_TRACE_BUFFER_SIZE;
+	g_xTrace.xHeader.uiWritten = 0;
+
+	g_xTrace.xHeader.uiFreqHz = TINYOS_TRACE_FREQ_HZ;
+
+#ifdef TINYOS_PORT_LINUX
+	// 设置了TINYOS_TRACE_FILE时，进程退出（包括Ctrl+C）时自动导出
+	if(getenv("TINYOS_TRACE_FILE"))
+	{
+		atexit(prvTraceDumpAtExit);
+		signal(SIGINT, prvTraceSigInt);
+	}
+#endif
+}
+
+/**********************************************************************************************************
+** Function name        :   vTraceRecord
+** Descriptions         :   向环形缓冲区写入一个事件，可在任务和中断中调用
+** parameters           :   ucType 事件类型
+** parameters           :   ucArg 事件参数
+** parameters           :   pvTask 相关的任务
+** parameters           :   uiObj 相关的对象
+** Returned value       :   无
+***********************************************************************************************************/
+void vTraceRecord (uint8_t ucType, uint8_t ucArg, const void * pvTask, uint32_t uiObj)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	TraceEvent_t * pxEvent = &g_xTrace.xEvents[g_xTrace.xHeader.uiWritten++ & (TINYOS_TRACE_BUFFER_SIZE - 1)];
+
+	pxEvent->ullTime = ullClockNow();
+	pxEvent->ucType = ucType;
+	pxEvent->ucArg = ucArg;
+	pxEvent->usReserved = 0;
+	pxEvent->uiTask = (uint32_t)(uintptr_t)pvTask;
+	pxEvent->uiObj = uiObj;
+	pxEvent->uiReserved = 0;
+
+	vTaskExitCritical(uiStatus);
+}
+
+#ifdef TINYOS_PORT_LINUX
+/**********************************************************************************************************
+** Function name        :   vTraceDump
+** Descriptions         :   将跟踪缓冲区写入文件，供Tools/tTraceConv转换
+** parameters           :   pcPath 文件路径
+** Returned value       :   无
+***********************************************************************************************************/
+void vTraceDump (const char * pcPath)
+{
+	uint32_t uiStatus = uiTaskEnterCritical();
+	FILE * pxFile = fopen(pcPath, "wb");
+
+	if(pxFile)
+	{
+		fwrite(&g_xTrace, sizeof(g_xTrace), 1, pxFile);
+		fclose(pxFile);
+	}
+	else
+	{
+		perror("tinyOS: trace dump");
+	}
+
+	vTaskExitCritical(uiStatus);
+}
+
+static void prvTraceDumpAtExit (void)
+{
+	vTraceDump(getenv("TINYOS_TRACE_FILE"));
+}
+
+static void prvTraceSigInt (int iSignal)
+{
+	(void)iSignal;
+	exit(130);
+}
+#endif
+
+#endif /* TINYOS_ENABLE_TRACE */
@@ -0,0 +1,121 @@
+#ifndef _TTRACE_H
+#define _TTRACE_H
+
+#include <stdint.h>
+#include "tConfig.h"
+
+// 调度事件跟踪：在内核的关键路径上记录带时间戳的二进制事件到环形缓冲区中，
+// 缓冲区(g_xTrace)可由调试器整体导出，或在主机移植下写入文件，再用Tools/tTraceConv转换为
+// Chrome/Perfetto可以打开的JSON时间线。TINYOS_ENABLE_TRACE为0时所有跟踪点均为空
+
+#define TINYOS_TRACE_MAGIC                     0x43525454               // "TTRC"
+#define TINYOS_TRACE_VERSION                   3
+#define TINYOS_TRACE_FREQ_HZ                   1000000000               // 时间戳为ullClockNow()的纳秒数
+
+typedef enum {
+	eTraceTaskCreate = 1,              // 创建任务，uiObj为优先级
+	eTraceTaskSwitch,                  // 切换到uiTask运行
+	eTraceTaskReady,                   // 任务进入就绪状态
+	eTraceTaskSuspend,                 // 任务被挂起
+	eTraceTaskDelay,                   // 任务延时，uiObj为延时节拍数
+	eTraceEventWait,                   // 任务在事件uiObj上等待，ucArg为事件类型
+	eTraceEventWake,                   // 任务从事件uiObj上被唤醒，ucArg为等待结果
+	eTraceTimerFire,                   // 定时器uiObj到期，ucArg为1表示硬定时器
+	eTraceIsrEnter,                    // 进入中断，ucArg为中断号
+	eTraceIsrExit,                     // 退出中断，ucArg为中断号
+}TraceEventType_e;
+
+// 中断号，仅用于区分时间线上的中断
+#define TINYOS_TRACE_IRQ_TICK                  0
+#define TINYOS_TRACE_IRQ_SOFT                  1
+
+// 每个事件24字节。时间戳为64位，低功耗空闲中长时间不记录事件也不会回绕。对象以地址的低32位标识
+typedef struct {
+	uint64_t ullTime;                  // 时间戳，单位见TraceHeader_t::uiFreqHz
+	uint8_t ucType;                    // TraceEventType_e
+	uint8_t ucArg;
+	uint16_t usReserved;
+	uint32_t uiTask;                   // 相关的任务
+	uint32_t uiObj;                    // 相关的事件、定时器或参数
+	uint32_t uiReserved;
+}TraceEvent_t;
+
+typedef struct {
+	uint32_t uiMagic;
+	uint16_t usVersion;
+	uint16_t usEventSize;              // sizeof(TraceEvent_t)
+	uint32_t uiFreqHz;                 // 时间戳的频率
+	uint32_t uiCapacity;               // 缓冲区能容纳的事件数量
+	uint32_t uiWritten;                // 已写入的事件总数，超过容量后最早的事件被覆盖
+	uint32_t uiReserved[3];
+}TraceHeader_t;
+
+// 导出格式即该结构在内存中的映像
+typedef struct {
+	TraceHeader_t xHeader;
+	TraceEvent_t xEvents[TINYOS_TRACE_BUFFER_SIZE];
+}Trace_t;
+
+#if TINYOS_ENABLE_TRACE
+
+extern Trace_t g_xTrace;
+
+/**********************************************************************************************************
+** Function name        :   vTraceInit
+** Descriptions         :   初始化跟踪缓冲区
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTraceInit (void);
+
+/**********************************************************************************************************
+** Function name        :   vTraceRecord
+** Descriptions         :   向环形缓冲区写入一个事件，可在任务和中断中调用
+** parameters           :   ucType 事件类型
+** parameters           :   ucArg 事件参数
+** parameters           :   pvTask 相关的任务
+** parameters           :   uiObj 相关的对象
+** Returned value       :   无
+***********************************************************************************************************/
+void vTraceRecord (uint8_t ucType, uint8_t ucArg, const void * pvTask, uint32_t uiObj);
+
+#ifdef TINYOS_PORT_LINUX
+/**********************************************************************************************************
+** Function name        :   vTraceDump
+** Descriptions         :   将跟踪缓冲区写入文件，供Tools/tTraceConv转换
+** parameters           :   pcPath 文件路径
+** Returned value       :   无
+***********************************************************************************************************/
+void vTraceDump (const char * pcPath);
+#endif
+
+#define TRACE_INIT()                          vTraceInit()
+#define TRACE_TASK_CREATE(pxTask)             vTraceRecord(eTraceTaskCreate, 0, (pxTask), (pxTask)->uiPrio)
+#define TRACE_TASK_SWITCH(pxTask)             vTraceRecord(eTraceTaskSwitch, 0, (pxTask), 0)
+#define TRACE_TASK_READY(pxTask)              vTraceRecord(eTraceTaskReady, 0, (pxTask), 0)
+#define TRACE_TASK_SUSPEND(pxTask)            vTraceRecord(eTraceTaskSuspend, 0, (pxTask), 0)
+#define TRACE_TASK_DELAY(pxTask, uiTicks)     vTraceRecord(eTraceTaskDelay, 0, (pxTask), (uiTicks))
+#define TRACE_EVENT_WAIT(pxTask, pxEvent)     vTraceRecord(eTraceEventWait, (uint8_t)(pxEvent)->eType, (pxTask), (uint32_t)(uintptr_t)(pxEvent))
+#define TRACE_EVENT_WAKE(pxTask, pxEvent, uiResult) \
+                                              vTraceRecord(eTraceEventWake, (uint8_t)(uiResult), (pxTask), (uint32_t)(uintptr_t)(pxEvent))
+#define TRACE_TIMER_FIRE(pxTimer, ucHard)     vTraceRecord(eTraceTimerFire, (ucHard), (void *)0, (uint32_t)(uintptr_t)(pxTimer))
+#define TRACE_ISR_ENTER(ucIrq)                vTraceRecord(eTraceIsrEnter, (ucIrq), (void *)0, 0)
+#define TRACE_ISR_EXIT(ucIrq)                 vTraceRecord(eTraceIsrExit, (ucIrq), (void *)0, 0)
+
+#else
+
+#define TRACE_INIT()
+#define TRACE_TASK_CREATE(pxTask)
+#define TRACE_TASK_SWITCH(pxTask)
+#define TRACE_TASK_READY(pxTask)
+#define TRACE_TASK_SUSPEND(pxTask)
+#define TRACE_TASK_DELAY(pxTask, uiTicks)
+#define TRACE_EVENT_WAIT(pxTask, pxEvent)
+#define TRACE_EVENT_WAKE(pxTask, pxEvent, uiResult)
+#define TRACE_TIMER_FIRE(pxTimer, ucHard)
+#define TRACE_ISR_ENTER(ucIrq)
+#define TRACE_ISR_EXIT(ucIrq)
+
+#endif /* TINYOS_ENABLE_TRACE */
+
+#endif /* _TTRACE_H */
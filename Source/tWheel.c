@@ -0,0 +1,247 @@
+#include "tinyOS.h"
+
+/**********************************************************************************************************
+** Function name        :   prvWheelPlace
+** Descriptions         :   按到期节拍与下一个要处理的节拍之差，把结点放入能容纳它的最低一层
+** parameters           :   pxWheel 时间轮
+** parameters           :   pxNode 结点，uiExpire已设置
+** Returned value       :   无
+***********************************************************************************************************/
+static void prvWheelPlace (Wheel_t * pxWheel, WheelNode_t * pxNode)
+{
+	uint32_t uiDelta = pxNode->uiExpire - pxWheel->uiNext;
+	uint32_t uiLevel = 0, uiSlot;
+
+	// 到期前已经过了uiDelta + 1个节拍，第k层容纳差值小于2^(TINYOS_WHEEL_BITS * (k + 1))的结点
+	while(uiLevel < TINYOS_WHEEL_LEVELS - 1 && ((uint64_t)uiDelta >> (TINYOS_WHEEL_BITS * (uiLevel + 1))) != 0)
+		uiLevel++;
+
+	uiSlot = (pxNode->uiExpire >> (TINYOS_WHEEL_BITS * uiLevel)) & TINYOS_WHEEL_MASK;
+	pxNode->pxSlot = &pxWheel->xSlot[uiLevel][uiSlot];
+	vListAddLast(pxNode->pxSlot, &pxNode->xNode);
+	pxWheel->uiOccupied[uiLevel] |= 1u << uiSlot;
+	pxWheel->uiCount++;
+}
+
+/**********************************************************************************************************
+** Function name        :   vWheelInit
+** Descriptions         :   初始化时间轮
+** parameters           :   pxWheel 时间轮
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelInit (Wheel_t * pxWheel)
+{
+	uint32_t i, j;
+
+	for(i = 0; i < TINYOS_WHEEL_LEVELS; i++)
+	{
+		for(j = 0; j < TINYOS_WHEEL_SLOTS; j++)
+		{
+			vListInit(&pxWheel->xSlot[i][j]);
+		}
+		pxWheel->uiOccupied[i] = 0;
+	}
+	vListInit(&pxWheel->xDue);
+	pxWheel->uiNext = 1;
+	pxWheel->uiCount = 0;
+	pxWheel->uiStepLevel = 1;
+}
+
+/**********************************************************************************************************
+** Function name        :   vWheelNodeInit
+** Descriptions         :   初始化时间轮结点
+** parameters           :   pxNode 结点
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelNodeInit (WheelNode_t * pxNode)
+{
+	vNodeInit(&pxNode->xNode);
+	pxNode->uiExpire = 0;
+	pxNode->pxSlot = (List_t *)0;
+}
+
+/**********************************************************************************************************
+** Function name        :   vWheelAdd
+** Descriptions         :   加入时间轮，在之后第uiTicks个节拍到期，uiTicks为0时按1处理
+** parameters           :   pxWheel 时间轮
+** parameters           :   pxNode 不在时间轮中的结点
+** parameters           :   uiTicks 节拍数
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelAdd (Wheel_t * pxWheel, WheelNode_t * pxNode, uint32_t uiTicks)
+{
+	// 最近处理过的节拍为uiNext - 1
+	pxNode->uiExpire = pxWheel->uiNext - 1 + (uiTicks ? uiTicks : 1);
+	prvWheelPlace(pxWheel, pxNode);
+}
+
+/**********************************************************************************************************
+** Function name        :   vWheelRemove
+** Descriptions         :   从时间轮或到期链表中移除
+** parameters           :   pxWheel 时间轮
+** parameters           :   pxNode 结点
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelRemove (Wheel_t * pxWheel, WheelNode_t * pxNode)
+{
+	List_t * pxSlot = pxNode->pxSlot;
+	uint32_t uiIndex;
+
+	if(!pxSlot)
+		return;
+
+	vListRemove(pxSlot, &pxNode->xNode);
+	pxNode->pxSlot = (List_t *)0;
+	if(pxSlot == &pxWheel->xDue)
+		return;
+
+	pxWheel->uiCount--;
+	if(!uiListCount(pxSlot))
+	{
+		uiIndex = (uint32_t)(pxSlot - &pxWheel->xSlot[0][0]);
+		pxWheel->uiOccupied[uiIndex / TINYOS_WHEEL_SLOTS] &= ~(1u << (uiIndex % TINYOS_WHEEL_SLOTS));
+	}
+}
+
+/**********************************************************************************************************
+** Function name        :   uiWheelTickStep
+** Descriptions         :   分步处理一个节拍，每次只移动一个结点：需要时逐层下移，再把第0层当前槽中的结点移到
+**                          到期链表。调用者可在两次调用之间打开中断，期间加入或移除结点都是安全的
+** parameters           :   pxWheel 时间轮
+** Returned value       :   1表示本节拍还有结点需要移动，0表示本节拍已处理完
+***********************************************************************************************************/
+uint32_t uiWheelTickStep (Wheel_t * pxWheel)
+{
+	uint32_t uiNow = pxWheel->uiNext;
+	uint32_t uiLevel, uiUpper;
+	List_t * pxSlot;
+	Node_t * pxNode;
+
+	// 第0层转完一圈，下移上一层对应的槽；该槽序号也为0时继续下移再上一层
+	while((uiNow & TINYOS_WHEEL_MASK) == 0 && pxWheel->uiStepLevel < TINYOS_WHEEL_LEVELS)
+	{
+		uiLevel = pxWheel->uiStepLevel;
+		uiUpper = (uiNow >> (TINYOS_WHEEL_BITS * uiLevel)) & TINYOS_WHEEL_MASK;
+		pxSlot = &pxWheel->xSlot[uiLevel][uiUpper];
+		if((pxNode = pxListRemoveFirst(pxSlot)) != (Node_t *)0)
+		{
+			if(!uiListCount(pxSlot))
+				pxWheel->uiOccupied[uiLevel] &= ~(1u << uiUpper);
+			pxWheel->uiCount--;
+			prvWheelPlace(pxWheel, (WheelNode_t *)pxNode);
+			return 1;
+		}
+		pxWheel->uiStepLevel = uiUpper ? TINYOS_WHEEL_LEVELS : uiLevel + 1;
+	}
+
+	pxSlot = &pxWheel->xSlot[0][uiNow & TINYOS_WHEEL_MASK];
+	if((pxNode = pxListRemoveFirst(pxSlot)) != (Node_t *)0)
+	{
+		if(!uiListCount(pxSlot))
+			pxWheel->uiOccupied[0] &= ~(1u << (uiNow & TINYOS_WHEEL_MASK));
+		pxWheel->uiCount--;
+		((WheelNode_t *)pxNode)->pxSlot = &pxWheel->xDue;
+		vListAddLast(&pxWheel->xDue, pxNode);
+		return 1;
+	}
+
+	pxWheel->uiStepLevel = 1;
+	pxWheel->uiNext = uiNow + 1;
+	return 0;
+}
+
+/**********************************************************************************************************
+** Function name        :   vWheelTick
+** Descriptions         :   处理一个节拍：需要时逐层下移，再把第0层当前槽中的结点移到到期链表
+** parameters           :   pxWheel 时间轮
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelTick (Wheel_t * pxWheel)
+{
+	while(uiWheelTickStep(pxWheel))
+		;
+}
+
+/**********************************************************************************************************
+** Function name        :   pxWheelDue
+** Descriptions         :   取到期链表中的第一个结点，调用者需用vWheelRemove将其移除或重新加入时间轮
+** parameters           :   pxWheel 时间轮
+** Returned value       :   结点，没有时返回0
+***********************************************************************************************************/
+WheelNode_t * pxWheelDue (Wheel_t * pxWheel)
+{
+	return (WheelNode_t *)pxListFirst(&pxWheel->xDue);
+}
+
+/**********************************************************************************************************
+** Function name        :   uiWheelNextTicks
+** Descriptions         :   距离下一个需要处理的节拍(有结点到期或需要下移)的节拍数，不会晚于最早的到期时间
+** parameters           :   pxWheel 时间轮
+** Returned value       :   节拍数，时间轮为空时返回TINYOS_TICKS_NONE
+***********************************************************************************************************/
+uint32_t uiWheelNextTicks (Wheel_t * pxWheel)
+{
+	uint64_t ullBest = TINYOS_TICKS_NONE, ullSpan, ullTick;
+	uint32_t uiLevel, i;
+
+	if(!pxWheel->uiCount)
+		return TINYOS_TICKS_NONE;
+
+	// 第0层的结点都在之后一圈内到期，第一个非空的槽就是其中最早的
+	for(i = 0; i < TINYOS_WHEEL_SLOTS && pxWheel->uiOccupied[0]; i++)
+	{
+		if(pxWheel->uiOccupied[0] & (1u << ((pxWheel->uiNext + i) & TINYOS_WHEEL_MASK)))
+		{
+			ullBest = i + 1;
+			break;
+		}
+	}
+
+	// 上层的结点最早在所在的槽下移时到期，下移发生在该层的槽边界上
+	for(uiLevel = 1; uiLevel < TINYOS_WHEEL_LEVELS; uiLevel++)
+	{
+		if(!pxWheel->uiOccupied[uiLevel])
+			continue;
+
+		ullSpan = 1ULL << (TINYOS_WHEEL_BITS * uiLevel);
+		ullTick = ((uint64_t)pxWheel->uiNext + ullSpan - 1) & ~(ullSpan - 1);
+		for(i = 0; i < TINYOS_WHEEL_SLOTS && ullTick - pxWheel->uiNext + 1 < ullBest; i++)
+		{
+			if(pxWheel->uiOccupied[uiLevel] & (1u << (((uint32_t)ullTick >> (TINYOS_WHEEL_BITS * uiLevel)) & TINYOS_WHEEL_MASK)))
+			{
+				ullBest = ullTick - pxWheel->uiNext + 1;
+				break;
+			}
+			ullTick += ullSpan;
+		}
+	}
+
+	return ullBest < TINYOS_TICKS_NONE ? (uint32_t)ullBest : TINYOS_TICKS_NONE - 1;
+}
+
+/**********************************************************************************************************
+** Function name        :   vWheelSkip
+** Descriptions         :   一次跳过多个节拍，uiTicks需小于uiWheelNextTicks的返回值
+** parameters           :   pxWheel 时间轮
+** parameters           :   uiTicks 节拍数
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelSkip (Wheel_t * pxWheel, uint32_t uiTicks)
+{
+	// 跳过的节拍上没有结点到期，经过的槽边界上需要下移的槽都是空的
+	pxWheel->uiNext += uiTicks;
+}
+
+/**********************************************************************************************************
+** Function name        :   uiWheelRemaining
+** Descriptions         :   结点还有多少个节拍到期
+** parameters           :   pxWheel 时间轮
+** parameters           :   pxNode 结点
+** Returned value       :   节拍数，不在时间轮中时返回0
+***********************************************************************************************************/
+uint32_t uiWheelRemaining (Wheel_t * pxWheel, WheelNode_t * pxNode)
+{
+	if(!pxNode->pxSlot || pxNode->pxSlot == &pxWheel->xDue)
+		return 0;
+	return pxNode->uiExpire - (pxWheel->uiNext - 1);
+}
@@ -0,0 +1,122 @@
+#ifndef _TWHEEL_H
+#define _TWHEEL_H
+
+#include <stdint.h>
+#include "tLib.h"
+
+// 分层时间轮：第k层的每个槽覆盖2^(TINYOS_WHEEL_BITS * k)个节拍。结点按到期节拍与当前节拍之差放入能容纳它的
+// 最低一层，插入与删除都是O(1)。每个节拍只处理第0层的一个槽；第0层转完一圈时，才把上一层对应的槽中的结点
+// 按剩余的节拍重新放入下层(逐层下移)，每个结点最多下移层数-1次。
+// 每层用一个位图记录非空的槽，查询最早的到期时间时不需要遍历结点。
+// 需要限制关中断时间时，用uiWheelTickStep分步处理节拍，每一步只移动一个结点
+
+#define TINYOS_WHEEL_SLOTS             (1u << TINYOS_WHEEL_BITS)
+#define TINYOS_WHEEL_MASK              (TINYOS_WHEEL_SLOTS - 1)
+#define TINYOS_WHEEL_LEVELS            ((32 + TINYOS_WHEEL_BITS - 1) / TINYOS_WHEEL_BITS)
+
+#if TINYOS_WHEEL_BITS < 1 || TINYOS_WHEEL_BITS > 5
+#error "TINYOS_WHEEL_BITS must be between 1 and 5"
+#endif
+
+typedef struct {
+	Node_t xNode;                      // 必须是第一个成员
+	uint32_t uiExpire;                 // 到期的节拍
+	List_t * pxSlot;                   // 所在的槽或到期链表，不在时间轮中时为0
+}WheelNode_t;
+
+typedef struct {
+	List_t xSlot[TINYOS_WHEEL_LEVELS][TINYOS_WHEEL_SLOTS];
+	uint32_t uiOccupied[TINYOS_WHEEL_LEVELS];    // 非空的槽的位图
+	List_t xDue;                       // 本节拍到期、还没有被取走的结点
+	uint32_t uiNext;                   // 下一个要处理的节拍
+	uint32_t uiCount;                  // 槽中的结点数，不包括到期链表
+	uint32_t uiStepLevel;              // 分步处理节拍时下一个要下移的层
+}Wheel_t;
+
+/**********************************************************************************************************
+** Function name        :   vWheelInit
+** Descriptions         :   初始化时间轮
+** parameters           :   pxWheel 时间轮
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelInit (Wheel_t * pxWheel);
+
+/**********************************************************************************************************
+** Function name        :   vWheelNodeInit
+** Descriptions         :   初始化时间轮结点
+** parameters           :   pxNode 结点
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelNodeInit (WheelNode_t * pxNode);
+
+/**********************************************************************************************************
+** Function name        :   vWheelAdd
+** Descriptions         :   加入时间轮，在之后第uiTicks个节拍到期，uiTicks为0时按1处理
+** parameters           :   pxWheel 时间轮
+** parameters           :   pxNode 不在时间轮中的结点
+** parameters           :   uiTicks 节拍数
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelAdd (Wheel_t * pxWheel, WheelNode_t * pxNode, uint32_t uiTicks);
+
+/**********************************************************************************************************
+** Function name        :   vWheelRemove
+** Descriptions         :   从时间轮或到期链表中移除
+** parameters           :   pxWheel 时间轮
+** parameters           :   pxNode 结点
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelRemove (Wheel_t * pxWheel, WheelNode_t * pxNode);
+
+/**********************************************************************************************************
+** Function name        :   uiWheelTickStep
+** Descriptions         :   分步处理一个节拍，每次只移动一个结点：需要时逐层下移，再把第0层当前槽中的结点移到
+**                          到期链表。调用者可在两次调用之间打开中断，期间加入或移除结点都是安全的
+** parameters           :   pxWheel 时间轮
+** Returned value       :   1表示本节拍还有结点需要移动，0表示本节拍已处理完
+***********************************************************************************************************/
+uint32_t uiWheelTickStep (Wheel_t * pxWheel);
+
+/**********************************************************************************************************
+** Function name        :   vWheelTick
+** Descriptions         :   处理一个节拍：需要时逐层下移，再把第0层当前槽中的结点移到到期链表
+** parameters           :   pxWheel 时间轮
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelTick (Wheel_t * pxWheel);
+
+/**********************************************************************************************************
+** Function name        :   pxWheelDue
+** Descriptions         :   取到期链表中的第一个结点，调用者需用vWheelRemove将其移除或重新加入时间轮
+** parameters           :   pxWheel 时间轮
+** Returned value       :   结点，没有时返回0
+***********************************************************************************************************/
+WheelNode_t * pxWheelDue (Wheel_t * pxWheel);
+
+/**********************************************************************************************************
+** Function name        :   uiWheelNextTicks
+** Descriptions         :   距离下一个需要处理的节拍(有结点到期或需要下移)的节拍数，不会晚于最早的到期时间
+** parameters           :   pxWheel 时间轮
+** Returned value       :   节拍数，时间轮为空时返回TINYOS_TICKS_NONE
+***********************************************************************************************************/
+uint32_t uiWheelNextTicks (Wheel_t * pxWheel);
+
+/**********************************************************************************************************
+** Function name        :   vWheelSkip
+** Descriptions         :   一次跳过多个节拍，uiTicks需小于uiWheelNextTicks的返回值
+** parameters           :   pxWheel 时间轮
+** parameters           :   uiTicks 节拍数
+** Returned value       :   无
+***********************************************************************************************************/
+void vWheelSkip (Wheel_t * pxWheel, uint32_t uiTicks);
+
+/**********************************************************************************************************
+** Function name        :   uiWheelRemaining
+** Descriptions         :   结点还有多少个节拍到期
+** parameters           :   pxWheel 时间轮
+** parameters           :   pxNode 结点
+** Returned value       :   节拍数，不在时间轮中时返回0
+***********************************************************************************************************/
+uint32_t uiWheelRemaining (Wheel_t * pxWheel, WheelNode_t * pxNode);
+
+#endif /* _TWHEEL_H */
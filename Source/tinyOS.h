@@ -1,145 +1,218 @@
-#ifndef _TINYOS_H_
-#define _TINYOS_H_
-
-// 标准头文件，里面包含了常用的类型定义，如uint32_t
-#include <stdint.h>
-
-// tinyOS的内核库文件
-#include "tLib.h"
-
-// TinyOS的配置文件
-#include "tConfig.h"
-
-// 事件控制头文件
-#include "tEvent.h"
-
-#include "ARMCM3.h"
-
-// 任务头文件
-#include "tTask.h"
-
-#include "tSem.h"
-
-#include "tMbox.h"
-
-#include "tMemBlock.h"
-
-#include "tFlagGroup.h"
-
-#include "tMutex.h"
-
-#include "tTimer.h"
-
-#define TICKS_PER_SEC                   (1000 / TINYOS_ONE_TICK_TO_MS)
-
-typedef enum {
-	eErrorNoError = 0,                  // 没有错误
-	eErrorTimeout,                      // 等待超时
-	eErrorResourceUnavaliable,          // 资源不足
-	eErrorDel,						    // 被删除
-	eErrorResourceFull,                 // 资源缓冲区不足
-	eErrorOwner,                        // 不是拥有者操作
-}Error_e;
-
-/**********************************************************************************************************
-** Function name        :   vHardwareInit
-** Descriptions         :   硬件初始化
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vHardwareInit(void);
-
-/**********************************************************************************************************
-** Function name        :   vSetSysTickPeriod
-** Descriptions         :   设置定时器中断触发的间隔
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vSetSysTickPeriod(uint32_t ms);
-
-/**********************************************************************************************************
-** Function name        :   vTaskSetCleanCallFunc
-** Descriptions         :   设置任务被删除时调用的清理函数
-** parameters           :   pxTask  待设置的任务
-** parameters           :   pvClean  清理函数入口地址
-** parameters           :   pvParam  传递给清理函数的参数
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskSetCleanCallFunc (Task_t * pxTask, void (*pvClean)(void *param), void * pvParam);
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskForceDelete
-** Descriptions         :   强制删除指定的任务
-** parameters           :   task  需要删除的任务
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskForceDelete(Task_t * pxTask);
-
-
-/**********************************************************************************************************
-** Function name        :   vTaskRequestDelete
-** Descriptions         :   请求删除某个任务，由任务自己决定是否删除自己
-** parameters           :   pxTask  需要删除的任务
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskRequestDelete(Task_t * pxTask);
-
-/**********************************************************************************************************
-** Function name        :   cTaskIsRequestedDelete
-** Descriptions         :   是否已经被请求删除自己
-** parameters           :   无
-** Returned value       :   非0表示请求删除，0表示无请求
-***********************************************************************************************************/
-uint8_t cTaskIsRequestedDelete (void);
-
-/**********************************************************************************************************
-** Function name        :   vTaskDeleteSelf
-** Descriptions         :   删除当前任务
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskDeleteSelf (void);
-
-/**********************************************************************************************************
-** Function name        :   vTaskGetInfo
-** Descriptions         :   获取任务相关信息
-** parameters           :   task 需要查询的任务
-** parameters           :   info 任务信息存储结构
-** Returned value       :   无
-***********************************************************************************************************/
-void vTaskGetInfo (Task_t * pxTask, TaskInfo_t * pxInfo);
-
-/**********************************************************************************************************
-** Function name        :   vInitCpuUsageStat
-** Descriptions         :   初始化cpu统计
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vInitCpuUsageStat(void);
-
-/**********************************************************************************************************
-** Function name        :   vIdleTaskInit
-** Descriptions         :   初始化空闲任务
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vIdleTaskInit(void);
-
-/**********************************************************************************************************
-** Function name        :   fGetCpuUsage
-** Descriptions         :   获取CPU利用率
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-float fGetCpuUsage(void);
-
-/**********************************************************************************************************
-** Function name        :   APP任务初始化
-** Descriptions         :   
-** parameters           :   无
-** Returned value       :   无
-***********************************************************************************************************/
-void vAppInit(void);
-#endif /* _TINYOS_H_ */
-
+#ifndef _TINYOS_H_
+#define _TINYOS_H_
+
+// 标准头文件，里面包含了常用的类型定义，如uint32_t
+#include <stdint.h>
+
+// tinyOS的内核库文件
+#include "tLib.h"
+
+// TinyOS的配置文件
+#include "tConfig.h"
+
+// 事件控制头文件
+#include "tEvent.h"
+
+// 移植层头文件：在主机上编译时定义TINYOS_PORT_LINUX
+#ifdef TINYOS_PORT_LINUX
+#include "tPortLinux.h"
+#else
+#include "ARMCM3.h"
+#endif
+
+// SMP需要移植层提供核的序号、核间中断与带自旋锁的临界区，目前只有主机移植层实现
+#if TINYOS_ENABLE_SMP && !defined(TINYOS_PORT_LINUX)
+#error "TINYOS_ENABLE_SMP is only implemented by the Linux host port"
+#endif
+
+// 任务头文件
+#include "tTask.h"
+
+// 临界区时长测量，需在tTask.h之后包含
+#include "tCritical.h"
+
+// EDF调度类
+#include "tEdf.h"
+#include "tBudget.h"
+#include "tAdmission.h"
+
+#include "tSem.h"
+
+#include "tMBox.h"
+
+#include "tMemBlock.h"
+
+#include "tFlagGroup.h"
+
+#include "tMutex.h"
+
+#include "tTImer.h"
+
+#include "tClock.h"
+
+#include "tTrace.h"
+
+#include "tStackProfile.h"
+
+#include "tPower.h"
+
+#define TICKS_PER_SEC                   (1000 / TINYOS_ONE_TICK_TO_MS)
+
+typedef enum {
+	eErrorNoError = 0,                  // 没有错误
+	eErrorTimeout,                      // 等待超时
+	eErrorResourceUnavaliable,          // 资源不足
+	eErrorDel,						    // 被删除
+	eErrorResourceFull,                 // 资源缓冲区不足
+	eErrorOwner,                        // 不是拥有者操作
+	eErrorUnschedulable,                // 任务集不可调度
+}Error_e;
+
+/**********************************************************************************************************
+** Function name        :   vHardwareInit
+** Descriptions         :   硬件初始化
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vHardwareInit(void);
+
+/**********************************************************************************************************
+** Function name        :   vSetSysTickPeriod
+** Descriptions         :   设置定时器中断触发的间隔
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vSetSysTickPeriod(uint32_t ms);
+
+/**********************************************************************************************************
+** Function name        :   vPortTimestampInit
+** Descriptions         :   启动高精度时间戳计数器，供跟踪与临界区测量使用
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortTimestampInit(void);
+
+/**********************************************************************************************************
+** Function name        :   uiPortTimestamp
+** Descriptions         :   读取高精度时间戳，32位回绕由使用者处理
+** parameters           :   无
+** Returned value       :   时间戳
+***********************************************************************************************************/
+uint32_t uiPortTimestamp(void);
+
+/**********************************************************************************************************
+** Function name        :   uiPortTimestampFreq
+** Descriptions         :   高精度时间戳的计数频率
+** parameters           :   无
+** Returned value       :   频率(Hz)
+***********************************************************************************************************/
+uint32_t uiPortTimestampFreq(void);
+
+#if TINYOS_ENABLE_TICKLESS
+/**********************************************************************************************************
+** Function name        :   uiPortTicklessSleep
+** Descriptions         :   由移植层实现，在临界区内由空闲任务调用：停止周期节拍，设置uiTicks个节拍后的一次性唤醒并休眠。
+**                          定时到期时节拍中断保持挂起，退出临界区后照常处理最后一个节拍；被其它中断提前唤醒时
+**                          不产生节拍中断。返回前恢复与原节拍边界对齐的周期节拍
+** parameters           :   uiTicks 到下一个有工作到期的节拍为止的节拍数，不小于TINYOS_TICKLESS_MIN_TICKS
+** Returned value       :   休眠期间经过、需要由内核一次补偿的节拍数，不包括挂起的最后一个节拍，小于uiTicks
+***********************************************************************************************************/
+uint32_t uiPortTicklessSleep(uint32_t uiTicks);
+#endif
+
+#if TINYOS_ENABLE_SMP
+/**********************************************************************************************************
+** Function name        :   vPortCoreIdle
+** Descriptions         :   由移植层实现，本核进入低功耗等待，直到有中断发生
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vPortCoreIdle(void);
+#endif
+
+/**********************************************************************************************************
+** Function name        :   vTaskSetCleanCallFunc
+** Descriptions         :   设置任务被删除时调用的清理函数
+** parameters           :   pxTask  待设置的任务
+** parameters           :   pvClean  清理函数入口地址
+** parameters           :   pvParam  传递给清理函数的参数
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskSetCleanCallFunc (Task_t * pxTask, void (*pvClean)(void *param), void * pvParam);
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskForceDelete
+** Descriptions         :   强制删除指定的任务
+** parameters           :   task  需要删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskForceDelete(Task_t * pxTask);
+
+
+/**********************************************************************************************************
+** Function name        :   vTaskRequestDelete
+** Descriptions         :   请求删除某个任务，由任务自己决定是否删除自己
+** parameters           :   pxTask  需要删除的任务
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskRequestDelete(Task_t * pxTask);
+
+/**********************************************************************************************************
+** Function name        :   cTaskIsRequestedDelete
+** Descriptions         :   是否已经被请求删除自己
+** parameters           :   无
+** Returned value       :   非0表示请求删除，0表示无请求
+***********************************************************************************************************/
+uint8_t cTaskIsRequestedDelete (void);
+
+/**********************************************************************************************************
+** Function name        :   vTaskDeleteSelf
+** Descriptions         :   删除当前任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskDeleteSelf (void);
+
+/**********************************************************************************************************
+** Function name        :   vTaskGetInfo
+** Descriptions         :   获取任务相关信息
+** parameters           :   task 需要查询的任务
+** parameters           :   info 任务信息存储结构
+** Returned value       :   无
+***********************************************************************************************************/
+void vTaskGetInfo (Task_t * pxTask, TaskInfo_t * pxInfo);
+
+/**********************************************************************************************************
+** Function name        :   vInitCpuUsageStat
+** Descriptions         :   初始化cpu统计
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vInitCpuUsageStat(void);
+
+/**********************************************************************************************************
+** Function name        :   vIdleTaskInit
+** Descriptions         :   初始化空闲任务
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vIdleTaskInit(void);
+
+/**********************************************************************************************************
+** Function name        :   fGetCpuUsage
+** Descriptions         :   获取CPU利用率
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+float fGetCpuUsage(void);
+
+/**********************************************************************************************************
+** Function name        :   APP任务初始化
+** Descriptions         :   
+** parameters           :   无
+** Returned value       :   无
+***********************************************************************************************************/
+void vAppInit(void);
+#endif /* _TINYOS_H_ */
+
@@ -0,0 +1,223 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tTrace.h"
+
+/****************** 宏/变量定义 ****************************/
+
+// 主机工具：将g_xTrace的导出文件转换为Chrome Trace Event格式的JSON，
+// 可直接在chrome://tracing或ui.perfetto.dev中打开
+//   tinyos-trace2json trace.bin [trace.json]
+
+#define CONV_TASK_MAX             256
+#define CONV_TID_IRQ              1                      // 中断在时间线上的轨道
+#define CONV_TID_TIMER            2                      // 定时器到期事件的轨道
+#define CONV_TID_TASK_BASE        10                     // 任务轨道的起始编号
+
+typedef struct {
+	uint32_t uiId;                                       // 任务地址的低32位
+	int iPrio;                                           // 创建事件之前就已存在的任务优先级未知
+}ConvTask_t;
+
+static ConvTask_t xConvTask[CONV_TASK_MAX];
+static uint32_t uiConvTaskCnt;
+
+static FILE * pxOut;
+static int iFirstRecord = 1;
+
+static const char * pcEventTypeName[] = {"unknown", "sem", "mbox", "memblock", "flaggroup", "mutex"};
+static const char * pcResultName[] = {"ok", "timeout", "unavailable", "deleted", "full", "owner"};
+
+/**********************************************************************************************************
+** Function name        :   prvConvTid
+** Descriptions         :   查找任务对应的轨道编号，第一次出现时分配
+** parameters           :   uiId 任务标识
+** Returned value       :   轨道编号
+***********************************************************************************************************/
+static uint32_t prvConvTid (uint32_t uiId)
+{
+	uint32_t i;
+
+	for(i = 0; i < uiConvTaskCnt; i++)
+	{
+		if(xConvTask[i].uiId == uiId)
+			return CONV_TID_TASK_BASE + i;
+	}
+
+	if(uiConvTaskCnt == CONV_TASK_MAX)
+	{
+		fprintf(stderr, "trace2json: more than %d tasks\n", CONV_TASK_MAX);
+		exit(1);
+	}
+	xConvTask[uiConvTaskCnt].uiId = uiId;
+	xConvTask[uiConvTaskCnt].iPrio = -1;
+	return CONV_TID_TASK_BASE + uiConvTaskCnt++;
+}
+
+// 输出一条JSON记录的公共部分，调用者负责补充其余字段与结尾的'}'
+static void prvConvRecord (const char * pcPhase, uint32_t uiTid, double dTs, const char * pcName)
+{
+	fprintf(pxOut, "%s\n{\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"name\":\"%s\"",
+		iFirstRecord ? "" : ",", pcPhase, uiTid, dTs, pcName);
+	iFirstRecord = 0;
+}
+
+static void prvConvInstant (uint32_t uiTid, double dTs, const char * pcName, uint32_t uiObj)
+{
+	prvConvRecord("i", uiTid, dTs, pcName);
+	fprintf(pxOut, ",\"s\":\"t\",\"args\":{\"obj\":\"0x%08x\"}}", uiObj);
+}
+
+static void prvConvThreadName (uint32_t uiTid, const char * pcName, int iSortIndex)
+{
+	prvConvRecord("M", uiTid, 0, "thread_name");
+	fprintf(pxOut, ",\"args\":{\"name\":\"%s\"}}", pcName);
+	prvConvRecord("M", uiTid, 0, "thread_sort_index");
+	fprintf(pxOut, ",\"args\":{\"sort_index\":%d}}", iSortIndex);
+}
+
+int main (int argc, char * argv[])
+{
+	TraceHeader_t xHeader;
+	TraceEvent_t * pxEvents;
+	FILE * pxIn;
+	uint32_t uiCount, uiStart, i;
+	uint64_t ullFirst = 0;
+	uint32_t uiRunningTid = 0;
+	double dTs = 0;
+	char cName[64];
+
+	if(argc < 2)
+	{
+		fprintf(stderr, "usage: %s trace.bin [trace.json]\n", argv[0]);
+		return 2;
+	}
+
+	pxIn = fopen(argv[1], "rb");
+	if(!pxIn || fread(&xHeader, sizeof(xHeader), 1, pxIn) != 1)
+	{
+		fprintf(stderr, "trace2json: cannot read %s\n", argv[1]);
+		return 1;
+	}
+	if(xHeader.uiMagic != TINYOS_TRACE_MAGIC || xHeader.usVersion != TINYOS_TRACE_VERSION
+		|| xHeader.usEventSize != sizeof(TraceEvent_t) || xHeader.uiFreqHz == 0)
+	{
+		fprintf(stderr, "trace2json: %s is not a version %d tinyOS trace\n", argv[1], TINYOS_TRACE_VERSION);
+		return 1;
+	}
+
+	pxEvents = malloc((size_t)xHeader.uiCapacity * sizeof(TraceEvent_t));
+	if(!pxEvents || fread(pxEvents, sizeof(TraceEvent_t), xHeader.uiCapacity, pxIn) != xHeader.uiCapacity)
+	{
+		fprintf(stderr, "trace2json: truncated trace %s\n", argv[1]);
+		return 1;
+	}
+	fclose(pxIn);
+
+	pxOut = argc > 2 ? fopen(argv[2], "w") : stdout;
+	if(!pxOut)
+	{
+		perror(argv[2]);
+		return 1;
+	}
+
+	// 缓冲区写满后，最早的事件位于下一个写入位置
+	uiCount = xHeader.uiWritten < xHeader.uiCapacity ? xHeader.uiWritten : xHeader.uiCapacity;
+	uiStart = xHeader.uiWritten < xHeader.uiCapacity ? 0 : xHeader.uiWritten % xHeader.uiCapacity;
+
+	fprintf(pxOut, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	prvConvRecord("M", 0, 0, "process_name");
+	fprintf(pxOut, ",\"args\":{\"name\":\"tinyOS\"}}");
+	prvConvThreadName(CONV_TID_IRQ, "interrupts", -2);
+	prvConvThreadName(CONV_TID_TIMER, "timers", -1);
+
+	for(i = 0; i < uiCount; i++)
+	{
+		TraceEvent_t * pxEvent = &pxEvents[(uiStart + i) % xHeader.uiCapacity];
+		uint32_t uiTid = pxEvent->uiTask ? prvConvTid(pxEvent->uiTask) : 0;
+		uint64_t ullTime = pxEvent->ullTime;
+
+		if(i == 0)
+			ullFirst = ullTime;
+		dTs = (double)(ullTime - ullFirst) * 1e6 / xHeader.uiFreqHz;
+
+		switch(pxEvent->ucType)
+		{
+			case eTraceTaskCreate:
+				xConvTask[uiTid - CONV_TID_TASK_BASE].iPrio = (int)pxEvent->uiObj;
+				prvConvInstant(uiTid, dTs, "create", pxEvent->uiTask);
+				break;
+			case eTraceTaskSwitch:
+				if(uiRunningTid == uiTid)
+					break;
+				if(uiRunningTid)
+				{
+					prvConvRecord("E", uiRunningTid, dTs, "running");
+					fprintf(pxOut, "}");
+				}
+				prvConvRecord("B", uiTid, dTs, "running");
+				fprintf(pxOut, "}");
+				uiRunningTid = uiTid;
+				break;
+			case eTraceTaskReady:
+				prvConvInstant(uiTid, dTs, "ready", pxEvent->uiTask);
+				break;
+			case eTraceTaskSuspend:
+				prvConvInstant(uiTid, dTs, "suspend", pxEvent->uiTask);
+				break;
+			case eTraceTaskDelay:
+				snprintf(cName, sizeof(cName), "delay %u", pxEvent->uiObj);
+				prvConvInstant(uiTid, dTs, cName, pxEvent->uiObj);
+				break;
+			case eTraceEventWait:
+				snprintf(cName, sizeof(cName), "wait %s",
+					pxEvent->ucArg < sizeof(pcEventTypeName) / sizeof(pcEventTypeName[0]) ? pcEventTypeName[pxEvent->ucArg] : "?");
+				prvConvInstant(uiTid, dTs, cName, pxEvent->uiObj);
+				break;
+			case eTraceEventWake:
+				snprintf(cName, sizeof(cName), "wake %s",
+					pxEvent->ucArg < sizeof(pcResultName) / sizeof(pcResultName[0]) ? pcResultName[pxEvent->ucArg] : "?");
+				prvConvInstant(uiTid, dTs, cName, pxEvent->uiObj);
+				break;
+			case eTraceTimerFire:
+				prvConvInstant(CONV_TID_TIMER, dTs, pxEvent->ucArg ? "hard timer" : "soft timer", pxEvent->uiObj);
+				break;
+			case eTraceIsrEnter:
+			case eTraceIsrExit:
+				prvConvRecord(pxEvent->ucType == eTraceIsrEnter ? "B" : "E", CONV_TID_IRQ, dTs,
+					pxEvent->ucArg == TINYOS_TRACE_IRQ_TICK ? "tick" : "soft irq");
+				fprintf(pxOut, "}");
+				break;
+			default:
+				fprintf(stderr, "trace2json: unknown event type %u\n", pxEvent->ucType);
+				break;
+		}
+	}
+
+	// 结束仍在运行的任务的时间片
+	if(uiRunningTid)
+	{
+		prvConvRecord("E", uiRunningTid, dTs, "running");
+		fprintf(pxOut, "}");
+	}
+
+	for(i = 0; i < uiConvTaskCnt; i++)
+	{
+		if(xConvTask[i].iPrio >= 0)
+			snprintf(cName, sizeof(cName), "task 0x%08x prio %d", xConvTask[i].uiId, xConvTask[i].iPrio);
+		else
+			snprintf(cName, sizeof(cName), "task 0x%08x", xConvTask[i].uiId);
+		prvConvThreadName(CONV_TID_TASK_BASE + i, cName, xConvTask[i].iPrio >= 0 ? xConvTask[i].iPrio : 999);
+	}
+
+	fprintf(pxOut, "\n]}\n");
+	if(pxOut != stdout)
+		fclose(pxOut);
+
+	fprintf(stderr, "trace2json: %u events (%u dropped), %u tasks, %.3f ms\n", uiCount,
+		xHeader.uiWritten - uiCount, uiConvTaskCnt, dTs / 1000.0);
+	free(pxEvents);
+	return 0;
+}